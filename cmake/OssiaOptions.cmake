@@ -13,6 +13,8 @@ option(OSSIA_DATAFLOW "Dataflow features" ON)
 option(OSSIA_EDITOR "Editor features" ON)
 option(OSSIA_GFX "Graphics features" ON)
 option(OSSIA_HIDE_ALL_SYMBOLS "Hide all symbols from the ossia lib" OFF)
+option(OSSIA_RT_AUDIT "Report the allocations and locks in the audio tick" OFF)
+option(OSSIA_AUDIO_FLOAT "Process the audio of the dataflow in single precision" OFF)
 
 # Bindings :
 option(OSSIA_JAVA "Build JNI bindings" OFF)
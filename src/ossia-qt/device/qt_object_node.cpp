@@ -116,6 +116,7 @@ void qt_object_node::childEvent(QChildEvent* event)
     {
       m_device.on_node_removing(**it);
       m_children.erase(it);
+      m_device.on_node_removed(*this);
     }
   }
 }
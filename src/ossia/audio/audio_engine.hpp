@@ -1,8 +1,10 @@
 #pragma once
 #include <ossia/audio/audio_parameter.hpp>
 #include <ossia/audio/audio_tick.hpp>
+#include <ossia/audio/tick_statistics.hpp>
 
 #include <ossia/detail/lockfree_queue.hpp>
+#include <ossia/detail/rt_audit.hpp>
 #include <smallfun.hpp>
 
 #include <ossia-config.hpp>
@@ -45,8 +47,13 @@ public:
   int effective_inputs{};
   int effective_outputs{};
 
+  //! Durations of the callbacks, relative to their deadline
+  ossia::tick_statistics statistics;
+
   void tick_start()
   {
+    statistics.begin();
+    rt_audit::enter();
     processing = true;
     load_audio_tick();
   }
@@ -54,10 +61,15 @@ public:
   {
     processing = false;
     ack_stop = req_stop.load();
+    rt_audit::leave();
+    statistics.cancel();
   }
-  void tick_end()
+  //! frames: rendered by the callback, at effective_sample_rate
+  void tick_end(uint64_t frames)
   {
     processing = false;
+    rt_audit::leave();
+    statistics.end(frames, effective_sample_rate);
   }
 };
 
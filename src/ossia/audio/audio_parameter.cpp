@@ -30,12 +30,13 @@ void audio_parameter::clone_value(audio_vector& res_vec) const
       res.resize(N);
 
     for (std::size_t i = 0; i < N; i++)
-      res[i] += double(src[i]);
+      res[i] += audio_processing_sample(src[i]);
   }
 }
 
 void audio_parameter::push_value(const audio_port& port)
 {
+  const auto gain = audio_processing_sample(m_gain);
   auto min_chan = std::min(port.samples.size(), (std::size_t)audio.size());
   for (std::size_t chan = 0; chan < min_chan; chan++)
   {
@@ -44,7 +45,7 @@ void audio_parameter::push_value(const audio_port& port)
     const auto N = std::min(src.size(), (std::size_t)dst.size());
     for (std::size_t i = 0; i < N; i++)
     {
-      dst[i] += float(src[i] * m_gain);
+      dst[i] += float(src[i] * gain);
     }
   }
 }
@@ -6,7 +6,6 @@ namespace ossia
 {
 class dummy_engine final : public audio_engine
 {
-  int effective_sample_rate{}, effective_buffer_size{};
   std::atomic_bool m_active;
 
 public:
@@ -84,7 +83,7 @@ public:
         audio_tick(ts);
 
         start = clk::now();
-        tick_end();
+        tick_end(samples);
       }
     }};
 #if defined(__linux__)
@@ -301,7 +301,7 @@ private:
     };
     self.audio_tick(ts);
 
-    self.tick_end();
+    self.tick_end(nframes);
     return 0;
   }
 
@@ -0,0 +1,240 @@
+#include <ossia/audio/offline_engine.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+#include <ossia/detail/logger.hpp>
+#include <ossia/editor/state/state_element.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace ossia
+{
+namespace
+{
+using boost::endian::endian_store;
+using boost::endian::order;
+
+// Writes the frames given to it in a 32-bit float WAV file
+class wav_writer
+{
+public:
+  static constexpr std::size_t header_size = 58;
+
+  bool open(const std::string& path, int channels, int rate)
+  {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+      return false;
+
+    m_channels = channels;
+    m_rate = rate;
+    write_header();
+    return bool(m_file);
+  }
+
+  void write(float* const* channels, uint64_t frames)
+  {
+    const std::size_t bytes = frames * m_channels * sizeof(float);
+    if (m_data_bytes + bytes > std::numeric_limits<uint32_t>::max() - header_size)
+    {
+      if (!m_full)
+        ossia::logger().error("offline_engine: the WAV file is full");
+      m_full = true;
+      return;
+    }
+
+    m_buffer.resize(bytes);
+    unsigned char* out = m_buffer.data();
+    for (uint64_t i = 0; i < frames; i++)
+    {
+      for (int c = 0; c < m_channels; c++)
+      {
+        endian_store<float, 4, order::little>(out, channels[c][i]);
+        out += sizeof(float);
+      }
+    }
+
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), bytes);
+    m_data_bytes += bytes;
+  }
+
+  //! Writes the sizes, known once all the frames are written
+  bool close()
+  {
+    m_file.seekp(0);
+    write_header();
+    m_file.close();
+    return !m_file.fail();
+  }
+
+private:
+  void write_header()
+  {
+    const uint16_t block_align = m_channels * sizeof(float);
+    unsigned char h[header_size];
+    auto str = [&h](std::size_t pos, const char* s) { std::copy_n(s, 4, h + pos); };
+    auto u16 = [&h](std::size_t pos, uint16_t v) {
+      endian_store<uint16_t, 2, order::little>(h + pos, v);
+    };
+    auto u32 = [&h](std::size_t pos, uint32_t v) {
+      endian_store<uint32_t, 4, order::little>(h + pos, v);
+    };
+
+    str(0, "RIFF");
+    u32(4, uint32_t(header_size - 8 + m_data_bytes));
+    str(8, "WAVE");
+
+    str(12, "fmt ");
+    u32(16, 18);
+    u16(20, 3); // WAVE_FORMAT_IEEE_FLOAT
+    u16(22, m_channels);
+    u32(24, m_rate);
+    u32(28, m_rate * block_align);
+    u16(32, block_align);
+    u16(34, 32);
+    u16(36, 0);
+
+    // Required for the formats other than PCM
+    str(38, "fact");
+    u32(42, 4);
+    u32(46, block_align ? uint32_t(m_data_bytes / block_align) : 0);
+
+    str(50, "data");
+    u32(54, uint32_t(m_data_bytes));
+
+    m_file.write(reinterpret_cast<const char*>(h), header_size);
+  }
+
+  std::ofstream m_file;
+  std::vector<unsigned char> m_buffer;
+  uint64_t m_data_bytes{};
+  int m_channels{};
+  int m_rate{};
+  bool m_full{};
+};
+}
+
+offline_engine::offline_engine(int rate, int bs, int inputs, int outputs)
+{
+  effective_sample_rate = rate;
+  effective_buffer_size = bs;
+  effective_inputs = inputs;
+  effective_outputs = outputs;
+
+  m_inputs.resize(inputs);
+  for (auto& chan : m_inputs)
+  {
+    chan.resize(bs);
+    m_input_ptrs.push_back(chan.data());
+  }
+  m_outputs.resize(outputs);
+  for (auto& chan : m_outputs)
+  {
+    chan.resize(bs);
+    m_output_ptrs.push_back(chan.data());
+  }
+}
+
+offline_engine::~offline_engine() = default;
+
+bool offline_engine::running() const
+{
+  return m_rendering;
+}
+
+offline_render_report
+offline_engine::render(const offline_render_settings& settings)
+{
+  using clk = std::chrono::steady_clock;
+  const int rate = effective_sample_rate;
+  const uint64_t bs = effective_buffer_size;
+
+  offline_render_report report;
+  if (bs == 0)
+    return report;
+
+  wav_writer wav;
+  if (!settings.output_file.empty()
+      && !wav.open(settings.output_file, effective_outputs, rate))
+  {
+    ossia::logger().error(
+        "offline_engine: cannot write {}", settings.output_file);
+    return report;
+  }
+
+  // Date of the tick being rendered
+  double seconds = 0.;
+  std::ofstream log;
+  const bool logs_commits
+      = settings.state && !settings.commit_log_file.empty();
+  if (logs_commits)
+  {
+    log.open(settings.commit_log_file, std::ios::trunc);
+    if (!log)
+    {
+      ossia::logger().error(
+          "offline_engine: cannot write {}", settings.commit_log_file);
+      return report;
+    }
+    log << std::fixed << std::setprecision(6);
+
+    settings.state->commit_observer
+        = [&log, &seconds](const ossia::state_element& e) {
+            log << seconds << '\t';
+            ossia::print(log, e);
+          };
+  }
+
+  m_rendering = true;
+  const auto start = clk::now();
+  while (report.frames < settings.frames)
+  {
+    const uint64_t frames = std::min(bs, settings.frames - report.frames);
+    seconds = double(report.frames) / rate;
+
+    tick_start();
+    if (stop_processing)
+    {
+      tick_clear();
+      break;
+    }
+
+    for (auto& chan : m_outputs)
+      std::fill_n(chan.data(), frames, 0.f);
+
+    ossia::audio_tick_state ts{
+        m_input_ptrs.data(), m_output_ptrs.data(),
+        effective_inputs,    effective_outputs,
+        frames,              seconds,
+        report.frames,       ossia::transport_status::playing};
+    audio_tick(ts);
+    tick_end(frames);
+
+    if (!settings.output_file.empty())
+      wav.write(m_output_ptrs.data(), frames);
+
+    report.frames += frames;
+    report.ticks++;
+  }
+  const auto end = clk::now();
+  m_rendering = false;
+
+  if (logs_commits)
+    settings.state->commit_observer = {};
+
+  if (!settings.output_file.empty() && !wav.close())
+    ossia::logger().error(
+        "offline_engine: cannot write {}", settings.output_file);
+
+  report.rendered_seconds = double(report.frames) / rate;
+  report.elapsed_seconds
+      = std::chrono::duration<double>(end - start).count();
+  if (report.elapsed_seconds > 0.)
+    report.realtime_factor = report.rendered_seconds / report.elapsed_seconds;
+  return report;
+}
+}
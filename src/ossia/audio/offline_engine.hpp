@@ -0,0 +1,70 @@
+#pragma once
+#include <ossia/audio/audio_engine.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ossia
+{
+struct execution_state;
+
+//! What an offline_engine renders, and where to
+struct offline_render_settings
+{
+  //! Frames to render
+  uint64_t frames{};
+
+  //! WAV file (32-bit float) receiving the outputs. Not written if empty.
+  std::string output_file;
+
+  //! When set with commit_log_file, the messages committed by this state
+  //! are logged along with the time of their tick, in seconds.
+  ossia::execution_state* state{};
+  std::string commit_log_file;
+};
+
+struct offline_render_report
+{
+  uint64_t frames{};
+  uint64_t ticks{};
+
+  //! Duration of the rendered audio
+  double rendered_seconds{};
+
+  //! Time taken to render it
+  double elapsed_seconds{};
+
+  //! How many times faster than real-time the rendering was
+  double realtime_factor{};
+};
+
+/**
+ * @brief Calls the audio tick as fast as possible, without any audio device.
+ *
+ * Unlike the other engines, no driver thread calls the tick: render() does,
+ * in a loop on the calling thread, with the buffer size and sample rate
+ * given at construction. The inputs are silent.
+ * Used to render shows to disk, e.g. for regression tests on headless
+ * machines.
+ *
+ * stop() from another thread interrupts the current rendering.
+ */
+class OSSIA_EXPORT offline_engine final : public audio_engine
+{
+public:
+  offline_engine(int rate, int bs, int inputs, int outputs);
+  ~offline_engine() override;
+
+  //! True while rendering
+  bool running() const override;
+
+  offline_render_report render(const offline_render_settings& settings);
+
+private:
+  std::vector<ossia::float_vector> m_inputs;
+  std::vector<ossia::float_vector> m_outputs;
+  std::vector<float*> m_input_ptrs;
+  std::vector<float*> m_output_ptrs;
+  std::atomic_bool m_rendering{};
+};
+}
@@ -197,7 +197,7 @@ private:
     ossia::audio_tick_state ts{float_input, float_output, self.effective_inputs, self.effective_outputs, nframes, timeInfo->currentTime};
     self.audio_tick(ts);
 
-    self.tick_end();
+    self.tick_end(nframes);
 
     // auto t1 = std::chrono::steady_clock::now();
     //
@@ -219,6 +219,8 @@ public:
     rate = 48000;
     effective_inputs = inputs;
     effective_outputs = outputs;
+    effective_sample_rate = rate;
+    effective_buffer_size = bs;
     m_frames = bs;
 
     const auto &pa = libpulse::instance();
@@ -449,6 +451,7 @@ private:
     }
 
 
+    uint64_t frames = 0;
     {
 
       do {
@@ -456,7 +459,7 @@ private:
         if (res != 0) {
           // we're in huge trouble
           std::cerr << "no pa_stream_begin_write\n";
-          self.processing = false;
+          self.tick_end(frames);
           return;
         }
 
@@ -476,6 +479,7 @@ private:
 
             ossia::audio_tick_state ts{float_input, float_outputs, (int)self.effective_inputs, (int)self.effective_outputs, size, usec / 1e6};
             self.audio_tick(ts);
+            frames += size;
 
             int k = 0;
             for(std::size_t i = 0; i < size; i ++)
@@ -494,7 +498,7 @@ private:
                                           0LL, PA_SEEK_RELATIVE);
             res != 0) {
           // we're in huge trouble
-          self.processing = false;
+          self.tick_end(frames);
           return;
         }
 
@@ -504,7 +508,7 @@ private:
 
     }
 
-    self.tick_end();
+    self.tick_end(frames);
   }
 
   std::string m_name;
@@ -102,7 +102,7 @@ private:
         for (int c = 0; c < out_chan; c++)
           *audio_out++ = float_output[c][j];
 
-      self.tick_end();
+      self.tick_end(frames);
     }
   }
 
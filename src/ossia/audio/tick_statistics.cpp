@@ -0,0 +1,150 @@
+#include <ossia/audio/tick_statistics.hpp>
+#include <ossia/network/base/node.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/base/parameter.hpp>
+#include <ossia/network/dataspace/dataspace.hpp>
+
+#include <algorithm>
+
+namespace ossia
+{
+static thread_local tick_statistics* g_current_statistics{};
+
+tick_statistics::tick_statistics() noexcept = default;
+tick_statistics::~tick_statistics() = default;
+
+tick_statistics* tick_statistics::current() noexcept
+{
+  return g_current_statistics;
+}
+
+void tick_statistics::begin() noexcept
+{
+  m_previous = g_current_statistics;
+  g_current_statistics = this;
+  m_start = clock::now();
+}
+
+void tick_statistics::cancel() noexcept
+{
+  g_current_statistics = m_previous;
+}
+
+void tick_statistics::end(uint64_t frames, int rate) noexcept
+{
+  const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         clock::now() - m_start)
+                         .count();
+  g_current_statistics = m_previous;
+
+  increment(m_callbacks);
+  m_busy_ns.store(
+      m_busy_ns.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+
+  // Without a rate, e.g. before an engine knows it, there is no deadline
+  if (rate <= 0 || frames == 0)
+    return;
+
+  const int64_t period_ns = frames * 1'000'000'000 / rate;
+  const double load = double(ns) / period_ns;
+  m_last_load.store(load, std::memory_order_relaxed);
+
+  const int bin = std::min(int(load * bins_per_period), histogram_bins - 1);
+  increment(m_histogram[bin]);
+  if (ns > period_ns)
+    increment(m_deadline_misses);
+
+  if (ns > m_window_current_ns)
+  {
+    m_window_current_ns = ns;
+    m_window_current_load = load;
+  }
+
+  m_window_elapsed += period_ns;
+  if (m_window_elapsed >= m_window_ns.load(std::memory_order_relaxed))
+  {
+    m_window_max_ns.store(m_window_current_ns, std::memory_order_relaxed);
+    m_window_max_load.store(m_window_current_load, std::memory_order_relaxed);
+    m_window_elapsed = 0;
+    m_window_current_ns = 0;
+    m_window_current_load = 0.;
+  }
+}
+
+void tick_statistics::set_window(std::chrono::nanoseconds window) noexcept
+{
+  m_window_ns.store(window.count(), std::memory_order_relaxed);
+}
+
+tick_statistics::snapshot tick_statistics::read() const noexcept
+{
+  snapshot s;
+  s.callbacks = m_callbacks.load(std::memory_order_relaxed);
+  s.deadline_misses = m_deadline_misses.load(std::memory_order_relaxed);
+  for (int i = 0; i < histogram_bins; i++)
+    s.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+  s.busy_ns = m_busy_ns.load(std::memory_order_relaxed);
+  s.last_load = m_last_load.load(std::memory_order_relaxed);
+  s.window_max_ns = m_window_max_ns.load(std::memory_order_relaxed);
+  s.window_max_load = m_window_max_load.load(std::memory_order_relaxed);
+  for (int i = 0; i < phases; i++)
+    s.phase_ns[i] = m_phase_ns[i].load(std::memory_order_relaxed);
+  return s;
+}
+
+static ossia::net::parameter_base* make_statistics_parameter(
+    ossia::net::node_base& parent, std::string_view name, ossia::val_type t)
+{
+  auto& node = ossia::net::find_or_create_node(parent, name);
+  auto p = node.create_parameter(t);
+  p->set_access(ossia::access_mode::GET);
+  return p;
+}
+
+tick_statistics_parameters::tick_statistics_parameters(
+    ossia::net::node_base& parent)
+{
+  using ossia::val_type;
+  m_callbacks = make_statistics_parameter(parent, "callbacks", val_type::INT);
+  m_deadline_misses
+      = make_statistics_parameter(parent, "deadline_misses", val_type::INT);
+  m_load = make_statistics_parameter(parent, "load", val_type::FLOAT);
+  m_max_load = make_statistics_parameter(parent, "max_load", val_type::FLOAT);
+  m_max_duration
+      = make_statistics_parameter(parent, "max_duration", val_type::FLOAT);
+  m_histogram = make_statistics_parameter(parent, "histogram", val_type::LIST);
+  m_phases[int(tick_phase::temporal)]
+      = make_statistics_parameter(parent, "phase/temporal", val_type::FLOAT);
+  m_phases[int(tick_phase::dataflow)]
+      = make_statistics_parameter(parent, "phase/dataflow", val_type::FLOAT);
+  m_phases[int(tick_phase::commit)]
+      = make_statistics_parameter(parent, "phase/commit", val_type::FLOAT);
+
+  m_max_duration->set_unit(ossia::millisecond_u{});
+}
+
+void tick_statistics_parameters::update(const tick_statistics::snapshot& s)
+{
+  m_callbacks->push_value(int32_t(s.callbacks));
+  m_deadline_misses->push_value(int32_t(s.deadline_misses));
+  m_load->push_value(float(s.last_load));
+  m_max_load->push_value(float(s.window_max_load));
+  m_max_duration->push_value(float(s.window_max_ns / 1e6));
+
+  std::vector<ossia::value> histogram;
+  histogram.reserve(s.histogram.size());
+  for (auto count : s.histogram)
+    histogram.push_back(int32_t(count));
+  m_histogram->push_value(std::move(histogram));
+
+  // Share of the time of the callbacks since the last update
+  const int64_t busy = s.busy_ns - m_previous.busy_ns;
+  for (int i = 0; i < tick_statistics::phases; i++)
+  {
+    const int64_t phase = s.phase_ns[i] - m_previous.phase_ns[i];
+    m_phases[i]->push_value(busy > 0 ? float(double(phase) / busy) : 0.f);
+  }
+
+  m_previous = s;
+}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ossia
+{
+namespace net
+{
+class node_base;
+class parameter_base;
+}
+
+//! Parts of an audio tick whose durations are measured by tick_statistics
+enum class tick_phase : uint8_t
+{
+  temporal, //!< Ticking the time intervals and processes
+  dataflow, //!< Running the graph
+  commit    //!< Applying the messages to the devices
+};
+
+/**
+ * @brief Durations of the audio callbacks of an engine, relative to their
+ * deadline.
+ *
+ * The deadline of a callback is the duration of the frames it renders.
+ * Each counter is only written by the audio thread, without locks nor
+ * system calls besides reading the clock; they can be read from any thread
+ * with read(), where a snapshot may mix two consecutive callbacks.
+ *
+ * The durations of the tick_phase are measured by the tick functors with
+ * tick_phase_scope, which only reads the clock when called in a callback
+ * measured by an engine.
+ */
+class OSSIA_EXPORT tick_statistics
+{
+public:
+  //! Bins of the histogram per buffer period: the bin i counts the callbacks
+  //! which took between i and i+1 twentieths of their period.
+  static constexpr int bins_per_period = 20;
+  //! The last bin counts the callbacks which took more than two periods.
+  static constexpr int histogram_bins = 2 * bins_per_period + 1;
+  static constexpr int phases = 3;
+
+  struct snapshot
+  {
+    uint64_t callbacks{};
+    uint64_t deadline_misses{};
+    std::array<uint64_t, histogram_bins> histogram{};
+
+    //! Time spent in the callbacks since the start
+    int64_t busy_ns{};
+
+    //! Duration of the last callback, over its period
+    double last_load{};
+
+    //! Longest callback in the last complete window, and its load
+    int64_t window_max_ns{};
+    double window_max_load{};
+
+    //! Time spent in each tick_phase since the start
+    std::array<int64_t, phases> phase_ns{};
+  };
+
+  tick_statistics() noexcept;
+  ~tick_statistics();
+
+  tick_statistics(const tick_statistics&) = delete;
+  tick_statistics& operator=(const tick_statistics&) = delete;
+
+  //! Audio thread: at the start of a callback
+  void begin() noexcept;
+
+  //! Audio thread: at the end of a callback which rendered frames
+  void end(uint64_t frames, int rate) noexcept;
+
+  //! Audio thread: at the end of a callback which did not render anything
+  void cancel() noexcept;
+
+  //! Audio time over which window_max_ns is taken, one second by default
+  void set_window(std::chrono::nanoseconds window) noexcept;
+
+  snapshot read() const noexcept;
+
+  //! Statistics of the callback running on the current thread, if any
+  static tick_statistics* current() noexcept;
+
+  //! Audio thread: adds to the time spent in a phase
+  void add(tick_phase phase, int64_t ns) noexcept
+  {
+    auto& p = m_phase_ns[int(phase)];
+    p.store(p.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+  }
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  static void increment(std::atomic<uint64_t>& v) noexcept
+  {
+    v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  clock::time_point m_start{};
+  tick_statistics* m_previous{};
+
+  std::atomic<uint64_t> m_callbacks{};
+  std::atomic<uint64_t> m_deadline_misses{};
+  std::atomic<int64_t> m_busy_ns{};
+  std::array<std::atomic<uint64_t>, histogram_bins> m_histogram{};
+  std::atomic<double> m_last_load{};
+  std::array<std::atomic<int64_t>, phases> m_phase_ns{};
+
+  std::atomic<int64_t> m_window_ns{1'000'000'000};
+  int64_t m_window_elapsed{};
+  int64_t m_window_current_ns{};
+  double m_window_current_load{};
+  std::atomic<int64_t> m_window_max_ns{};
+  std::atomic<double> m_window_max_load{};
+};
+
+//! Measures the time spent in a tick_phase, until the end of the scope
+struct tick_phase_scope
+{
+  explicit tick_phase_scope(tick_phase p) noexcept
+      : stats{tick_statistics::current()}
+      , phase{p}
+  {
+    if (stats)
+      start = std::chrono::steady_clock::now();
+  }
+
+  ~tick_phase_scope()
+  {
+    if (stats)
+      stats->add(
+          phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count());
+  }
+
+  tick_phase_scope(const tick_phase_scope&) = delete;
+  tick_phase_scope& operator=(const tick_phase_scope&) = delete;
+
+  tick_statistics* stats{};
+  std::chrono::steady_clock::time_point start{};
+  tick_phase phase{};
+};
+
+/**
+ * @brief Parameters of a device showing the tick_statistics of an engine.
+ *
+ * Creates read-only parameters under the given node, which update() sets
+ * from a snapshot: it is to be called periodically, out of the audio thread.
+ * The shares of the phases are taken since the previous update.
+ */
+class OSSIA_EXPORT tick_statistics_parameters
+{
+public:
+  explicit tick_statistics_parameters(ossia::net::node_base& parent);
+  void update(const tick_statistics::snapshot& s);
+
+private:
+  ossia::net::parameter_base* m_callbacks{};
+  ossia::net::parameter_base* m_deadline_misses{};
+  ossia::net::parameter_base* m_load{};
+  ossia::net::parameter_base* m_max_load{};
+  ossia::net::parameter_base* m_max_duration{};
+  ossia::net::parameter_base* m_histogram{};
+  std::array<ossia::net::parameter_base*, tick_statistics::phases> m_phases{};
+  tick_statistics::snapshot m_previous;
+};
+}
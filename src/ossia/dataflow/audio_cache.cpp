@@ -0,0 +1,192 @@
+#include <ossia/dataflow/audio_cache.hpp>
+#include <ossia/detail/logger.hpp>
+
+namespace ossia
+{
+static std::size_t resident_size(const audio_data& d) noexcept
+{
+  std::size_t bytes = 0;
+  for(auto& chan : d.data)
+    bytes += chan.size() * sizeof(audio_sample);
+  return bytes;
+}
+
+// References to a decoded sound held by the cache itself:
+// its entry and the shared state of the futures (or, until it is
+// fulfilled, the worker).
+static constexpr long cache_references = 2;
+
+audio_cache::audio_cache(std::size_t budget_bytes, int workers)
+    : m_budget{budget_bytes}
+{
+  for(int i = 0; i < workers; i++)
+    m_threads.emplace_back([this] { work(); });
+}
+
+audio_cache::~audio_cache()
+{
+  {
+    std::lock_guard lck{m_mutex};
+    m_running = false;
+  }
+  m_cv.notify_all();
+
+  for(auto& t : m_threads)
+    t.join();
+
+  for(auto& t : m_tasks)
+    t.promise.set_value(nullptr);
+}
+
+audio_cache& audio_cache::instance()
+{
+  static audio_cache cache{std::size_t(512) * 1024 * 1024};
+  return cache;
+}
+
+std::shared_future<audio_handle>
+audio_cache::load(const audio_cache_key& key, decoder dec)
+{
+  std::shared_future<audio_handle> res;
+  {
+    std::lock_guard lck{m_mutex};
+    if(auto it = m_entries.find(key); it != m_entries.end())
+    {
+      m_stats.hits++;
+      touch(it->second);
+      return it->second.data;
+    }
+
+    m_stats.misses++;
+    auto& t = m_tasks.emplace_back(task{key, std::move(dec), {}});
+    res = t.promise.get_future().share();
+
+    m_lru.push_front(key);
+    m_entries.emplace(key, entry{res, nullptr, 0, m_lru.begin()});
+  }
+  m_cv.notify_one();
+  return res;
+}
+
+audio_handle audio_cache::find(const audio_cache_key& key)
+{
+  std::lock_guard lck{m_mutex};
+  if(auto it = m_entries.find(key); it != m_entries.end() && it->second.handle)
+  {
+    m_stats.hits++;
+    touch(it->second);
+    return it->second.handle;
+  }
+
+  m_stats.misses++;
+  return nullptr;
+}
+
+void audio_cache::set_budget(std::size_t bytes)
+{
+  std::lock_guard lck{m_mutex};
+  m_budget = bytes;
+  trim_locked();
+}
+
+std::size_t audio_cache::budget() const noexcept
+{
+  std::lock_guard lck{m_mutex};
+  return m_budget;
+}
+
+void audio_cache::trim()
+{
+  std::lock_guard lck{m_mutex};
+  trim_locked();
+}
+
+audio_cache::statistics audio_cache::stats() const
+{
+  std::lock_guard lck{m_mutex};
+  auto s = m_stats;
+  s.entries = m_entries.size();
+  return s;
+}
+
+void audio_cache::touch(entry& e)
+{
+  m_lru.splice(m_lru.begin(), m_lru, e.lru);
+}
+
+void audio_cache::trim_locked(const entry* inserted)
+{
+  // From the least recently used
+  auto it = m_lru.end();
+  while(it != m_lru.begin() && m_stats.resident_bytes > m_budget)
+  {
+    --it;
+    auto e = m_entries.find(*it);
+    const auto& handle = e->second.handle;
+
+    // Still decoding, or used out of the cache.
+    // The sound being inserted is only referenced by the cache until its
+    // future is fulfilled: it would be evicted before being used.
+    if(!handle || handle.use_count() > cache_references
+       || &e->second == inserted)
+      continue;
+
+    m_stats.resident_bytes -= e->second.bytes;
+    m_stats.evictions++;
+    m_entries.erase(e);
+    it = m_lru.erase(it);
+  }
+}
+
+void audio_cache::work()
+{
+  std::unique_lock lck{m_mutex};
+  for(;;)
+  {
+    m_cv.wait(lck, [this] { return !m_running || !m_tasks.empty(); });
+    if(!m_running)
+      return;
+
+    auto t = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    lck.unlock();
+
+    audio_handle handle;
+    try
+    {
+      handle = t.dec();
+    }
+    catch(const std::exception& e)
+    {
+      ossia::logger().error("audio_cache: cannot decode {}: {}", t.key.file, e.what());
+    }
+    catch(...)
+    {
+      ossia::logger().error("audio_cache: cannot decode {}", t.key.file);
+    }
+
+    lck.lock();
+    if(auto it = m_entries.find(t.key); it != m_entries.end())
+    {
+      if(handle)
+      {
+        it->second.bytes = resident_size(*handle);
+        it->second.handle = handle;
+        m_stats.resident_bytes += it->second.bytes;
+        trim_locked(&it->second);
+      }
+      else
+      {
+        // Decoded again at the next request
+        m_lru.erase(it->second.lru);
+        m_entries.erase(it);
+      }
+    }
+    lck.unlock();
+
+    // Once the future is ready, the cache is up to date
+    t.promise.set_value(std::move(handle));
+    lck.lock();
+  }
+}
+}
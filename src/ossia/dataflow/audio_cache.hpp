@@ -0,0 +1,125 @@
+#pragma once
+#include <ossia/dataflow/nodes/media.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace ossia
+{
+//! Identifies a decoded sound in the audio_cache
+struct audio_cache_key
+{
+  //! Path or other identity of the file
+  std::string file;
+  //! e.g. modification time of the file, so that changes are decoded again
+  int64_t version{};
+  //! Rate at which the sound was decoded or resampled
+  int64_t sample_rate{};
+  //! Decoding options of the caller, e.g. upmixing or resampling quality
+  int64_t format{};
+
+  bool operator<(const audio_cache_key& other) const noexcept
+  {
+    return std::tie(file, version, sample_rate, format)
+           < std::tie(other.file, other.version, other.sample_rate, other.format);
+  }
+};
+
+/**
+ * @brief Decoded sounds shared by all the nodes of the process.
+ *
+ * The same sound file used in many places is decoded once, by worker threads,
+ * and its audio_handle is shared: e.g. given to sound_ref::set_sound.
+ *
+ * A sound stays resident as long as a handle to it exists out of the cache.
+ * Once it is unreferenced, it is kept for later uses until the sounds
+ * resident exceed the memory budget: then the least recently used
+ * unreferenced sounds are evicted first. The sound just decoded is always
+ * kept, even over the budget, so that its requests do not decode it again.
+ */
+class OSSIA_EXPORT audio_cache
+{
+public:
+  //! Decodes a sound, on a worker of the cache. Returns nullptr on failure.
+  using decoder = std::function<audio_handle()>;
+
+  struct statistics
+  {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    std::size_t entries{};
+    std::size_t resident_bytes{};
+  };
+
+  explicit audio_cache(std::size_t budget_bytes, int workers = 1);
+  ~audio_cache();
+
+  audio_cache(const audio_cache&) = delete;
+  audio_cache& operator=(const audio_cache&) = delete;
+
+  //! The cache of the process, with a budget of 512 MiB
+  static audio_cache& instance();
+
+  /**
+   * @brief Gives the sound identified by key, decoding it if needed.
+   *
+   * Never blocks: the future is ready if the sound was resident, else it is
+   * fulfilled once a worker has decoded it. Concurrent requests of a sound
+   * share the same decoding.
+   */
+  std::shared_future<audio_handle> load(const audio_cache_key& key, decoder dec);
+
+  //! Gives the sound if it is resident and decoded, without decoding it.
+  audio_handle find(const audio_cache_key& key);
+
+  //! Budget of the unreferenced sounds kept in memory
+  void set_budget(std::size_t bytes);
+  std::size_t budget() const noexcept;
+
+  //! Evicts the unreferenced sounds over the budget
+  void trim();
+
+  statistics stats() const;
+
+private:
+  struct entry
+  {
+    std::shared_future<audio_handle> data;
+    audio_handle handle;
+    std::size_t bytes{};
+    std::list<audio_cache_key>::iterator lru;
+  };
+  struct task
+  {
+    audio_cache_key key;
+    decoder dec;
+    std::promise<audio_handle> promise;
+  };
+
+  void work();
+  void trim_locked(const entry* inserted = nullptr);
+  void touch(entry& e);
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<audio_cache_key, entry> m_entries;
+  // Most recently used first
+  std::list<audio_cache_key> m_lru;
+  std::list<task> m_tasks;
+  std::vector<std::thread> m_threads;
+
+  std::size_t m_budget{};
+  statistics m_stats;
+  bool m_running{true};
+};
+}
@@ -0,0 +1,651 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/dataflow/audio_kernels.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__GNUC__)
+#define OSSIA_KERNELS_VECTOR 1
+// The vector helpers are always inlined: there are no calls whose ABI
+// could depend on the instruction set.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#if defined(__x86_64__) || defined(__i386__)
+#define OSSIA_KERNELS_X86 1
+#endif
+// Used to deinterleave the frames of sound files. The 24-bit samples are
+// assembled by reinterpreting their bytes, thus the byte order.
+#if defined(__has_builtin) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#if __has_builtin(__builtin_shufflevector) \
+    && __has_builtin(__builtin_convertvector)
+#define OSSIA_KERNELS_SHUFFLE 1
+#endif
+#endif
+#endif
+
+namespace ossia::kernels
+{
+namespace
+{
+struct kernel_table
+{
+  const char* name;
+  void (*mix)(const sample*, sample*, std::size_t) noexcept;
+  void (*gain)(const sample*, sample*, sample, std::size_t) noexcept;
+  void (*gain_pan)(
+      const sample*, sample* const*, sample, const sample*, std::size_t,
+      std::size_t) noexcept;
+  void (*sum_gain)(
+      const sample* const*, const sample*, std::size_t, sample*,
+      std::size_t) noexcept;
+  void (*gain_ramp)(const sample*, sample*, sample, sample, std::size_t) noexcept;
+  void (*gain_curve)(
+      const sample*, sample*, sample, sample, sample, std::size_t) noexcept;
+  void (*decode_pcm[6])(
+      const void*, float* const*, std::size_t, std::size_t) noexcept;
+};
+
+/// Samples of sound files: x * scale + offset ///
+template <pcm_format F>
+struct pcm;
+template <>
+struct pcm<pcm_format::u8>
+{
+  using type = uint8_t;
+  static constexpr std::size_t size = 1;
+  static constexpr float scale = 1.f / 127.f;
+  static constexpr float offset = -1.f;
+};
+template <>
+struct pcm<pcm_format::s16>
+{
+  using type = int16_t;
+  static constexpr std::size_t size = 2;
+  static constexpr float scale = 1.f / (0x7FFF + .5f);
+  static constexpr float offset = .5f * scale;
+};
+template <>
+struct pcm<pcm_format::s24>
+{
+  // Stored in the upper bytes of an int32, then shifted down
+  using type = int32_t;
+  static constexpr std::size_t size = 3;
+  static constexpr float scale
+      = 256.f / float(std::numeric_limits<int32_t>::max());
+  static constexpr float offset = 0.f;
+};
+template <>
+struct pcm<pcm_format::s32>
+{
+  using type = int32_t;
+  static constexpr std::size_t size = 4;
+  static constexpr float scale
+      = 1.f / float(std::numeric_limits<int32_t>::max());
+  static constexpr float offset = 0.f;
+};
+template <>
+struct pcm<pcm_format::f32>
+{
+  using type = float;
+  static constexpr std::size_t size = 4;
+  static constexpr float scale = 1.f;
+  static constexpr float offset = 0.f;
+};
+template <>
+struct pcm<pcm_format::f64>
+{
+  using type = double;
+  static constexpr std::size_t size = 8;
+  static constexpr float scale = 1.f;
+  static constexpr float offset = 0.f;
+};
+
+template <pcm_format F>
+inline float load_pcm_sample(const uint8_t* src, std::size_t k) noexcept
+{
+  using format = pcm<F>;
+  src += k * format::size;
+  if constexpr (F == pcm_format::s24)
+  {
+    const uint32_t x = (uint32_t(src[0]) << 8) | (uint32_t(src[1]) << 16)
+                       | (uint32_t(src[2]) << 24);
+    return float(int32_t(x) >> 8) * format::scale + format::offset;
+  }
+  else
+  {
+    typename format::type x;
+    std::memcpy(&x, src, sizeof(x));
+    return float(x) * format::scale + format::offset;
+  }
+}
+
+//! Channel by channel, so that the writes are contiguous
+template <pcm_format F>
+inline void decode_pcm_loop(
+    const uint8_t* src, float* const* dst, std::size_t channels,
+    std::size_t first, std::size_t n) noexcept
+{
+  for (std::size_t c = 0; c < channels; c++)
+  {
+    float* out = dst[c];
+    for (std::size_t i = first; i < n; i++)
+      out[i] = load_pcm_sample<F>(src, i * channels + c);
+  }
+}
+
+/// Plain loops ///
+namespace scalar
+{
+void mix(const sample* src, sample* dst, std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] += src[i];
+}
+
+void gain(const sample* src, sample* dst, sample g, std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = src[i] * g;
+}
+
+void gain_pan(
+    const sample* src, sample* const* dst, sample g, const sample* pan,
+    std::size_t channels, std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+  {
+    const sample s = src[i] * g;
+    for (std::size_t c = 0; c < channels; c++)
+      dst[c][i] = s * pan[c];
+  }
+}
+
+void sum_gain(
+    const sample* const* src, const sample* gains, std::size_t count,
+    sample* dst, std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+  {
+    sample acc{};
+    for (std::size_t k = 0; k < count; k++)
+      acc += src[k][i] * gains[k];
+    dst[i] = acc;
+  }
+}
+
+void gain_ramp(
+    const sample* src, sample* dst, sample start, sample step,
+    std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+    dst[i] = src[i] * (start + sample(i) * step);
+}
+
+void gain_curve(
+    const sample* src, sample* dst, sample target, sample delta, sample ratio,
+    std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < n; i++)
+  {
+    dst[i] = src[i] * (target + delta);
+    delta *= ratio;
+  }
+}
+
+template <pcm_format F>
+void decode_pcm(
+    const void* src, float* const* dst, std::size_t channels,
+    std::size_t n) noexcept
+{
+  decode_pcm_loop<F>(static_cast<const uint8_t*>(src), dst, channels, 0, n);
+}
+
+constexpr kernel_table table{
+    "scalar",
+    mix,
+    gain,
+    gain_pan,
+    sum_gain,
+    gain_ramp,
+    gain_curve,
+    {decode_pcm<pcm_format::u8>, decode_pcm<pcm_format::s16>,
+     decode_pcm<pcm_format::s24>, decode_pcm<pcm_format::s32>,
+     decode_pcm<pcm_format::f32>, decode_pcm<pcm_format::f64>}};
+}
+
+#if defined(OSSIA_KERNELS_VECTOR)
+/// Generic vector code ///
+// Always inlined in the functions of each instruction set below,
+// so that it is compiled for their target.
+#define OSSIA_KERNEL inline __attribute__((always_inline))
+
+template <std::size_t Bytes>
+struct vec
+{
+  typedef sample type __attribute__((vector_size(Bytes)));
+  static constexpr std::size_t width = Bytes / sizeof(sample);
+
+  static OSSIA_KERNEL type load(const sample* p) noexcept
+  {
+    type v;
+    std::memcpy(&v, p, sizeof(type));
+    return v;
+  }
+
+  static OSSIA_KERNEL void store(sample* p, const type& v) noexcept
+  {
+    std::memcpy(p, &v, sizeof(type));
+  }
+};
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void mix_impl(const sample* src, sample* dst, std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+    V::store(dst + i, V::load(dst + i) + V::load(src + i));
+  for (; i < n; i++)
+    dst[i] += src[i];
+}
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void
+gain_impl(const sample* src, sample* dst, sample g, std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+    V::store(dst + i, V::load(src + i) * g);
+  for (; i < n; i++)
+    dst[i] = src[i] * g;
+}
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void gain_pan_impl(
+    const sample* src, sample* const* dst, sample g, const sample* pan,
+    std::size_t channels, std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+  {
+    const auto s = V::load(src + i) * g;
+    for (std::size_t c = 0; c < channels; c++)
+      V::store(dst[c] + i, s * pan[c]);
+  }
+  for (; i < n; i++)
+  {
+    const sample s = src[i] * g;
+    for (std::size_t c = 0; c < channels; c++)
+      dst[c][i] = s * pan[c];
+  }
+}
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void sum_gain_impl(
+    const sample* const* src, const sample* gains, std::size_t count,
+    sample* dst, std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+  {
+    typename V::type acc{};
+    for (std::size_t k = 0; k < count; k++)
+      acc += V::load(src[k] + i) * gains[k];
+    V::store(dst + i, acc);
+  }
+  for (; i < n; i++)
+  {
+    sample acc{};
+    for (std::size_t k = 0; k < count; k++)
+      acc += src[k][i] * gains[k];
+    dst[i] = acc;
+  }
+}
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void gain_ramp_impl(
+    const sample* src, sample* dst, sample start, sample step,
+    std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+  typename V::type index;
+  for (std::size_t l = 0; l < V::width; l++)
+    index[l] = sample(l);
+
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+    V::store(dst + i, V::load(src + i) * (start + (index + sample(i)) * step));
+  for (; i < n; i++)
+    dst[i] = src[i] * (start + sample(i) * step);
+}
+
+template <std::size_t Bytes>
+OSSIA_KERNEL void gain_curve_impl(
+    const sample* src, sample* dst, sample target, sample delta, sample ratio,
+    std::size_t n) noexcept
+{
+  using V = vec<Bytes>;
+
+  // delta * ratio^(i + lane), advanced by ratio^width at each step
+  typename V::type curve;
+  sample power = 1;
+  for (std::size_t l = 0; l < V::width; l++)
+  {
+    curve[l] = delta * power;
+    power *= ratio;
+  }
+
+  std::size_t i = 0;
+  for (; i + V::width <= n; i += V::width)
+  {
+    V::store(dst + i, V::load(src + i) * (target + curve));
+    curve *= power;
+  }
+  if (i < n)
+  {
+    delta = curve[0];
+    for (; i < n; i++)
+    {
+      dst[i] = src[i] * (target + delta);
+      delta *= ratio;
+    }
+  }
+}
+
+#if defined(OSSIA_KERNELS_SHUFFLE)
+template <typename T, std::size_t N>
+struct vector_of
+{
+  typedef T type __attribute__((vector_size(N * sizeof(T))));
+};
+
+// Lanes C, C + S, C + 2 * S... of v: channel C of frames of S channels
+template <std::size_t S, std::size_t C, typename V, std::size_t... L>
+OSSIA_KERNEL auto gather(const V& v, std::index_sequence<L...>) noexcept
+{
+  return __builtin_shufflevector(v, v, (L * S + C)...);
+}
+
+// Bytes {b0, b0, b1, b2} of each 24-bit sample of channel C:
+// once read as an int32 and shifted right by 8, the sign-extended sample.
+template <std::size_t S, std::size_t C, typename V, std::size_t... L>
+OSSIA_KERNEL auto gather_s24(const V& v, std::index_sequence<L...>) noexcept
+{
+  return __builtin_shufflevector(
+      v, v, (3 * ((L / 4) * S + C) + (L % 4 == 0 ? 0 : L % 4 - 1))...);
+}
+
+// W samples of channel C, from frames of S channels.
+// Reads W * S * sizeof(pcm<F>::type) bytes.
+template <pcm_format F, std::size_t W, std::size_t S, std::size_t C>
+OSSIA_KERNEL typename vector_of<float, W>::type
+load_pcm(const uint8_t* src) noexcept
+{
+  using format = pcm<F>;
+  using result = typename vector_of<float, W>::type;
+  typename vector_of<typename format::type, W>::type x;
+  if constexpr (F == pcm_format::s24)
+  {
+    typename vector_of<uint8_t, 4 * S * W>::type bytes;
+    std::memcpy(&bytes, src, sizeof(bytes));
+    const auto lanes
+        = gather_s24<S, C>(bytes, std::make_index_sequence<4 * W>{});
+    std::memcpy(&x, &lanes, sizeof(x));
+    x >>= 8;
+  }
+  else
+  {
+    typename vector_of<typename format::type, S * W>::type frames;
+    std::memcpy(&frames, src, sizeof(frames));
+    x = gather<S, C>(frames, std::make_index_sequence<W>{});
+  }
+  return __builtin_convertvector(x, result) * format::scale + format::offset;
+}
+
+template <std::size_t Bytes, pcm_format F>
+OSSIA_KERNEL void
+convert_pcm_impl(const uint8_t* src, float* dst, std::size_t n) noexcept
+{
+  constexpr std::size_t W = Bytes / sizeof(float);
+  constexpr std::size_t size = pcm<F>::size;
+  std::size_t i = 0;
+  for (; size * i + sizeof(typename pcm<F>::type) * W <= size * n; i += W)
+  {
+    const auto v = load_pcm<F, W, 1, 0>(src + size * i);
+    std::memcpy(dst + i, &v, sizeof(v));
+  }
+  for (; i < n; i++)
+    dst[i] = load_pcm_sample<F>(src, i);
+}
+
+// ByteShuffles: whether the instruction set can shuffle bytes in a vector.
+// Without it, assembling the 24-bit samples is slower than plain loops;
+// even with it, this is the case for interleaved 24-bit samples.
+template <std::size_t Bytes, bool ByteShuffles, pcm_format F>
+OSSIA_KERNEL void decode_pcm_impl(
+    const void* data, float* const* dst, std::size_t channels,
+    std::size_t n) noexcept
+{
+  constexpr std::size_t W = Bytes / sizeof(float);
+  constexpr std::size_t size = pcm<F>::size;
+  auto src = static_cast<const uint8_t*>(data);
+
+  std::size_t i = 0;
+  if constexpr (F != pcm_format::s24 || ByteShuffles)
+  {
+    if (channels == 1)
+    {
+      convert_pcm_impl<Bytes, F>(src, dst[0], n);
+      return;
+    }
+  }
+
+  if constexpr (F != pcm_format::s24)
+  {
+    if (channels == 2)
+    {
+      for (; i + W <= n; i += W)
+      {
+        const auto p = src + 2 * size * i;
+        const auto l = load_pcm<F, W, 2, 0>(p);
+        const auto r = load_pcm<F, W, 2, 1>(p);
+        std::memcpy(dst[0] + i, &l, sizeof(l));
+        std::memcpy(dst[1] + i, &r, sizeof(r));
+      }
+    }
+  }
+
+  // More channels: strided reads, compiled for the instruction set
+  decode_pcm_loop<F>(src, dst, channels, i, n);
+}
+#else
+template <std::size_t Bytes, bool ByteShuffles, pcm_format F>
+OSSIA_KERNEL void decode_pcm_impl(
+    const void* data, float* const* dst, std::size_t channels,
+    std::size_t n) noexcept
+{
+  decode_pcm_loop<F>(static_cast<const uint8_t*>(data), dst, channels, 0, n);
+}
+#endif
+
+#define OSSIA_DEFINE_KERNELS(isa, bytes, byte_shuffles, attributes)           \
+  namespace isa                                                               \
+  {                                                                           \
+  attributes void mix(const sample* src, sample* dst, std::size_t n) noexcept \
+  {                                                                           \
+    mix_impl<bytes>(src, dst, n);                                             \
+  }                                                                           \
+  attributes void                                                             \
+  gain(const sample* src, sample* dst, sample g, std::size_t n) noexcept      \
+  {                                                                           \
+    gain_impl<bytes>(src, dst, g, n);                                         \
+  }                                                                           \
+  attributes void gain_pan(                                                   \
+      const sample* src, sample* const* dst, sample g, const sample* pan,     \
+      std::size_t channels, std::size_t n) noexcept                           \
+  {                                                                           \
+    gain_pan_impl<bytes>(src, dst, g, pan, channels, n);                      \
+  }                                                                           \
+  attributes void sum_gain(                                                   \
+      const sample* const* src, const sample* gains, std::size_t count,       \
+      sample* dst, std::size_t n) noexcept                                    \
+  {                                                                           \
+    sum_gain_impl<bytes>(src, gains, count, dst, n);                          \
+  }                                                                           \
+  attributes void gain_ramp(                                                  \
+      const sample* src, sample* dst, sample start, sample step,              \
+      std::size_t n) noexcept                                                 \
+  {                                                                           \
+    gain_ramp_impl<bytes>(src, dst, start, step, n);                          \
+  }                                                                           \
+  attributes void gain_curve(                                                 \
+      const sample* src, sample* dst, sample target, sample delta,            \
+      sample ratio, std::size_t n) noexcept                                   \
+  {                                                                           \
+    gain_curve_impl<bytes>(src, dst, target, delta, ratio, n);                \
+  }                                                                           \
+  template <pcm_format F>                                                     \
+  attributes void decode_pcm(                                                 \
+      const void* src, float* const* dst, std::size_t channels,               \
+      std::size_t n) noexcept                                                 \
+  {                                                                           \
+    decode_pcm_impl<bytes, byte_shuffles, F>(src, dst, channels, n);          \
+  }                                                                           \
+  constexpr kernel_table table{                                               \
+      #isa,                                                                   \
+      mix,                                                                    \
+      gain,                                                                   \
+      gain_pan,                                                               \
+      sum_gain,                                                               \
+      gain_ramp,                                                              \
+      gain_curve,                                                             \
+      {decode_pcm<pcm_format::u8>, decode_pcm<pcm_format::s16>,               \
+       decode_pcm<pcm_format::s24>, decode_pcm<pcm_format::s32>,              \
+       decode_pcm<pcm_format::f32>, decode_pcm<pcm_format::f64>}};            \
+  }
+
+#if defined(OSSIA_KERNELS_X86)
+OSSIA_DEFINE_KERNELS(sse2, 16, false, __attribute__((target("sse2"))))
+OSSIA_DEFINE_KERNELS(avx2, 32, true, __attribute__((target("avx2"))))
+OSSIA_DEFINE_KERNELS(
+    avx512, 64, true, __attribute__((target("avx512f,avx512bw"))))
+#else
+// Uses the baseline vector instructions of the target, e.g. NEON
+OSSIA_DEFINE_KERNELS(simd, 16, true, )
+#endif
+#endif
+
+// Best first
+constexpr const kernel_table* tables[]{
+#if defined(OSSIA_KERNELS_X86)
+    &avx512::table, &avx2::table, &sse2::table,
+#elif defined(OSSIA_KERNELS_VECTOR)
+    &simd::table,
+#endif
+    &scalar::table};
+
+bool supported(const kernel_table& t) noexcept
+{
+#if defined(OSSIA_KERNELS_X86)
+  __builtin_cpu_init();
+  if (&t == &avx512::table)
+    return __builtin_cpu_supports("avx512f")
+           && __builtin_cpu_supports("avx512bw");
+  if (&t == &avx2::table)
+    return __builtin_cpu_supports("avx2");
+  if (&t == &sse2::table)
+    return __builtin_cpu_supports("sse2");
+#endif
+  return true;
+}
+
+std::atomic<const kernel_table*> g_table{};
+
+const kernel_table& current() noexcept
+{
+  auto t = g_table.load(std::memory_order_relaxed);
+  if (!t)
+  {
+    for (auto candidate : tables)
+    {
+      if (supported(*candidate))
+      {
+        t = candidate;
+        break;
+      }
+    }
+    g_table.store(t, std::memory_order_relaxed);
+  }
+  return *t;
+}
+}
+
+void mix(const sample* src, sample* dst, std::size_t n) noexcept
+{
+  current().mix(src, dst, n);
+}
+
+void gain(const sample* src, sample* dst, sample g, std::size_t n) noexcept
+{
+  current().gain(src, dst, g, n);
+}
+
+void gain_pan(
+    const sample* src, sample* const* dst, sample g, const sample* pan,
+    std::size_t channels, std::size_t n) noexcept
+{
+  current().gain_pan(src, dst, g, pan, channels, n);
+}
+
+void sum_gain(
+    const sample* const* src, const sample* gains, std::size_t count,
+    sample* dst, std::size_t n) noexcept
+{
+  current().sum_gain(src, gains, count, dst, n);
+}
+
+void gain_ramp(
+    const sample* src, sample* dst, sample start, sample step,
+    std::size_t n) noexcept
+{
+  current().gain_ramp(src, dst, start, step, n);
+}
+
+void gain_curve(
+    const sample* src, sample* dst, sample target, sample delta, sample ratio,
+    std::size_t n) noexcept
+{
+  current().gain_curve(src, dst, target, delta, ratio, n);
+}
+
+void decode_pcm(
+    pcm_format format, const void* src, float* const* dst, std::size_t channels,
+    std::size_t frames) noexcept
+{
+  current().decode_pcm[std::size_t(format)](src, dst, channels, frames);
+}
+
+const char* instruction_set() noexcept
+{
+  return current().name;
+}
+
+bool set_instruction_set(std::string_view name) noexcept
+{
+  for (auto candidate : tables)
+  {
+    if (candidate->name == name && supported(*candidate))
+    {
+      g_table.store(candidate, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <ossia/dataflow/nodes/media.hpp>
+#include <ossia/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * \file audio_kernels.hpp
+ *
+ * Vectorized loops of the audio processing of the dataflow.
+ *
+ * The implementation is chosen once, at the first use, according to the
+ * instruction sets supported by the CPU: AVX-512, AVX2 or SSE2 on x86.
+ * Elsewhere the kernels are built with the baseline vector instructions of
+ * the target (e.g. NEON on ARM64), or are plain loops if the compiler does
+ * not support vector extensions.
+ *
+ * Source and destination either do not overlap or are the same buffer.
+ */
+namespace ossia::kernels
+{
+using sample = ossia::audio_processing_sample;
+
+//! dst[i] += src[i]
+OSSIA_EXPORT
+void mix(const sample* src, sample* dst, std::size_t n) noexcept;
+
+//! dst[i] = src[i] * gain
+OSSIA_EXPORT
+void gain(const sample* src, sample* dst, sample gain, std::size_t n) noexcept;
+
+//! dst[c][i] = src[i] * gain * pan[c] for each of the channels
+OSSIA_EXPORT
+void gain_pan(
+    const sample* src, sample* const* dst, sample gain, const sample* pan,
+    std::size_t channels, std::size_t n) noexcept;
+
+//! dst[i] = sum over k of src[k][i] * gains[k]
+OSSIA_EXPORT
+void sum_gain(
+    const sample* const* src, const sample* gains, std::size_t count,
+    sample* dst, std::size_t n) noexcept;
+
+//! dst[i] = src[i] * (start + i * step): linear gain ramp
+OSSIA_EXPORT
+void gain_ramp(
+    const sample* src, sample* dst, sample start, sample step,
+    std::size_t n) noexcept;
+
+//! dst[i] = src[i] * (target + delta * ratio^i): exponential approach of a gain
+OSSIA_EXPORT
+void gain_curve(
+    const sample* src, sample* dst, sample target, sample delta, sample ratio,
+    std::size_t n) noexcept;
+
+//! Sample formats of sound files
+enum class pcm_format : uint8_t
+{
+  u8,
+  s16,
+  s24,
+  s32,
+  f32,
+  f64
+};
+
+//! dst[c][i] = src[i * channels + c], converted to float:
+//! reads the interleaved frames of a sound file.
+OSSIA_EXPORT
+void decode_pcm(
+    pcm_format format, const void* src, float* const* dst, std::size_t channels,
+    std::size_t frames) noexcept;
+
+//! Name of the instruction set used by the kernels, e.g. "avx2"
+OSSIA_EXPORT
+const char* instruction_set() noexcept;
+
+//! Forces another instruction set supported by the CPU, e.g. "scalar" for comparisons.
+//! Returns false if it is not available.
+OSSIA_EXPORT
+bool set_instruction_set(std::string_view name) noexcept;
+}
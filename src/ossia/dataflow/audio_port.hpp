@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/dataflow/delay_ring.hpp>
 #include <ossia/dataflow/nodes/media.hpp>
 #include <ossia/detail/small_vector.hpp>
 #include <ossia/detail/math.hpp>
@@ -18,12 +19,12 @@ struct audio_port
 
   audio_vector samples;
 
-  operator ossia::mutable_audio_span<double>() noexcept
+  operator ossia::mutable_audio_span<audio_processing_sample>() noexcept
   {
     return {samples.begin(), samples.end()};
   }
 
-  operator ossia::audio_span<double>() const noexcept
+  operator ossia::audio_span<audio_processing_sample>() const noexcept
   {
     return {samples.begin(), samples.end()};
   }
@@ -35,6 +36,6 @@ static_assert(noexcept(audio_port{}));
 
 struct audio_delay_line
 {
-  std::vector<audio_vector> samples;
+  delay_ring<audio_vector> samples;
 };
 }
@@ -27,10 +27,14 @@ struct delayed_glutton_connection
   // delayed at the source or at the target
   delay_line_type buffer;
   std::size_t pos{};
+
+  // Number of ticks kept for the target while it is disabled:
+  // the older ones are dropped. 0 keeps all of them.
+  std::size_t capacity{16};
 };
 struct delayed_strict_connection
 {
-  // same
+  // same; every tick is kept until the target reads it
   delay_line_type buffer;
   std::size_t pos{};
 };
@@ -2,6 +2,7 @@
 #include <ossia/dataflow/data.hpp>
 #include <ossia/detail/algorithms.hpp>
 #include <ossia/network/base/parameter.hpp>
+#include <ossia/dataflow/audio_kernels.hpp>
 #include <ossia/dataflow/audio_port.hpp>
 #include <ossia/dataflow/value_port.hpp>
 #include <ossia/dataflow/midi_port.hpp>
@@ -31,6 +32,55 @@ struct clear_data
   }
 };
 
+//! Position of the oldest entry still stored in a delay line
+struct data_first
+{
+  std::size_t operator()(const audio_delay_line& p) const
+  {
+    return p.samples.first();
+  }
+
+  std::size_t operator()(const midi_delay_line& p) const
+  {
+    return p.messages.first();
+  }
+
+  std::size_t operator()(const value_delay_line& p) const
+  {
+    return p.data.first();
+  }
+
+  std::size_t operator()() const
+  {
+    return 0;
+  }
+};
+
+//! Releases the entries of a delay line before a position
+struct data_release
+{
+  std::size_t pos{};
+
+  void operator()(audio_delay_line& p) const noexcept
+  {
+    p.samples.release(pos);
+  }
+
+  void operator()(midi_delay_line& p) const noexcept
+  {
+    p.messages.release(pos);
+  }
+
+  void operator()(value_delay_line& p) const noexcept
+  {
+    p.data.release(pos);
+  }
+
+  void operator()() const noexcept
+  {
+  }
+};
+
 struct data_size
 {
   std::size_t operator()(const value_delay_line& p) const
@@ -65,12 +115,7 @@ void mix(const audio_vector& src_vec, audio_vector& sink_vec)
   {
     auto& src = src_vec[chan];
     auto& sink = sink_vec[chan];
-    const std::size_t N = src.size();
-    auto src_p = src.data();
-    auto sink_p = sink.data();
-
-    for (std::size_t i = 0; i < N; i++)
-      sink_p[i] += src_p[i];
+    kernels::mix(src.data(), sink.data(), src.size());
   }
 }
 
@@ -115,20 +160,27 @@ struct copy_data
   void operator()(const value_port& out, value_delay_line& in)
   {
     // Called in env_writer, when copying from a node to a delay line
-    value_vector<ossia::typed_value> vec;
-    vec.reserve(out.get_data().size());
+    auto& vec = in.data.next();
+    vec.clear();
     for (const ossia::timed_value& val : out.get_data())
     {
       vec.emplace_back(val, out.index, out.type);
     }
-    in.data.push_back(std::move(vec));
   }
 
   /// Audio ///
   void operator()(const audio_port& out, audio_delay_line& in)
   {
     // Called in env_writer, when copying from a node to a delay line
-    in.samples.push_back(out.samples);
+    // The channels of the slot keep their capacity from one lap to another
+    auto& vec = in.samples.next();
+    const auto chans = out.samples.size();
+    vec.resize(chans);
+    for (std::size_t chan = 0; chan < chans; chan++)
+    {
+      const auto& src = out.samples[chan];
+      vec[chan].assign(src.begin(), src.end());
+    }
   }
 
   void operator()(const audio_port& out, audio_port& in)
@@ -154,7 +206,8 @@ struct copy_data
   void operator()(const midi_port& out, midi_delay_line& in)
   {
     // Called in env_writer, when copying from a node to a delay line
-    in.messages.push_back(out.messages);
+    auto& vec = in.messages.next();
+    vec.assign(out.messages.begin(), out.messages.end());
   }
 };
 
@@ -169,7 +222,7 @@ struct copy_data_pos
 
   void operator()(const value_delay_line& out, value_port& in)
   {
-    if (pos < out.data.size())
+    if (out.data.contains(pos))
     {
       copy_data{}(out.data[pos], in);
     }
@@ -177,7 +230,7 @@ struct copy_data_pos
 
   void operator()(const audio_delay_line& out, audio_port& in)
   {
-    if (pos < out.samples.size())
+    if (out.samples.contains(pos))
     {
       mix(out.samples[pos], in.samples);
     }
@@ -185,7 +238,7 @@ struct copy_data_pos
 
   void operator()(const midi_delay_line& out, midi_port& in)
   {
-    if (pos < out.messages.size())
+    if (out.messages.contains(pos))
     {
       copy_data{}(out.messages[pos], in);
     }
@@ -3,6 +3,8 @@
 #include <ossia/network/base/node.hpp>
 #include <ossia/network/common/path.hpp>
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace ossia
@@ -11,6 +13,20 @@ struct do_nothing_for_nodes {
   void operator()(ossia::net::node_base* node, bool) const noexcept { }
 };
 
+/**
+ * @brief Nodes matched by a pattern destination.
+ *
+ * The resolution is valid as long as the pattern and the version of the
+ * device trees it was resolved against (see execution_state::tree_version)
+ * stay the same.
+ */
+struct destination_cache
+{
+  std::vector<ossia::net::node_base*> nodes;
+  std::string pattern;
+  uint64_t version{};
+};
+
 template <typename Fun, typename NodeFun, typename DeviceList_T>
 bool apply_to_destination(
     const destination_t& address, const DeviceList_T& devices, Fun f, NodeFun nf)
@@ -56,4 +72,38 @@ bool apply_to_destination(
     }
   }
 }
+
+//! Same as above, but pattern destinations are only resolved
+//! when the device trees changed since the last call.
+template <typename Fun, typename NodeFun, typename DeviceList_T>
+bool apply_to_destination(
+    const destination_t& address, const DeviceList_T& devices,
+    destination_cache& cache, uint64_t version, Fun f, NodeFun nf)
+{
+  if (auto p = address.target<ossia::traversal::path>())
+  {
+    if (cache.version != version || cache.pattern != p->pattern)
+    {
+      cache.nodes.clear();
+      for (auto n : devices)
+        cache.nodes.push_back(&n->get_root_node());
+
+      ossia::traversal::apply(*p, cache.nodes);
+      cache.pattern = p->pattern;
+      cache.version = version;
+    }
+
+    const bool unique = cache.nodes.size() == 1;
+    for (auto n : cache.nodes)
+      if (auto addr = n->get_parameter())
+        f(addr, unique);
+      else
+        nf(n, unique);
+    return unique;
+  }
+  else
+  {
+    return apply_to_destination(address, devices, std::move(f), std::move(nf));
+  }
+}
 }
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ossia
+{
+/**
+ * @brief Storage of the data going through a delayed connection.
+ *
+ * Each tick of the source node writes one entry; entries are indexed
+ * by their absolute tick number since the creation of the line, as the
+ * position of the reading side of the connection.
+ * The slots are reused in a ring, so that their own storage (channels,
+ * value vectors...) is not reallocated once it has grown; the reading side
+ * releases the entries it has consumed.
+ *
+ * With a capacity, only the last `capacity` entries are kept, so that the
+ * memory stays bounded when the reading node is disabled for a long time.
+ * Without one, no entry is ever dropped: the ring grows until the reading
+ * side catches up.
+ */
+template <typename T>
+struct delay_ring
+{
+  static const constexpr std::size_t initial_size = 8;
+
+  //! A capacity of 0 keeps every entry until it is released.
+  explicit delay_ring(std::size_t capacity = 0)
+      : slots(capacity > 0 ? capacity : initial_size)
+      , capacity{capacity}
+  {
+  }
+
+  //! Number of entries written since the creation of the line
+  std::size_t size() const noexcept
+  {
+    return written;
+  }
+
+  //! Index of the oldest entry still stored
+  std::size_t first() const noexcept
+  {
+    return oldest;
+  }
+
+  bool contains(std::size_t pos) const noexcept
+  {
+    return pos >= oldest && pos < written;
+  }
+
+  const T& operator[](std::size_t pos) const noexcept
+  {
+    return slots[pos % slots.size()];
+  }
+
+  //! Gives the slot of the next entry; it may still hold an older entry.
+  T& next()
+  {
+    if (written - oldest == slots.size())
+    {
+      if (capacity > 0)
+        oldest++;
+      else
+        grow();
+    }
+    return slots[written++ % slots.size()];
+  }
+
+  //! The entries before pos will not be read anymore
+  void release(std::size_t pos) noexcept
+  {
+    oldest = std::clamp(pos, oldest, written);
+  }
+
+private:
+  void grow()
+  {
+    // The stored entries keep their index modulo the new size
+    const auto old_size = slots.size();
+    std::vector<T> bigger(2 * old_size);
+    for (std::size_t i = oldest; i < written; i++)
+      bigger[i % bigger.size()] = std::move(slots[i % old_size]);
+    slots = std::move(bigger);
+  }
+
+  std::vector<T> slots;
+  std::size_t capacity{};
+  std::size_t written{};
+  std::size_t oldest{};
+};
+}
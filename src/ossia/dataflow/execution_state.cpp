@@ -14,6 +14,8 @@
 #include <ossia/editor/state/detail/state_flatten_visitor.hpp>
 #include <ossia/editor/state/state_element.hpp>
 #include <ossia/network/base/message_queue.hpp>
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/protocol.hpp>
 #include <ossia/protocols/midi/midi_device.hpp>
 #include <ossia/protocols/midi/midi_protocol.hpp>
 #include <ossia/protocols/midi/detail/midi_impl.hpp>
@@ -28,10 +30,10 @@ struct local_pull_visitor
   bool operator()(value_port& val) const
   {
     OSSIA_EXEC_STATE_LOCK_READ(st);
-    auto it = st.m_valueState.find(addr);
-    if (it != st.m_valueState.end() && !it->second.empty())
+    auto data = st.m_valueState.find(addr);
+    if (data && !data->empty())
     {
-      copy_data{}(it->second, val);
+      copy_data{}(*data, val);
       return true;
     }
     return false;
@@ -40,10 +42,10 @@ struct local_pull_visitor
   bool operator()(audio_port& val) const
   {
     OSSIA_EXEC_STATE_LOCK_READ(st);
-    auto it = st.m_audioState.find(static_cast<ossia::audio_parameter*>(addr));
-    if (it != st.m_audioState.end() && !it->second.samples.empty())
+    auto data = st.m_audioState.find(static_cast<ossia::audio_parameter*>(addr));
+    if (data && !data->samples.empty())
     {
-      copy_data{}(it->second, val);
+      copy_data{}(*data, val);
       return true;
     }
     return false;
@@ -52,10 +54,10 @@ struct local_pull_visitor
   bool operator()(midi_port& val) const
   {
     OSSIA_EXEC_STATE_LOCK_READ(st);
-    auto it = st.m_midiState.find(addr);
-    if (it != st.m_midiState.end() && !it->second.empty())
+    auto data = st.m_midiState.find(addr);
+    if (data && !data->empty())
     {
-      copy_data{}(it->second, val);
+      copy_data{}(*data, val);
       return true;
     }
     return false;
@@ -197,8 +199,17 @@ execution_state::~execution_state()
 
 void execution_state::clear_devices()
 {
+  for (auto d : m_devices_edit)
+  {
+    d->on_node_created.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removing.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removed.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_renamed.disconnect<&execution_state::on_device_node_renamed>(*this);
+    d->on_attribute_modified.disconnect<&execution_state::on_device_attribute_modified>(*this);
+  }
   m_devices_edit.clear();
   m_devices_exec.clear();
+  invalidate_tree();
 }
 
 execution_state::execution_state()
@@ -206,6 +217,7 @@ execution_state::execution_state()
   m_valueState.reserve(100);
   m_audioState.reserve(8);
   m_midiState.reserve(4);
+  invalidate_tree();
 }
 
 void execution_state::register_device(net::device_base* d)
@@ -213,6 +225,11 @@ void execution_state::register_device(net::device_base* d)
   if (d)
   {
     m_devices_edit.push_back(d);
+    d->on_node_created.connect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removing.connect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removed.connect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_renamed.connect<&execution_state::on_device_node_renamed>(*this);
+    d->on_attribute_modified.connect<&execution_state::on_device_attribute_modified>(*this);
     m_device_change_queue.enqueue({device_operation::REGISTER, d});
   }
 }
@@ -221,11 +238,41 @@ void execution_state::unregister_device(net::device_base* d)
 {
   if (d)
   {
+    d->on_node_created.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removing.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_removed.disconnect<&execution_state::on_device_tree_changed>(*this);
+    d->on_node_renamed.disconnect<&execution_state::on_device_node_renamed>(*this);
+    d->on_attribute_modified.disconnect<&execution_state::on_device_attribute_modified>(*this);
     ossia::remove_erase(m_devices_edit, d);
     m_device_change_queue.enqueue({device_operation::UNREGISTER, d});
   }
 }
 
+void execution_state::on_device_tree_changed(ossia::net::node_base&)
+{
+  invalidate_tree();
+}
+
+void execution_state::on_device_node_renamed(ossia::net::node_base&, std::string)
+{
+  invalidate_tree();
+}
+
+void execution_state::on_device_attribute_modified(
+    ossia::net::node_base&, const std::string& attribute)
+{
+  if (attribute == ossia::net::text_priority())
+    m_priorities_version.fetch_add(1, std::memory_order_release);
+}
+
+void execution_state::invalidate_tree()
+{
+  // Versions are unique across all the execution states so that a port
+  // used with another state never sees a matching version.
+  static std::atomic<uint64_t> versions{};
+  m_tree_version.store(++versions, std::memory_order_release);
+}
+
 void execution_state::register_parameter(net::parameter_base& p)
 {
   auto device = &p.get_node().get_device();
@@ -301,8 +348,32 @@ void execution_state::get_new_values()
   }
 }
 
+template <typename Port>
+void execution_state::register_slots(const Port& port)
+{
+  auto addr = port.address.template target<ossia::net::parameter_base*>();
+  if (!addr)
+    return;
+
+  if (port.template target<ossia::value_port>())
+  {
+    m_valueState.slot(*addr);
+  }
+  else if (port.template target<ossia::audio_port>())
+  {
+    if (auto audio = dynamic_cast<ossia::audio_parameter*>(*addr))
+      m_audioState.slot(audio);
+  }
+  else if (port.template target<ossia::midi_port>())
+  {
+    m_midiState.slot(*addr);
+  }
+}
+
 void execution_state::register_port(const inlet& port)
 {
+  register_slots(port);
+
   if (auto vp = port.target<ossia::value_port>())
   {
     if (vp->is_event)
@@ -348,7 +419,7 @@ void execution_state::register_port(const inlet& port)
 
 void execution_state::register_port(const outlet& port)
 {
-  // nothing to do
+  register_slots(port);
 }
 
 
@@ -475,6 +546,8 @@ void execution_state::apply_device_changes()
       }
     }
   }
+
+  invalidate_tree();
 }
 void execution_state::begin_tick()
 {
@@ -526,6 +599,67 @@ to_state_element(ossia::net::parameter_base& p, const ossia::typed_value& v)
   return m;
 }
 
+namespace
+{
+using bundled_values = std::vector<ossia::net::bundle_element>;
+using observer_function = std::function<void(const ossia::state_element&)>;
+
+// Without a bundle, the element is pushed right away
+void launch_element(
+    ossia::message&& m, bundled_values* bundle,
+    const observer_function& observer)
+{
+  if (observer)
+    observer(ossia::state_element{m});
+
+  if (!bundle)
+    m.launch();
+  else if (auto v = m.launch_deferred())
+    bundle->push_back(std::move(*v));
+}
+
+void launch_element(
+    ossia::state_element& e, bundled_values* bundle,
+    const observer_function& observer)
+{
+  if (observer)
+    observer(e);
+
+  if (!bundle)
+    ossia::launch(e);
+  else
+    ossia::launch_deferred(e, *bundle);
+}
+}
+
+void execution_state::push_bundles()
+{
+  if (m_bundledValues.empty())
+    return;
+
+  // The order of the values is kept inside each protocol. They are sent
+  // as they were set, as a parameter may be set several times in a tick.
+  ossia::small_vector<ossia::net::protocol_base*, 4> protocols;
+  for (auto& v : m_bundledValues)
+  {
+    auto proto = &v.parameter->get_node().get_device().get_protocol();
+    if (!ossia::contains(protocols, proto))
+      protocols.push_back(proto);
+  }
+
+  for (auto proto : protocols)
+  {
+    m_bundle.clear();
+    for (auto& v : m_bundledValues)
+      if (&v.parameter->get_node().get_device().get_protocol() == proto)
+        m_bundle.push_back(std::move(v));
+    proto->push_bundle_values(m_bundle);
+  }
+
+  m_bundledValues.clear();
+  m_bundle.clear();
+}
+
 void execution_state::commit_common()
 {
   for (auto& elt : m_audioState)
@@ -555,6 +689,9 @@ void execution_state::commit_common()
       elt.second.clear();
     }
   }
+
+  m_audioState.clear_touched();
+  m_midiState.clear_touched();
 }
 
 void execution_state::advance_tick(std::size_t t)
@@ -587,6 +724,7 @@ void execution_state::advance_tick(std::size_t t)
 
 void execution_state::commit_merged()
 {
+  auto bundle = bundle_messages ? &m_bundledValues : nullptr;
   // int i = 0;
   for (auto it = m_valueState.begin(), end = m_valueState.end(); it != end;
        ++it)
@@ -597,7 +735,9 @@ void execution_state::commit_merged()
         continue;
       case 1:
       {
-        to_state_element(*it->first, it->second[0].first).launch();
+        launch_element(
+            to_state_element(*it->first, it->second[0].first), bundle,
+            commit_observer);
         break;
       }
       default:
@@ -609,18 +749,21 @@ void execution_state::commit_merged()
         {
           vis(to_state_element(*it->first, std::move(val.first)));
         }
-        ossia::launch(m_monoState.e);
+        launch_element(m_monoState.e, bundle, commit_observer);
       }
     }
     it->second.clear();
   }
   // std::cout << "NUM MESSAGES: " << i << std::endl;
 
+  m_valueState.clear_touched();
+  push_bundles();
   commit_common();
 }
 
 void execution_state::commit()
 {
+  auto bundle = bundle_messages ? &m_bundledValues : nullptr;
   state_flatten_visitor<ossia::flat_vec_state, false, true> vis{
       m_commitOrderedState};
   for (auto it = m_valueState.begin(), end = m_valueState.end(); it != end;
@@ -632,7 +775,9 @@ void execution_state::commit()
         continue;
       case 1:
       {
-        to_state_element(*it->first, it->second[0].first).launch();
+        launch_element(
+            to_state_element(*it->first, it->second[0].first), bundle,
+            commit_observer);
         break;
       }
       default:
@@ -645,23 +790,52 @@ void execution_state::commit()
           vis(to_state_element(*it->first, std::move(val.first)));
         }
 
-        m_commitOrderedState.launch();
+        for (auto& e : m_commitOrderedState)
+          launch_element(e, bundle, commit_observer);
       }
     }
 
     it->second.clear();
   }
 
+  m_valueState.clear_touched();
+  push_bundles();
   commit_common();
 }
 
+int execution_state::get_priority(ossia::net::parameter_base& p, int32_t slot)
+{
+  auto& cache = m_priorities[slot];
+  if (!cache.valid)
+  {
+    cache.priority = 0;
+    if (const auto& prio = ossia::net::get_priority(p.get_node()))
+      cache.priority = *prio;
+    cache.valid = true;
+  }
+  return cache.priority;
+}
+
 void execution_state::commit_priorized()
 {
-  // Here we use the priority of each node
-  ossia::flat_map<
-      std::tuple<ossia::net::priority, int64_t, int>,
-      std::vector<ossia::state_element>>
-      m_priorizedMessagesCache;
+  auto bundle = bundle_messages ? &m_bundledValues : nullptr;
+
+  // Here we use the priority of each node.
+  // Priorities are looked up again when they, or the device trees, change,
+  // as a parameter could have been replaced by another one at the same address.
+  const auto prio_version = m_priorities_version.load(std::memory_order_acquire);
+  const auto tree_version = this->tree_version();
+  if (prio_version != m_cachedPrioritiesVersion
+      || tree_version != m_cachedPrioritiesTree)
+  {
+    for (auto& p : m_priorities)
+      p.valid = false;
+    m_cachedPrioritiesVersion = prio_version;
+    m_cachedPrioritiesTree = tree_version;
+  }
+  if (m_priorities.size() < m_valueState.slot_count())
+    m_priorities.resize(m_valueState.slot_count());
+
   for (auto it = m_valueState.begin(), end = m_valueState.end(); it != end;
        ++it)
   {
@@ -672,9 +846,7 @@ void execution_state::commit_priorized()
 
     int64_t cur_ts = 0; // timestamp
     int cur_ms = 0;     // message stamp
-    int cur_prio = 0;
-    if (const auto& p = ossia::net::get_priority(it->first->get_node()))
-      cur_prio = *p;
+    const int cur_prio = get_priority(*it->first, it.slot());
 
     for (auto& val : it->second)
     {
@@ -683,26 +855,31 @@ void execution_state::commit_priorized()
       vis(to_state_element(*it->first, std::move(val.first)));
     }
 
-    auto& idx
-        = m_priorizedMessagesCache[std::make_tuple(cur_prio, cur_ts, cur_ms)];
     for (auto& e : m_commitOrderedState)
-      idx.push_back(std::move(e));
+    {
+      m_priorizedOrder.push_back(
+          {cur_prio, cur_ts, cur_ms, int(m_priorizedElements.size())});
+      m_priorizedElements.push_back(std::move(e));
+    }
 
     it->second.clear();
   }
 
-  for (auto& vec : m_priorizedMessagesCache.container)
-  {
-    for (auto& mess : vec.second)
-      ossia::launch(mess);
-    vec.second.clear();
-  }
+  // The index keeps the elements of a parameter in their flattened order
+  std::sort(m_priorizedOrder.begin(), m_priorizedOrder.end());
+  for (const auto& elt : m_priorizedOrder)
+    launch_element(m_priorizedElements[elt.index], bundle, commit_observer);
+  m_priorizedOrder.clear();
+  m_priorizedElements.clear();
 
+  m_valueState.clear_touched();
+  push_bundles();
   commit_common();
 }
 
 void execution_state::commit_ordered()
 {
+  auto bundle = bundle_messages ? &m_bundledValues : nullptr;
   // TODO same for midi
   // m_flatMessagesCache.reserve(m_valueState.size());
   for (auto it = m_valueState.begin(), end = m_valueState.end(); it != end;
@@ -732,10 +909,12 @@ void execution_state::commit_ordered()
   for (auto& vec : m_flatMessagesCache.container)
   {
     for (auto& mess : vec.second)
-      ossia::launch(mess);
+      launch_element(mess, bundle, commit_observer);
     vec.second.clear();
   }
 
+  m_valueState.clear_touched();
+  push_bundles();
   commit_common();
 }
 
@@ -949,35 +1128,28 @@ void execution_state::insert(const ossia::state& v)
 
 static bool is_in(
     net::parameter_base& other,
-    const ossia::fast_hash_map<
-        ossia::net::parameter_base*,
+    const ossia::slot_state<
+        ossia::net::parameter_base,
         value_vector<std::pair<typed_value, int>>>& container)
 {
-  auto it = container.find(&other);
-  if (it == container.end())
-    return false;
-  return !it->second.empty();
+  auto data = container.find(&other);
+  return data && !data->empty();
 }
 static bool is_in(
     net::parameter_base& other,
-    const ossia::fast_hash_map<
-        ossia::net::parameter_base*, value_vector<libremidi::message>>& container)
+    const ossia::slot_state<
+        ossia::net::parameter_base, value_vector<libremidi::message>>& container)
 {
-  auto it = container.find(&other);
-  if (it == container.end())
-    return false;
-  return !it->second.empty();
+  auto data = container.find(&other);
+  return data && !data->empty();
 }
 static bool is_in(
     net::parameter_base& other,
-    const ossia::fast_hash_map<ossia::audio_parameter*, audio_port>&
-        container)
+    const ossia::slot_state<ossia::audio_parameter, audio_port>& container)
 {
   // TODO dangerous
-  auto it = container.find(static_cast<ossia::audio_parameter*>(&other));
-  if (it == container.end())
-    return false;
-  return !it->second.samples.empty();
+  auto data = container.find(static_cast<ossia::audio_parameter*>(&other));
+  return data && !data->samples.empty();
 }
 bool execution_state::in_local_scope(net::parameter_base& other) const
 {
@@ -1,5 +1,6 @@
 #pragma once
 #include <ossia/dataflow/dataflow_fwd.hpp>
+#include <ossia/dataflow/slot_state.hpp>
 #include <ossia/dataflow/value_vector.hpp>
 #include <ossia/detail/flat_map.hpp>
 #include <ossia/detail/hash_map.hpp>
@@ -16,7 +17,10 @@
 #include <libremidi/message.hpp>
 #endif
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <tuple>
 #if SIZE_MAX == 0xFFFFFFFF // 32-bit
 #include <ossia/dataflow/audio_port.hpp>
 #include <ossia/dataflow/value_port.hpp>
@@ -78,6 +82,15 @@ struct OSSIA_EXPORT execution_state : public Nano::Observer
   {
     return m_devices_exec;
   }
+
+  //! Changes whenever nodes are created, removed or renamed in the devices,
+  //! or when the list of devices changes. Used to invalidate destination_cache.
+  //! A removal changes it before and after the node is destroyed, so that
+  //! a resolution made in between is not kept.
+  uint64_t tree_version() const noexcept
+  {
+    return m_tree_version.load(std::memory_order_acquire);
+  }
   ossia::net::node_base* find_node(std::string_view name) const noexcept
   {
     for (auto dev : m_devices_exec)
@@ -140,16 +153,24 @@ struct OSSIA_EXPORT execution_state : public Nano::Observer
   double start_date{}; // in ns, for vst
   double cur_date{};
 
+  //! When set, the commits send the values of a tick in bundles,
+  //! one group per protocol, instead of pushing each parameter separately.
+  bool bundle_messages{};
+
+  //! When set, called by the commits with each element they push,
+  //! before pushing it: e.g. to log the messages of an offline rendering.
+  std::function<void(const ossia::state_element&)> commit_observer;
+
   // private:// disabled due to tests, but for some reason can't make friend
   // work
   // using value_state_impl = ossia::flat_multimap<int64_t,
   // std::pair<ossia::value, int>>;
-  ossia::fast_hash_map<
-      ossia::net::parameter_base*, value_vector<std::pair<typed_value, int>>>
+  ossia::slot_state<
+      ossia::net::parameter_base, value_vector<std::pair<typed_value, int>>>
       m_valueState;
-  ossia::fast_hash_map<ossia::audio_parameter*, audio_port> m_audioState;
-  ossia::fast_hash_map<
-      ossia::net::parameter_base*, value_vector<libremidi::message>>
+  ossia::slot_state<ossia::audio_parameter, audio_port> m_audioState;
+  ossia::slot_state<
+      ossia::net::parameter_base, value_vector<libremidi::message>>
       m_midiState;
 
   mutable shared_mutex_t mutex;
@@ -157,11 +178,23 @@ struct OSSIA_EXPORT execution_state : public Nano::Observer
 private:
   void get_new_values();
   void clear_local_state();
+  void push_bundles();
 
   void register_parameter(ossia::net::parameter_base& p);
   void unregister_parameter(ossia::net::parameter_base& p);
   void register_midi_parameter(net::midi::midi_protocol& p);
+  template <typename Port>
+  void register_slots(const Port& port);
   void unregister_midi_parameter(net::midi::midi_protocol& p);
+
+  void on_device_tree_changed(ossia::net::node_base&);
+  void on_device_node_renamed(ossia::net::node_base&, std::string);
+  void on_device_attribute_modified(
+      ossia::net::node_base&, const std::string& attribute);
+  void invalidate_tree();
+  std::atomic<uint64_t> m_tree_version{};
+  std::atomic<uint64_t> m_priorities_version{};
+
   ossia::small_vector<ossia::net::device_base*, 4> m_devices_edit;
   ossia::small_vector<ossia::net::device_base*, 4> m_devices_exec;
   struct device_operation
@@ -188,6 +221,39 @@ private:
   ossia::flat_map<std::pair<int64_t, int>, std::vector<ossia::state_element>>
       m_flatMessagesCache;
 
+  // Persistent structures of commit_priorized, so that it does not allocate
+  struct priorized_element
+  {
+    int priority{};
+    int64_t timestamp{};
+    int message_stamp{};
+    int index{}; // in m_priorizedElements
+
+    friend bool operator<(
+        const priorized_element& lhs, const priorized_element& rhs) noexcept
+    {
+      return std::tie(lhs.priority, lhs.timestamp, lhs.message_stamp, lhs.index)
+             < std::tie(
+                 rhs.priority, rhs.timestamp, rhs.message_stamp, rhs.index);
+    }
+  };
+  struct cached_priority
+  {
+    int priority{};
+    bool valid{};
+  };
+  int get_priority(ossia::net::parameter_base& p, int32_t slot);
+
+  std::vector<priorized_element> m_priorizedOrder;
+  std::vector<ossia::state_element> m_priorizedElements;
+  std::vector<cached_priority> m_priorities; // by slot in m_valueState
+  uint64_t m_cachedPrioritiesVersion{};
+  uint64_t m_cachedPrioritiesTree{};
+
+  // Values set during the commit, in order, when bundling
+  std::vector<ossia::net::bundle_element> m_bundledValues;
+  std::vector<ossia::net::bundle_element> m_bundle;
+
   int m_msgIndex{};
 
   friend struct local_pull_visitor;
@@ -46,7 +46,7 @@ make_graph_impl(const ossia::graph_setup_options& opt)
     }
     else if (sched == ossia::graph_setup_options::StaticFixed)
     {
-      using graph_type = graph_static<simple_update, exec_t>;
+      using graph_type = graph_static<incremental_update, exec_t>;
 
       auto g = std::make_shared<graph_type>();
       g->tick_fun.set_logger(opt.log);
@@ -86,45 +86,56 @@ make_graph_par_impl(const ossia::graph_setup_options& opt)
 {
   using namespace ossia;
 #if defined(OSSIA_PARALLEL)
-
   auto sched = opt.scheduling;
+  auto setup = [&](auto t) -> std::shared_ptr<ossia::graph_interface> {
+    using executor_t = typename decltype(t)::type;
+    auto init = [&](auto& g) {
+      g->update_fun.logger = opt.log;
+      g->update_fun.perf_map = opt.bench;
+      if constexpr (std::is_same_v<executor_t, work_stealing_executor>)
+      {
+        if (opt.threads > 0)
+          g->update_fun.set_thread_count(opt.threads);
+      }
+    };
 
-  if (sched == ossia::graph_setup_options::StaticBFS)
-  {
-    using graph_type
-        = graph_static<custom_parallel_update<bfs_update>, custom_parallel_exec>;
-
-    auto g = std::make_shared<graph_type>();
-
-    g->update_fun.logger = opt.log;
-    g->update_fun.perf_map = opt.bench;
-
-    return g;
-  }
-  else if (sched == ossia::graph_setup_options::StaticTC)
-  {
-    using graph_type
-        = graph_static<custom_parallel_update<tc_update<fast_tc>>, custom_parallel_exec>;
-
-    auto g = std::make_shared<graph_type>();
-
-    g->update_fun.logger = opt.log;
-    g->update_fun.perf_map = opt.bench;
+    if (sched == ossia::graph_setup_options::StaticBFS)
+    {
+      using graph_type = graph_static<
+          custom_parallel_update<bfs_update, executor_t>,
+          custom_parallel_exec>;
 
-    return g;
-  }
-  else if (sched == ossia::graph_setup_options::StaticFixed)
-  {
-    using graph_type
-        = graph_static<custom_parallel_update<simple_update>, custom_parallel_exec>;
+      auto g = std::make_shared<graph_type>();
+      init(g);
+      return g;
+    }
+    else if (sched == ossia::graph_setup_options::StaticTC)
+    {
+      using graph_type = graph_static<
+          custom_parallel_update<tc_update<fast_tc>, executor_t>,
+          custom_parallel_exec>;
 
-    auto g = std::make_shared<graph_type>();
+      auto g = std::make_shared<graph_type>();
+      init(g);
+      return g;
+    }
+    else if (sched == ossia::graph_setup_options::StaticFixed)
+    {
+      using graph_type = graph_static<
+          custom_parallel_update<incremental_update, executor_t>,
+          custom_parallel_exec>;
 
-    g->update_fun.logger = opt.log;
-    g->update_fun.perf_map = opt.bench;
+      auto g = std::make_shared<graph_type>();
+      init(g);
+      return g;
+    }
+    return {};
+  };
 
-    return g;
-  }
+  if (opt.executor == ossia::graph_setup_options::WorkStealing)
+    return setup(wrap_type<ossia::work_stealing_executor>{});
+  else
+    return setup(wrap_type<ossia::executor>{});
 #endif
   return {};
 }
@@ -155,6 +166,7 @@ smallfun::function<void(unsigned long, double), 128> make_tick(
   auto& g = static_cast<ossia::graph_base&>(gb);
   auto tick = settings.tick;
   auto commit = settings.commit;
+  st.bundle_messages = settings.bundle;
 
   if (commit == tick_setup_options::Default)
   {
@@ -164,8 +176,8 @@ smallfun::function<void(unsigned long, double), 128> make_tick(
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
     else if (tick == tick_setup_options::Precise)
       return ossia::precise_score_tick<commit_policy>{st, g, itv, transport};
-    //else if (tick == tick_setup_options::ScoreAccurate)
-    //  return ossia::split_score_tick<commit_policy>{st, g, itv, transport};
+    else if (tick == tick_setup_options::ScoreAccurate)
+      return ossia::split_score_tick<commit_policy>{st, g, root, transport};
     else
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
   }
@@ -177,8 +189,8 @@ smallfun::function<void(unsigned long, double), 128> make_tick(
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
     else if (tick == tick_setup_options::Precise)
       return ossia::precise_score_tick<commit_policy>{st, g, itv, transport};
-    //else if (tick == tick_setup_options::ScoreAccurate)
-    //  return ossia::split_score_tick<commit_policy>{st, g, itv, transport};
+    else if (tick == tick_setup_options::ScoreAccurate)
+      return ossia::split_score_tick<commit_policy>{st, g, root, transport};
     else
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
   }
@@ -190,8 +202,8 @@ smallfun::function<void(unsigned long, double), 128> make_tick(
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
     else if (tick == tick_setup_options::Precise)
       return ossia::precise_score_tick<commit_policy>{st, g, itv, transport};
-    //else if (tick == tick_setup_options::ScoreAccurate)
-    //  return ossia::split_score_tick<commit_policy>{st, g, itv, transport};
+    else if (tick == tick_setup_options::ScoreAccurate)
+      return ossia::split_score_tick<commit_policy>{st, g, root, transport};
     else
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
   }
@@ -203,8 +215,8 @@ smallfun::function<void(unsigned long, double), 128> make_tick(
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
     else if (tick == tick_setup_options::Precise)
       return ossia::precise_score_tick<commit_policy>{st, g, itv, transport};
-    //else if (tick == tick_setup_options::ScoreAccurate)
-    //  return ossia::split_score_tick<commit_policy>{st, g, itv, transport};
+    else if (tick == tick_setup_options::ScoreAccurate)
+      return ossia::split_score_tick<commit_policy>{st, g, root, transport};
     else
       return ossia::buffer_tick<commit_policy>{st, g, root, transport};
   }
@@ -271,6 +271,8 @@ public:
       if (m_dirty)
       {
         sort_nodes();
+        m_edits.clear();
+        m_needs_full_update = false;
         m_dirty = false;
       }
 
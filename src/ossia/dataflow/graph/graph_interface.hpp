@@ -61,6 +61,16 @@ struct graph_setup_options
   bool parallel{};
   std::shared_ptr<spdlog::logger> log{};
   std::shared_ptr<bench_map> bench{};
+
+  //! Only used when parallel is true
+  enum
+  {
+    CentralQueue,
+    WorkStealing
+  } executor{};
+
+  //! Worker threads of the work-stealing executor, 0 means hardware concurrency - 1
+  std::size_t threads{};
 };
 
 struct tick_setup_options
@@ -78,6 +88,10 @@ struct tick_setup_options
     ScoreAccurate,
     Precise
   } tick{};
+
+  //! Send the values of each tick in one bundle per protocol,
+  //! see execution_state::bundle_messages
+  bool bundle{};
 };
 
 OSSIA_EXPORT
@@ -152,17 +152,21 @@ struct init_node_visitor
 
   bool operator()(delayed_glutton_connection& con) const
   {
-    // TODO If there is data...
-    // Else...
+    // If the node was disabled for a while, the oldest entries
+    // it did not read have been overwritten: skip them.
+    con.pos = std::max(con.pos, ossia::apply(data_first{}, con.buffer));
     copy(con.buffer, con.pos, in);
     con.pos++;
+    ossia::apply(data_release{con.pos}, con.buffer);
     return false;
   }
 
   bool operator()(delayed_strict_connection& con) const
   {
+    // Nothing is dropped: the node replays every tick of the source
     copy(con.buffer, con.pos, in);
     con.pos++;
+    ossia::apply(data_release{con.pos}, con.buffer);
     return false;
   }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <ossia/dataflow/graph_node.hpp>
+#include <ossia/detail/algorithms.hpp>
 #include <ossia/detail/lockfree_queue.hpp>
 #include <ossia/detail/thread.hpp>
 #include <ossia/detail/fmt.hpp>
@@ -9,6 +10,9 @@
 #include <blockingconcurrentqueue.h>
 #include <concurrentqueue.h>
 #include <smallfun.hpp>
+
+#include <algorithm>
+#include <memory>
 #include <thread>
 #include <vector>
 #define DISABLE_DONE_TASKS
@@ -24,6 +28,7 @@ using task_function
 
 class taskflow;
 class executor;
+class work_stealing_executor;
 class task
 {
 public:
@@ -64,6 +69,11 @@ public:
   {
   }
 
+  int id() const noexcept
+  {
+    return m_taskId;
+  }
+
   void precede(task& other)
   {
     m_precedes.push_back(other.m_taskId);
@@ -73,9 +83,23 @@ public:
     other.m_dependencies++;
   }
 
+  void remove_precede(task& other)
+  {
+    auto it = ossia::find(m_precedes, other.m_taskId);
+    if (it == m_precedes.end())
+      return;
+
+    m_precedes.erase(it);
+#if defined(CHECK_FOLLOWS)
+    ossia::remove_one(other.m_follows, m_taskId);
+#endif
+    other.m_dependencies--;
+  }
+
 private:
   friend class taskflow;
   friend class executor;
+  friend class work_stealing_executor;
 
   int m_taskId {};
   int m_dependencies {0};
@@ -110,8 +134,14 @@ public:
     return &last;
   }
 
+  task& operator[](int taskId) noexcept
+  {
+    return m_tasks[taskId];
+  }
+
 private:
   friend class executor;
+  friend class work_stealing_executor;
 
   std::vector<task> m_tasks;
 };
@@ -331,6 +361,413 @@ private:
   std::array<std::atomic_int, 5000> m_checkVec;
 #endif
 };
+
+/**
+ * @brief Fixed-capacity Chase-Lev deque.
+ *
+ * Only the owning thread may push() / pop() at the bottom,
+ * any thread may steal() from the top.
+ * The capacity is set outside of execution (see work_stealing_executor::prepare)
+ * and is always at least the number of tasks of a taskflow, which is an upper
+ * bound on what a single deque can hold during a run: no reallocation
+ * ever happens during execution.
+ */
+class work_stealing_deque
+{
+public:
+  void reserve(std::size_t sz)
+  {
+    std::size_t cap = 1;
+    while (cap < sz)
+      cap *= 2;
+
+    if (cap <= m_capacity)
+      return;
+
+    m_buffer = std::make_unique<std::atomic<task*>[]>(cap);
+    m_capacity = cap;
+    m_mask = cap - 1;
+  }
+
+  void push(task* t) noexcept
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    m_buffer[b & m_mask].store(t, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  task* pop() noexcept
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t <= b)
+    {
+      task* res = m_buffer[b & m_mask].load(std::memory_order_relaxed);
+      if (t == b)
+      {
+        // Last element: race against the thieves
+        if (!m_top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed))
+          res = nullptr;
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return res;
+    }
+    else
+    {
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  task* steal() noexcept
+  {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+    if (t < b)
+    {
+      task* res = m_buffer[t & m_mask].load(std::memory_order_relaxed);
+      if (!m_top.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+      return res;
+    }
+    return nullptr;
+  }
+
+  bool empty() const noexcept
+  {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+private:
+  alignas(64) std::atomic<int64_t> m_top{0};
+  alignas(64) std::atomic<int64_t> m_bottom{0};
+  std::unique_ptr<std::atomic<task*>[]> m_buffer;
+  std::size_t m_capacity{};
+  std::size_t m_mask{};
+};
+
+/**
+ * @brief Work-stealing executor for a taskflow.
+ *
+ * Every worker owns a deque: tasks made ready by a worker are pushed
+ * on its own deque, and idle workers steal from the others.
+ * The thread calling run() (usually the audio thread) is worker 0:
+ * it executes tasks itself until the whole taskflow is done.
+ *
+ * Idle workers spin for a while, then park on a semaphore until
+ * new tasks are pushed. They are started by the first run() after the
+ * thread count is set, so that it can be set without spawning threads twice.
+ */
+class work_stealing_executor
+{
+public:
+  static constexpr int spin_count = 1024;
+
+  work_stealing_executor()
+      : m_threadCount{std::size_t(
+          std::max(1, int(std::thread::hardware_concurrency()) - 1))}
+  {
+  }
+
+  ~work_stealing_executor()
+  {
+    stop();
+  }
+
+  void set_task_executor(task_function f)
+  {
+    m_func = std::move(f);
+  }
+
+  //! Number of worker threads, in addition to the thread calling run().
+  std::size_t thread_count() const noexcept
+  {
+    return m_threadCount;
+  }
+
+  //! Must not be called while run() is executing.
+  void set_thread_count(std::size_t n)
+  {
+    stop();
+    m_threadCount = n;
+  }
+
+  void run(taskflow& tf)
+  {
+    m_tf = &tf;
+    if (tf.m_tasks.empty())
+    {
+      return;
+    }
+
+    if (m_queues.empty())
+      start();
+    prepare(tf);
+
+    m_toDoTasks = tf.m_tasks.size();
+    m_doneTasks.store(0, std::memory_order_relaxed);
+
+    for (auto& task : tf.m_tasks)
+    {
+      task.m_remaining_dependencies.store(
+          task.m_dependencies, std::memory_order_relaxed);
+      task.m_executed.store(false, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_active.store(true, std::memory_order_seq_cst);
+
+    auto& main_queue = *m_queues[0];
+#if defined(DISABLE_DONE_TASKS)
+    ossia::small_pod_vector<ossia::task*, 8> toCleanup;
+#endif
+    for (auto& task : tf.m_tasks)
+    {
+      if (task.m_dependencies == 0)
+      {
+#if defined(DISABLE_DONE_TASKS)
+        if (task.m_node->enabled())
+#endif
+        {
+          main_queue.push(&task);
+        }
+#if defined(DISABLE_DONE_TASKS)
+        else
+        {
+          toCleanup.push_back(&task);
+        }
+#endif
+      }
+    }
+    wake_workers(m_threads.size());
+
+#if defined(DISABLE_DONE_TASKS)
+    for (auto& task : toCleanup)
+    {
+      process_done(*task, 0);
+    }
+#endif
+
+    // The calling thread takes part in the execution
+    while (m_doneTasks.load(std::memory_order_acquire) != m_toDoTasks)
+    {
+      if (auto t = find_task(0))
+        execute(*t, 0);
+    }
+
+    m_active.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+private:
+  void start()
+  {
+    // Deque 0 belongs to the thread calling run()
+    for (std::size_t i = 0; i < m_threadCount + 1; i++)
+    {
+      auto& q = m_queues.emplace_back(std::make_unique<work_stealing_deque>());
+      q->reserve(m_capacity);
+    }
+
+    m_running = true;
+    m_threads.reserve(m_threadCount);
+    for (std::size_t i = 0; i < m_threadCount; i++)
+    {
+      m_threads.emplace_back([this, i] { worker_loop(i + 1); });
+    }
+  }
+
+  void stop()
+  {
+    m_running = false;
+    wake_workers(m_threads.size());
+    for (auto& t : m_threads)
+    {
+      t.join();
+    }
+    m_threads.clear();
+    m_queues.clear();
+  }
+
+  // Resize the deques if the graph grew: workers must not be stealing.
+  void prepare(taskflow& tf)
+  {
+    const std::size_t N = tf.m_tasks.size();
+    if (N <= m_capacity)
+      return;
+
+    while (m_stealing.load(std::memory_order_seq_cst) != 0)
+      std::this_thread::yield();
+
+    for (auto& q : m_queues)
+      q->reserve(N);
+    m_capacity = N;
+  }
+
+  void wake_workers(std::size_t n)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int sleeping = m_sleeping.load(std::memory_order_seq_cst);
+    if (sleeping > 0)
+      m_sleep.signal(std::min(sleeping, int(n)));
+  }
+
+  task* find_task(std::size_t self)
+  {
+    if (auto t = m_queues[self]->pop())
+      return t;
+
+    const std::size_t N = m_queues.size();
+    for (std::size_t i = 1; i < N; i++)
+    {
+      if (auto t = m_queues[(self + i) % N]->steal())
+        return t;
+    }
+    return nullptr;
+  }
+
+  bool has_work() const noexcept
+  {
+    for (auto& q : m_queues)
+      if (!q->empty())
+        return true;
+    return false;
+  }
+
+  void worker_loop(std::size_t self)
+  {
+    int spins = 0;
+    while (m_running.load(std::memory_order_relaxed))
+    {
+      task* t{};
+      m_stealing.fetch_add(1, std::memory_order_seq_cst);
+      if (m_active.load(std::memory_order_seq_cst))
+        t = find_task(self);
+      m_stealing.fetch_sub(1, std::memory_order_seq_cst);
+
+      if (t)
+      {
+        execute(*t, self);
+        spins = 0;
+      }
+      else if (++spins < spin_count)
+      {
+        if (spins > spin_count / 2)
+          std::this_thread::yield();
+      }
+      else
+      {
+        // Park. The second check avoids missing a push that happened
+        // between the last steal attempt and the increment.
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_running.load(std::memory_order_seq_cst)
+            && !(m_active.load(std::memory_order_seq_cst) && has_work()))
+        {
+          m_sleep.wait();
+        }
+        m_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        spins = 0;
+      }
+    }
+  }
+
+  void process_done(ossia::task& task, std::size_t self)
+  {
+    if (task.m_executed.exchange(true))
+      return;
+
+    auto& queue = *m_queues[self];
+    int pushed = 0;
+#if defined(DISABLE_DONE_TASKS)
+    ossia::small_pod_vector<ossia::task*, 8> toCleanup;
+#endif
+    for (int taskId : task.m_precedes)
+    {
+      auto& nextTask = m_tf->m_tasks[taskId];
+      assert(!nextTask.m_executed);
+
+      std::atomic_int& remaining = nextTask.m_remaining_dependencies;
+      assert(remaining > 0);
+      const int rem = remaining.fetch_sub(1, std::memory_order_acq_rel) - 1;
+      assert(rem >= 0);
+      if (rem == 0)
+      {
+#if defined(DISABLE_DONE_TASKS)
+        if (nextTask.m_node->enabled())
+#endif
+        {
+          queue.push(&nextTask);
+          pushed++;
+        }
+#if defined(DISABLE_DONE_TASKS)
+        else
+        {
+          toCleanup.push_back(&nextTask);
+        }
+#endif
+      }
+    }
+
+    // We will run one of the tasks ourselves: wake up helpers for the others
+    if (pushed > 1)
+      wake_workers(pushed - 1);
+
+#if defined(DISABLE_DONE_TASKS)
+    for (auto& clean : toCleanup)
+    {
+      process_done(*clean, self);
+    }
+#endif
+
+    this->m_doneTasks.fetch_add(1, std::memory_order_release);
+  }
+
+  void execute(task& task, std::size_t self)
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    try
+    {
+      assert(!task.m_executed);
+      m_func(*task.m_node);
+    }
+    catch (...)
+    {
+      fmt::print(stderr, "error !\n");
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    process_done(task, self);
+  }
+
+  task_function m_func;
+
+  std::atomic_bool m_running{};
+  std::atomic_bool m_active{};
+  std::atomic_int m_stealing{};
+  std::atomic_int m_sleeping{};
+  moodycamel::LightweightSemaphore m_sleep;
+
+  std::size_t m_threadCount{};
+  std::vector<std::thread> m_threads;
+  std::vector<std::unique_ptr<work_stealing_deque>> m_queues;
+  std::size_t m_capacity{};
+
+  taskflow* m_tf{};
+  std::atomic_size_t m_doneTasks = 0;
+  std::size_t m_toDoTasks = 0;
+};
 }
 
 #include <ossia/detail/hash_map.hpp>
@@ -338,7 +775,7 @@ private:
 namespace ossia
 {
 struct custom_parallel_exec;
-template <typename Impl>
+template <typename Impl, typename Executor = ossia::executor>
 struct custom_parallel_update
 {
 public:
@@ -365,7 +802,7 @@ public:
         for (auto node : topo_order)
         {
           (*perf_map)[node] = std::nullopt;
-          flow_nodes[node] = flow_graph.emplace(*node);
+          flow_nodes[node] = flow_graph.emplace(*node)->id();
         }
       }
       else
@@ -373,7 +810,7 @@ public:
         executor.set_task_executor(node_exec_logger{cur_state, *logger});
         for (auto node : topo_order)
         {
-          flow_nodes[node] = flow_graph.emplace(*node);
+          flow_nodes[node] = flow_graph.emplace(*node)->id();
         }
       }
     }
@@ -382,7 +819,7 @@ public:
       executor.set_task_executor(node_exec{cur_state});
       for (auto node : topo_order)
       {
-        flow_nodes[node] = flow_graph.emplace(*node);
+        flow_nodes[node] = flow_graph.emplace(*node)->id();
       }
     }
 
@@ -392,19 +829,68 @@ public:
       auto& n1 = graph[edge.m_source];
       auto& n2 = graph[edge.m_target];
 
-      auto& sender = flow_nodes[n2.get()];
-      auto& receiver = flow_nodes[n1.get()];
-      sender->precede(*receiver);
+      auto& sender = flow_graph[flow_nodes[n2.get()]];
+      auto& receiver = flow_graph[flow_nodes[n1.get()]];
+      sender.precede(receiver);
+    }
+  }
+
+  //! Applies the node additions and edge changes to the existing taskflow
+  bool apply_edits(const std::vector<graph_edit>& edits)
+  {
+    for (const graph_edit& edit : edits)
+    {
+      switch (edit.kind)
+      {
+        case graph_edit::add_node:
+        {
+          if (flow_nodes.find(edit.node) != flow_nodes.end())
+            break;
+          if (perf_map)
+            (*perf_map)[edit.node] = std::nullopt;
+          flow_nodes[edit.node] = flow_graph.emplace(*edit.node)->id();
+          break;
+        }
+        case graph_edit::connect:
+        case graph_edit::disconnect:
+        {
+          auto sender = flow_nodes.find(edit.source);
+          auto receiver = flow_nodes.find(edit.sink);
+          if (sender == flow_nodes.end() || receiver == flow_nodes.end())
+            return false;
+
+          auto& t1 = flow_graph[sender->second];
+          auto& t2 = flow_graph[receiver->second];
+          if (edit.kind == graph_edit::connect)
+            t1.precede(t2);
+          else
+            t1.remove_precede(t2);
+          break;
+        }
+      }
     }
+    return true;
   }
 
   template <typename Graph_T, typename DevicesT>
   void operator()(Graph_T& g, const DevicesT& devices)
   {
     impl(g, devices);
+
+    if constexpr (std::is_same_v<Impl, incremental_update>)
+    {
+      if (impl.incremental() && apply_edits(g.m_edits))
+        return;
+    }
+
     update_graph(g.m_nodes, g.m_all_nodes, impl.m_sub_graph);
   }
 
+  void set_thread_count(std::size_t n)
+  {
+    executor.set_thread_count(n);
+  }
+
 private:
   friend struct custom_parallel_exec;
 
@@ -412,8 +898,8 @@ private:
   execution_state* cur_state{};
 
   ossia::taskflow flow_graph;
-  ossia::executor executor;
-  ossia::fast_hash_map<graph_node*, ossia::task*> flow_nodes;
+  Executor executor;
+  ossia::fast_hash_map<graph_node*, int> flow_nodes;
 };
 
 struct custom_parallel_exec
@@ -423,9 +909,9 @@ struct custom_parallel_exec
   {
   }
 
-  template <typename Graph_T, typename Impl>
+  template <typename Graph_T, typename Impl, typename Executor>
   void operator()(
-      Graph_T& g, custom_parallel_update<Impl>& self, ossia::execution_state& e,
+      Graph_T& g, custom_parallel_update<Impl, Executor>& self, ossia::execution_state& e,
       const std::vector<ossia::graph_node*>&)
   {
     self.cur_state = &e;
@@ -435,6 +921,10 @@ struct custom_parallel_exec
 
 using custom_parallel_tc_graph
     = graph_static<custom_parallel_update<tc_update<fast_tc>>, custom_parallel_exec>;
+
+using work_stealing_tc_graph = graph_static<
+    custom_parallel_update<tc_update<fast_tc>, work_stealing_executor>,
+    custom_parallel_exec>;
 }
 
 //#undef memory_order_relaxed
@@ -2,6 +2,7 @@
 #include <ossia/dataflow/bench_map.hpp>
 #include <ossia/dataflow/graph/graph_interface.hpp>
 #include <ossia/dataflow/graph/graph_utils.hpp>
+#include <ossia/dataflow/graph/incremental_ordering.hpp>
 #include <ossia/dataflow/graph/node_executors.hpp>
 #include <ossia/dataflow/graph/transitive_closure.hpp>
 #include <ossia/editor/scenario/execution_log.hpp>
@@ -80,7 +81,13 @@ public:
       if (m_dirty)
       {
         update_fun(*this, e.exec_devices());
-        m_enabled_cache.clear();
+
+        // Only node removals can leave dangling pointers in the cache
+        if (m_needs_full_update)
+          m_enabled_cache.clear();
+
+        m_edits.clear();
+        m_needs_full_update = false;
         m_dirty = false;
       }
 
@@ -159,6 +166,39 @@ struct simple_update
   }
 };
 
+//! Like simple_update, but keeps the order up-to-date when nodes and
+//! edges are added or edges are removed, instead of sorting the whole graph.
+struct incremental_update
+{
+  ossia::graph_t& m_sub_graph;
+  template <typename Graph_T>
+  incremental_update(Graph_T& g) : m_sub_graph{g.m_graph}
+  {
+  }
+
+  template <typename Graph_T, typename DevicesT>
+  void operator()(Graph_T& g, const DevicesT& devices)
+  {
+    m_incremental = !g.m_needs_full_update
+                    && m_order.apply(g.m_edits, g.m_all_nodes);
+    if (!m_incremental)
+    {
+      g.sort_all_nodes(g.m_graph);
+      m_order.reset(g.m_all_nodes, g.m_graph);
+    }
+  }
+
+  //! Whether the last update only applied the graph edits
+  bool incremental() const noexcept
+  {
+    return m_incremental;
+  }
+
+private:
+  incremental_topological_order m_order;
+  bool m_incremental{};
+};
+
 struct bfs_update
 {
 public:
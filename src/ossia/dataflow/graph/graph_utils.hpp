@@ -119,7 +119,7 @@ struct OSSIA_EXPORT graph_util
   static void pull_from_parameter(inlet& in, execution_state& e)
   {
     apply_to_destination(
-        in.address, e.exec_devices(),
+        in.address, e.exec_devices(), in.address_cache, e.tree_version(),
         [&](ossia::net::parameter_base* addr, bool) {
           if (in.scope & port::scope_t::local)
           {
@@ -432,6 +432,23 @@ struct OSSIA_EXPORT graph_util
   }
 };
 
+//! A structural change to the graph since the last update.
+//! Used by update methods which are able to apply changes incrementally.
+struct graph_edit
+{
+  enum
+  {
+    add_node,
+    connect,
+    disconnect
+  } kind{};
+
+  graph_node* node{};       // add_node
+  graph_edge* edge{};       // connect / disconnect
+  graph_node* source{};     // the node of the outlet
+  graph_node* sink{};       // the node of the inlet
+};
+
 struct OSSIA_EXPORT graph_base : graph_interface
 {
   const std::vector<ossia::graph_node*>& get_nodes() const
@@ -480,10 +497,10 @@ struct OSSIA_EXPORT graph_base : graph_interface
     // bench[n.get()];
 
     auto vtx = boost::add_vertex(n, m_graph);
-    // m_nodes.insert({std::move(n), vtx});
     m_node_list.push_back(n.get());
+    m_edits.push_back({graph_edit::add_node, n.get()});
+    m_nodes.insert({std::move(n), vtx});
     m_dirty = true;
-    recompute_maps();
     return vtx;
   }
 
@@ -523,6 +540,7 @@ struct OSSIA_EXPORT graph_base : graph_interface
     }
     ossia::remove_one(m_node_list, n.get());
     m_dirty = true;
+    m_needs_full_update = true;
   }
 
   void connect(std::shared_ptr<graph_edge> edge) final override
@@ -545,8 +563,13 @@ struct OSSIA_EXPORT graph_base : graph_interface
         out_vtx = it2->second;
 
       // TODO check that two edges can be added
-      boost::add_edge(in_vtx, out_vtx, edge, m_graph);
-      recompute_maps();
+      // Edge descriptors hold a stable pointer to their property and stay
+      // valid when other edges are added or removed: no need to recompute
+      // everything.
+      auto [edge_desc, ok] = boost::add_edge(in_vtx, out_vtx, edge, m_graph);
+      m_edges.insert({edge, edge_desc});
+      m_edits.push_back({graph_edit::connect, nullptr, edge.get(),
+                         edge->out_node.get(), edge->in_node.get()});
       m_dirty = true;
     }
   }
@@ -560,18 +583,16 @@ struct OSSIA_EXPORT graph_base : graph_interface
   {
     if (edge)
     {
+      graph_edit edit{graph_edit::disconnect, nullptr, edge,
+                      edge->out_node.get(), edge->in_node.get()};
       edge->clear();
       auto it = m_edges.find(edge);
       if (it != m_edges.end())
       {
-        auto edg = boost::edges(m_graph);
-        if (std::find(edg.first, edg.second, it->second) != edg.second)
-        {
-          boost::remove_edge(it->second, m_graph);
-          recompute_maps();
-        }
+        boost::remove_edge(it->second, m_graph);
+        m_edges.erase(it);
+        m_edits.push_back(edit);
         m_dirty = true;
-        // no need to erase it since it won't be here after recompute_maps
       }
     }
   }
@@ -589,15 +610,18 @@ struct OSSIA_EXPORT graph_base : graph_interface
       node.first->clear();
     }
     m_dirty = true;
+    m_needs_full_update = true;
     m_nodes.clear();
     m_node_list.clear();
     m_edges.clear();
+    m_edits.clear();
     m_graph.clear();
   }
 
   void mark_dirty() final override
   {
     m_dirty = true;
+    m_needs_full_update = true;
   }
 
   ~graph_base() override
@@ -611,6 +635,10 @@ struct OSSIA_EXPORT graph_base : graph_interface
 
   graph_t m_graph;
 
+  //! Changes since the last update, meaningful if m_needs_full_update is false
+  std::vector<graph_edit> m_edits;
+
   bool m_dirty{};
+  bool m_needs_full_update{true};
 };
 }
@@ -0,0 +1,248 @@
+#pragma once
+#include <ossia/dataflow/graph/graph_utils.hpp>
+#include <ossia/detail/hash_map.hpp>
+#include <ossia/detail/small_vector.hpp>
+
+namespace ossia
+{
+
+/**
+ * @brief Maintains a topological order of the nodes of a graph across edits.
+ *
+ * Implements the algorithm of Pearce & Kelly,
+ * "A dynamic topological sort algorithm for directed acyclic graphs" (2006):
+ * inserting an edge only reorders the nodes whose position lies between
+ * the positions of its two ends, removing an edge never requires reordering.
+ *
+ * Like graph_static::sort_all_nodes, nodes without any port are kept
+ * at the beginning of the order.
+ */
+class incremental_topological_order
+{
+public:
+  void reset(const std::vector<graph_node*>& order, const graph_t& g)
+  {
+    m_nodes.clear();
+    m_nodes.reserve(order.size());
+    m_stateless_end = 0;
+
+    const int N = order.size();
+    for (int i = 0; i < N; i++)
+    {
+      graph_node* node = order[i];
+      m_nodes[node].index = i;
+      if (m_stateless_end == i && !has_ports(*node))
+        m_stateless_end++;
+    }
+
+    for (auto [ei, ei_end] = boost::edges(g); ei != ei_end; ++ei)
+    {
+      // Edges go from the node of the inlet to the node of the outlet
+      graph_node* sink = g[boost::source(*ei, g)].get();
+      graph_node* source = g[boost::target(*ei, g)].get();
+      m_nodes[source].successors.push_back(sink);
+      m_nodes[sink].predecessors.push_back(source);
+    }
+  }
+
+  //! Returns false if the edits can't be applied, e.g. if they create a cycle:
+  //! the caller must then do a full sort and call reset().
+  bool apply(const std::vector<graph_edit>& edits, std::vector<graph_node*>& order)
+  {
+    for (const graph_edit& edit : edits)
+    {
+      switch (edit.kind)
+      {
+        case graph_edit::add_node:
+          add_node(*edit.node, order);
+          break;
+        case graph_edit::connect:
+          if (!add_edge(edit.source, edit.sink, order))
+            return false;
+          break;
+        case graph_edit::disconnect:
+          remove_edge(edit.source, edit.sink);
+          break;
+      }
+    }
+    return true;
+  }
+
+private:
+  struct node_info
+  {
+    int index{};
+    bool visited{};
+    ossia::small_pod_vector<graph_node*, 4> successors;
+    ossia::small_pod_vector<graph_node*, 4> predecessors;
+  };
+
+  static bool has_ports(const graph_node& node) noexcept
+  {
+    return !(node.root_inputs().empty() && node.root_outputs().empty());
+  }
+
+  void add_node(graph_node& node, std::vector<graph_node*>& order)
+  {
+    if (m_nodes.find(&node) != m_nodes.end())
+      return;
+
+    if (has_ports(node))
+    {
+      m_nodes[&node].index = order.size();
+      order.push_back(&node);
+    }
+    else
+    {
+      order.insert(order.begin() + m_stateless_end, &node);
+      m_nodes[&node];
+      for (int i = m_stateless_end, N = order.size(); i < N; i++)
+        m_nodes[order[i]].index = i;
+      m_stateless_end++;
+    }
+  }
+
+  bool add_edge(graph_node* source, graph_node* sink, std::vector<graph_node*>& order)
+  {
+    auto src_it = m_nodes.find(source);
+    auto sink_it = m_nodes.find(sink);
+    if (src_it == m_nodes.end() || sink_it == m_nodes.end() || source == sink)
+      return false;
+
+    src_it->second.successors.push_back(sink);
+    sink_it->second.predecessors.push_back(source);
+
+    const int ub = src_it->second.index;
+    const int lb = sink_it->second.index;
+    if (ub < lb)
+      return true;
+
+    // Nodes reachable from the sink which are currently before the source
+    if (!search_forward(sink, ub))
+      return false;
+    // Nodes reaching the source which are currently after the sink
+    search_backward(source, lb);
+
+    reorder(order);
+    return true;
+  }
+
+  void remove_edge(graph_node* source, graph_node* sink)
+  {
+    auto src_it = m_nodes.find(source);
+    if (src_it != m_nodes.end())
+      ossia::remove_one(src_it->second.successors, sink);
+
+    auto sink_it = m_nodes.find(sink);
+    if (sink_it != m_nodes.end())
+      ossia::remove_one(sink_it->second.predecessors, source);
+  }
+
+  bool search_forward(graph_node* start, int ub)
+  {
+    m_forward.clear();
+    m_stack.clear();
+    m_stack.push_back(start);
+    m_nodes[start].visited = true;
+
+    while (!m_stack.empty())
+    {
+      graph_node* n = m_stack.back();
+      m_stack.pop_back();
+      m_forward.push_back(n);
+
+      for (graph_node* next : m_nodes[n].successors)
+      {
+        auto& info = m_nodes[next];
+        if (info.index == ub)
+        {
+          // Cycle
+          clear_visited(m_forward);
+          clear_visited(m_stack);
+          return false;
+        }
+        if (!info.visited && info.index < ub)
+        {
+          info.visited = true;
+          m_stack.push_back(next);
+        }
+      }
+    }
+    return true;
+  }
+
+  void search_backward(graph_node* start, int lb)
+  {
+    m_backward.clear();
+    m_stack.clear();
+    m_stack.push_back(start);
+    m_nodes[start].visited = true;
+
+    while (!m_stack.empty())
+    {
+      graph_node* n = m_stack.back();
+      m_stack.pop_back();
+      m_backward.push_back(n);
+
+      for (graph_node* prev : m_nodes[n].predecessors)
+      {
+        auto& info = m_nodes[prev];
+        if (!info.visited && lb < info.index)
+        {
+          info.visited = true;
+          m_stack.push_back(prev);
+        }
+      }
+    }
+  }
+
+  void reorder(std::vector<graph_node*>& order)
+  {
+    auto by_index = [this](graph_node* lhs, graph_node* rhs) {
+      return m_nodes[lhs].index < m_nodes[rhs].index;
+    };
+    std::sort(m_backward.begin(), m_backward.end(), by_index);
+    std::sort(m_forward.begin(), m_forward.end(), by_index);
+
+    // The affected nodes keep the same set of positions:
+    // the ones reaching the source go first, then the ones reachable from the sink.
+    m_indices.clear();
+    for (graph_node* n : m_backward)
+      m_indices.push_back(m_nodes[n].index);
+    for (graph_node* n : m_forward)
+      m_indices.push_back(m_nodes[n].index);
+    std::sort(m_indices.begin(), m_indices.end());
+
+    std::size_t i = 0;
+    for (graph_node* n : m_backward)
+    {
+      auto& info = m_nodes[n];
+      info.index = m_indices[i++];
+      info.visited = false;
+      order[info.index] = n;
+    }
+    for (graph_node* n : m_forward)
+    {
+      auto& info = m_nodes[n];
+      info.index = m_indices[i++];
+      info.visited = false;
+      order[info.index] = n;
+    }
+  }
+
+  template <typename T>
+  void clear_visited(const T& nodes)
+  {
+    for (graph_node* n : nodes)
+      m_nodes[n].visited = false;
+  }
+
+  ossia::fast_hash_map<graph_node*, node_info> m_nodes;
+  std::vector<graph_node*> m_forward;
+  std::vector<graph_node*> m_backward;
+  std::vector<graph_node*> m_stack;
+  std::vector<int> m_indices;
+  int m_stateless_end{};
+};
+
+}
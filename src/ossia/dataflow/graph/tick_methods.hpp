@@ -3,13 +3,19 @@
 #include <ossia/dataflow/graph/graph_interface.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 #include <ossia/detail/pod_vector.hpp>
+#include <ossia/detail/rt_audit.hpp>
 #include <ossia/editor/scenario/time_interval.hpp>
 #include <ossia/editor/scenario/scenario.hpp>
 #include <ossia/audio/audio_tick.hpp>
+#include <ossia/audio/tick_statistics.hpp>
 
 #include <ossia/editor/scenario/execution_log.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <memory>
+#include <vector>
 
 #if defined(SCORE_BENCHMARK)
 #if __has_include(<valgrind/callgrind.h>)
@@ -95,6 +101,7 @@ struct tick_all_nodes
 
   void operator()(unsigned long samples, double) const
   {
+    ossia::rt_audit::region audit;
     std::atomic_thread_fence(std::memory_order_seq_cst);
     e.begin_tick();
     const time_value old_date{e.samples_since_start};
@@ -102,12 +109,22 @@ struct tick_all_nodes
     const time_value new_date{e.samples_since_start};
 
     // TODO tempo / sig ?
-    for (auto& node : g.get_nodes())
-      node->request(token_request{old_date, new_date, 0_tv, 0_tv, 1.0, {}, ossia::root_tempo});
+    {
+      ossia::tick_phase_scope phase{ossia::tick_phase::temporal};
+      for (auto& node : g.get_nodes())
+        node->request(token_request{old_date, new_date, 0_tv, 0_tv, 1.0, {}, ossia::root_tempo});
+    }
 
-    g.state(e);
+    {
+      ossia::tick_phase_scope phase{ossia::tick_phase::dataflow};
+      g.state(e);
+    }
     std::atomic_thread_fence(std::memory_order_seq_cst);
-    e.commit();
+
+    {
+      ossia::tick_phase_scope phase{ossia::tick_phase::commit};
+      e.commit();
+    }
   }
 };
 
@@ -128,6 +145,7 @@ struct buffer_tick
 
   void operator()(unsigned long frameCount, double seconds)
   {
+    ossia::rt_audit::region audit;
     auto& itv = **scenar.get_time_intervals().begin();
 #if defined(OSSIA_EXECUTION_LOG)
     auto log = g_exec_log.start_tick();
@@ -158,6 +176,7 @@ struct buffer_tick
 #if defined(OSSIA_EXECUTION_LOG)
       auto log = g_exec_log.start_temporal();
 #endif
+      ossia::tick_phase_scope phase{ossia::tick_phase::temporal};
       scenar.state_impl(tok);
     }
 
@@ -166,7 +185,7 @@ struct buffer_tick
 #if defined(OSSIA_EXECUTION_LOG)
       auto log = g_exec_log.start_dataflow();
 #endif
-
+      ossia::tick_phase_scope phase{ossia::tick_phase::dataflow};
       g.state(st);
     }
 
@@ -177,13 +196,15 @@ struct buffer_tick
 #if defined(OSSIA_EXECUTION_LOG)
       auto log = g_exec_log.start_commit();
 #endif
-
+      ossia::tick_phase_scope phase{ossia::tick_phase::commit};
       (st.*Commit)();
     }
   }
 };
 
-// 1 tick per sample
+// 1 tick per sample.
+// Its phases are not measured by tick_statistics: reading the clock
+// for each sample would cost more than most of them.
 template <void (ossia::execution_state::*Commit)()>
 struct precise_score_tick
 {
@@ -199,6 +220,7 @@ struct precise_score_tick
 
   void operator()(unsigned long frameCount, double seconds)
   {
+    ossia::rt_audit::region audit;
     std::atomic_thread_fence(std::memory_order_seq_cst);
     st.bufferSize = 1;
     st.cur_date = seconds * 1e9;
@@ -218,126 +240,249 @@ struct precise_score_tick
   }
 };
 
-/*
+/**
+ * @brief One tick per sub-block between the events of a buffer
+ *
+ * The score is ticked once for the whole buffer, like in buffer_tick.
+ * The buffer is then cut at each sample where a token requested by a node
+ * starts or ends: this is where intervals start and stop, where loops wrap
+ * and where quantized triggers happen.
+ * The graph is run and committed once per sub-block, with the tokens
+ * split and offset accordingly, which gives the sample accuracy of
+ * precise_score_tick for a cost which only depends on the number of events.
+ *
+ * Tokens which do not go forward are not split: they are run
+ * in the sub-block where they start.
+ */
 template <void (ossia::execution_state::*Commit)()>
 struct split_score_tick
 {
-public:
-  split_score_tick(
-      ossia::execution_state& a, ossia::graph_interface& b,
-      ossia::time_interval& c)
-      : st{a}, g{b}, itv{c}
-  {
-  }
-
   ossia::execution_state& st;
   ossia::graph_interface& g;
-  ossia::time_interval& itv;
+  ossia::scenario& scenar;
   ossia::transport_info_fun transport;
 
-  static void do_cuts(
-      ossia::flat_set<int64_t>& cuts, token_request_vec& tokens,
-      time_value cur_date)
+  // Kept out of line so that the tick fits in the function of make_tick
+  struct split_state
   {
-    for (auto it = tokens.begin(); it != tokens.end(); ++it)
-    {
-      if (it->date > cur_date)
-      {
-        auto token_end_offset = it->offset + abs(it->date - cur_date);
-        auto start_it = cuts.upper_bound(it->offset);
-        while (start_it != cuts.end() && (*start_it) < token_end_offset)
-        {
-          auto cut = *start_it;
-          auto N = cut - it->offset;
-          auto inserted_token = *it;
+    ossia::time_value prev_date{};
+    std::vector<std::pair<ossia::graph_node*, ossia::token_request_vec>> requests;
+    std::size_t request_count{};
+    std::vector<int64_t> cuts;
+  };
+  std::shared_ptr<split_state> split = std::make_shared<split_state>();
+
+  //! The offset in a sub-block which starts at the sample block_start,
+  //! of a sample of the buffer, as seen by a token: the inverse of
+  //! its physical start.
+  static ossia::time_value block_offset(
+      const ossia::token_request& tk, int64_t sample, int64_t block_start,
+      double modelToSamples) noexcept
+  {
+    const double samplesToModel = (tk.speed > 0. ? tk.speed : 1.) / modelToSamples;
+    return ossia::time_value{std::llround((sample - block_start) * samplesToModel)};
+  }
 
-          // make first token shorter
-          it->date = cur_date + N;
+  //! The part of a token which covers the samples [from, to) of the buffer,
+  //! for a sub-block which starts at the sample block_start
+  static ossia::token_request split_token(
+      const ossia::token_request& tk, int64_t from, int64_t to,
+      int64_t block_start, double modelToSamples) noexcept
+  {
+    ossia::token_request res = tk;
+    const double samplesToModel = tk.speed / modelToSamples;
+    const int64_t start = tk.physical_start(modelToSamples);
+    const int64_t end = start + tk.physical_write_duration(modelToSamples);
+    const auto date_at = [&](int64_t sample) {
+      return tk.prev_date
+             + ossia::time_value{std::llround((sample - start) * samplesToModel)};
+    };
+    const auto position_at = [&](ossia::time_value date) {
+      const auto dur = (tk.date - tk.prev_date).impl;
+      const double ratio = dur != 0 ? (date - tk.prev_date).impl / double(dur) : 0.;
+      return tk.musical_start_position
+             + ratio * (tk.musical_end_position - tk.musical_start_position);
+    };
+    const bool bar_change = tk.musical_end_last_bar != tk.musical_start_last_bar;
+
+    if (from > start)
+    {
+      res.prev_date = date_at(from);
+      res.musical_start_position = position_at(res.prev_date);
+      if (bar_change && res.musical_start_position >= tk.musical_end_last_bar)
+        res.musical_start_last_bar = tk.musical_end_last_bar;
+      res.start_discontinuous = false;
+    }
 
-          // make next token
-          inserted_token.offset = cut;
-          it = tokens.insert(it, inserted_token);
+    if (to < end)
+    {
+      res.date = date_at(to);
+      res.musical_end_position = position_at(res.date);
+      if (bar_change && res.musical_end_position < tk.musical_end_last_bar)
+        res.musical_end_last_bar = tk.musical_start_last_bar;
+      res.end_discontinuous = false;
+    }
 
-          ++start_it;
-        }
-      }
+    res.offset = block_offset(tk, from, block_start, modelToSamples);
+    return res;
+  }
 
-      cur_date = it->date;
-    }
+  void operator()(const ossia::audio_tick_state& st)
+  {
+    (*this)(st.frames, st.seconds);
   }
 
-  void cut(ossia::graph_interface& g)
+  void operator()(unsigned long frameCount, double seconds)
   {
-    cuts.clear();
-    requests.clear();
-    for (const auto& node : g.get_nodes())
+    ossia::rt_audit::region audit;
+    auto& itv = **scenar.get_time_intervals().begin();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    st.begin_tick();
+
+    const auto flicks = frameCount * st.samplesToModelRatio;
+
+    auto& prev_date = split->prev_date;
+    ossia::token_request tok{};
+    tok.prev_date = prev_date;
+    tok.date = prev_date + flicks;
+    prev_date = tok.date;
+
+    if (transport.allocated())
     {
-      for (const auto& tk : node->requested_tokens)
-      {
-        cuts.insert(tk.offset.impl);
-        cuts.insert((tk.offset + abs(tk.date - tk.prev_date)).impl);
-      }
+      transport(itv.current_transport_info());
     }
 
-    for (auto& node : g.get_nodes())
+    // Temporal tick, for the whole buffer
     {
-      if (!node->requested_tokens.empty())
-      {
-        do_cuts(
-            cuts, node->requested_tokens,
-            node->requested_tokens.front().prev_date);
-        auto it
-            = requests.insert({node, {std::move(node->requested_tokens), {}}});
-        it.first->second.second
-            = it.first->second.first
-                  .begin(); // set iterator to begin() of token requests
-        node->requested_tokens.clear();
-      }
+      ossia::tick_phase_scope phase{ossia::tick_phase::temporal};
+      scenar.state_impl(tok);
     }
-    for (auto& cut : cuts)
+
+    const int64_t frames = frameCount;
+    take_requests(frames);
+
+    // Dataflow execution and commit, for each sub-block
+    int64_t block_start = 0;
+    for (int64_t block_end : split->cuts)
     {
-      st.begin_tick();
+      if (block_start > 0)
+        st.begin_tick();
+
+      const int64_t block_size = block_end - block_start;
+      st.samples_since_start += block_size;
+      st.bufferSize = (int)block_size;
+      st.cur_date = seconds * 1e9 + block_start * 1e9 / st.sampleRate;
 
-      for (auto& node : g.get_nodes())
       {
-        auto& req = requests[node];
-        if (req.second != req.first.end() && req.second->offset == cut)
-        {
-          node->request(*req.second);
-          ++req.second;
-        }
+        ossia::tick_phase_scope phase{ossia::tick_phase::dataflow};
+        give_requests(block_start, block_end, frames);
+        g.state(st);
       }
+      std::atomic_thread_fence(std::memory_order_seq_cst);
 
-      g.state(st);
-      (st.*Commit)();
+      {
+        ossia::tick_phase_scope phase{ossia::tick_phase::commit};
+        (st.*Commit)();
+      }
+
+      // Like buffer_tick, the last sub-block is not followed by
+      // advance_tick: the audio buffers stay advanced to it, which is only
+      // harmless because audio_protocol::setup_buffers resets them at the
+      // start of every audio callback.
+      if (block_end != frames)
+        st.advance_tick(block_size);
+      block_start = block_end;
     }
   }
 
-  void operator()(const ossia::audio_tick_state& st)
+private:
+  struct sample_range
   {
-    (*this)(st.frames, st.seconds);
+    int64_t start{};
+    int64_t end{};
+  };
+
+  sample_range range(const ossia::token_request& tk) const noexcept
+  {
+    if (tk.speed <= 0.)
+    {
+      const int64_t start = tk.offset.impl * st.modelToSamplesRatio;
+      return {start, start};
+    }
+
+    const int64_t start = tk.physical_start(st.modelToSamplesRatio);
+    return {start, start + tk.physical_write_duration(st.modelToSamplesRatio)};
   }
 
-  void operator()(unsigned long frameCount, double seconds)
+  // Takes the tokens requested by the temporal tick from the nodes,
+  // and finds the sample offsets where the buffer must be cut
+  void take_requests(int64_t frames)
   {
-    st.samples_since_start += frameCount;
-    st.bufferSize = (int)frameCount;
-    // we could run a syscall and call now() but that's a bit more costly.
-    st.cur_date = seconds * 1e9;
-    const ossia::token_request tok{};
-    itv.tick_offset(ossia::time_value{int64_t(frameCount)}, 0_tv, tok);
+    auto& requests = split->requests;
+    auto& cuts = split->cuts;
+    split->request_count = 0;
+    cuts.clear();
+
+    for (auto node : g.get_nodes())
+    {
+      if (node->requested_tokens.empty())
+        continue;
+
+      if (split->request_count == requests.size())
+        requests.emplace_back();
+      auto& req = requests[split->request_count++];
+      req.first = node;
+      req.second.clear();
+      std::swap(req.second, node->requested_tokens);
+
+      for (const auto& tk : req.second)
+      {
+        const auto r = range(tk);
+        if (r.start > 0 && r.start < frames)
+          cuts.push_back(r.start);
+        if (r.end > 0 && r.end < frames)
+          cuts.push_back(r.end);
+      }
+    }
 
-    cut(g);
+    cuts.push_back(frames);
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
   }
 
-private:
-  ossia::flat_set<int64_t> cuts;
-  std::map<
-      const ossia::graph_node*,
-      std::pair<ossia::token_request_vec, ossia::token_request_vec::iterator>>
-      requests;
+  // Gives back to the nodes the parts of their tokens in the sub-block
+  void give_requests(int64_t block_start, int64_t block_end, int64_t frames)
+  {
+    const bool last_block = block_end == frames;
+    for (std::size_t i = 0; i < split->request_count; i++)
+    {
+      auto& [node, tokens] = split->requests[i];
+      for (const auto& tk : tokens)
+      {
+        const auto r = range(tk);
+        if (r.start == r.end)
+        {
+          // Instantaneous tokens, e.g. at the start of an interval
+          if ((r.start >= block_start && r.start < block_end)
+              || (last_block && r.start >= block_end))
+          {
+            auto res = tk;
+            res.offset = block_offset(
+                tk, r.start, block_start, st.modelToSamplesRatio);
+            node->request(res);
+          }
+        }
+        else if (r.start < block_end && r.end > block_start)
+        {
+          node->request(split_token(
+              tk, std::max(r.start, block_start), std::min(r.end, block_end),
+              block_start, st.modelToSamplesRatio));
+        }
+      }
+    }
+  }
 };
-*/
 #if defined(SCORE_BENCHMARK)
 template <typename BaseTick>
 struct benchmark_score_tick
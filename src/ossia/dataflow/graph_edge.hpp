@@ -6,17 +6,20 @@ namespace ossia
 struct init_delay_line
 {
   delay_line_type& delay_line;
+  std::size_t capacity{};
   void operator()(const audio_port&) const noexcept
   {
-    delay_line = audio_delay_line{};
+    delay_line = audio_delay_line{delay_ring<audio_vector>{capacity}};
   }
   void operator()(const value_port&) const noexcept
   {
-    delay_line = value_delay_line{};
+    delay_line = value_delay_line{
+        delay_ring<value_vector<ossia::typed_value>>{capacity}};
   }
   void operator()(const midi_port&) const noexcept
   {
-    delay_line = midi_delay_line{};
+    delay_line = midi_delay_line{
+        delay_ring<value_vector<libremidi::message>>{capacity}};
   }
   void operator()() const noexcept
   {
@@ -84,7 +84,7 @@ void graph_edge::init() noexcept
 
     if (auto delay = con.target<delayed_glutton_connection>())
     {
-      out->visit(init_delay_line{delay->buffer});
+      out->visit(init_delay_line{delay->buffer, delay->capacity});
     }
     else if (auto sdelay = con.target<delayed_strict_connection>())
     {
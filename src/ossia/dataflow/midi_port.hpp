@@ -1,5 +1,6 @@
 #pragma once
 #include <libremidi/message.hpp>
+#include <ossia/dataflow/delay_ring.hpp>
 #include <ossia/dataflow/value_vector.hpp>
 
 namespace ossia
@@ -78,7 +79,7 @@ private:
 
 struct midi_delay_line
 {
-  std::vector<value_vector<libremidi::message>> messages;
+  delay_ring<value_vector<libremidi::message>> messages;
 };
 
 }
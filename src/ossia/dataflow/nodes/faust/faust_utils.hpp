@@ -188,63 +188,84 @@ struct faust_node_utils
     }
   }
 
-  template <typename Node>
-  static void copy_input(Node& self, int64_t d, int64_t n_in, float* inputs_, float** input_n, const ossia::audio_port& audio_in)
-  {
+  template <typename Sample, typename Dsp>
+  static void compute(
+      Dsp& dsp, int64_t d, int64_t n_in, int64_t n_out,
+      ossia::audio_port& audio_in, ossia::audio_port& audio_out)
+  {
+    // When the dsp uses the sample type of the ports, it computes in place
+    // on their buffers; else the samples go through conversion buffers.
+    constexpr bool in_place
+        = std::is_same_v<Sample, ossia::audio_processing_sample>;
+
+    Sample* inputs_{};
+    Sample* outputs_{};
+    if constexpr (!in_place)
+    {
+      inputs_ = (Sample*)alloca(n_in * d * sizeof(Sample));
+      outputs_ = (Sample*)alloca(n_out * d * sizeof(Sample));
+    }
+
+    Sample** input_n = (Sample**)alloca(sizeof(Sample*) * n_in);
+    Sample** output_n = (Sample**)alloca(sizeof(Sample*) * n_out);
+
     // TODO offset !!!
+    if constexpr (in_place)
+    {
+      if (int64_t(audio_in.samples.size()) < n_in)
+        audio_in.samples.resize(n_in);
+    }
     for (int64_t i = 0; i < n_in; i++)
     {
-      input_n[i] = inputs_ + i * d;
-      if (int64_t(audio_in.samples.size()) > i)
+      if constexpr (in_place)
       {
-        auto num_samples = std::min(
-              (int64_t)d, (int64_t)audio_in.samples[i].size());
-        for (int64_t j = 0; j < num_samples; j++)
-        {
-          input_n[i][j] = (float)audio_in.samples[i][j];
-        }
-
-        if (d > int64_t(audio_in.samples[i].size()))
-        {
-          for (int64_t j = audio_in.samples[i].size(); j < d; j++)
-          {
-            input_n[i][j] = 0.f;
-          }
-        }
+        auto& chan = audio_in.samples[i];
+        if (int64_t(chan.size()) < d)
+          chan.resize(d, 0);
+        input_n[i] = chan.data();
       }
       else
       {
-        for (int64_t j = 0; j < d; j++)
+        input_n[i] = inputs_ + i * d;
+        int64_t num_samples = 0;
+        if (int64_t(audio_in.samples.size()) > i)
         {
-          input_n[i][j] = 0.f;
+          auto& chan = audio_in.samples[i];
+          num_samples = std::min((int64_t)d, (int64_t)chan.size());
+          for (int64_t j = 0; j < num_samples; j++)
+            input_n[i][j] = (Sample)chan[j];
         }
+        for (int64_t j = num_samples; j < d; j++)
+          input_n[i][j] = 0;
       }
     }
-  }
 
-  template <typename Node>
-  static void init_output(Node& self, int64_t d, int64_t n_out, float* outputs_, float** output_n)
-  {
+    audio_out.samples.resize(n_out);
     for (int64_t i = 0; i < n_out; i++)
     {
-      output_n[i] = outputs_ + i * d;
-      for (int64_t j = 0; j < d; j++)
+      auto& chan = audio_out.samples[i];
+      chan.assign(d, 0);
+      if constexpr (in_place)
+      {
+        output_n[i] = chan.data();
+      }
+      else
       {
-        output_n[i][j] = 0.f;
+        output_n[i] = outputs_ + i * d;
+        for (int64_t j = 0; j < d; j++)
+          output_n[i][j] = 0;
       }
     }
-  }
 
-  template <typename Node>
-  static void copy_output(Node& self, int64_t d, int64_t n_out, float* outputs_, float** output_n, ossia::audio_port& audio_out)
-  {
-    audio_out.samples.resize(n_out);
-    for (int64_t i = 0; i < n_out; i++)
+    dsp.compute(d, input_n, output_n);
+
+    if constexpr (!in_place)
     {
-      audio_out.samples[i].resize(d);
-      for (int64_t j = 0; j < d; j++)
+      for (int64_t i = 0; i < n_out; i++)
       {
-        audio_out.samples[i][j] = (double)output_n[i][j];
+        auto& chan = audio_out.samples[i];
+        for (int64_t j = 0; j < d; j++)
+          chan[j] = (ossia::audio_processing_sample)output_n[i][j];
       }
     }
 
@@ -316,18 +337,9 @@ struct faust_node_utils
       const int64_t n_in = dsp.getNumInputs();
       const int64_t n_out = dsp.getNumOutputs();
 
-      float* inputs_ = (float*)alloca(n_in * d * sizeof(float));
-      float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
-
-      float** input_n = (float**)alloca(sizeof(float*) * n_in);
-      float** output_n = (float**)alloca(sizeof(float*) * n_out);
-
       copy_controls(self);
 
-      copy_input(self, d, n_in, inputs_, input_n, audio_in);
-      init_output(self, d, n_out, outputs_, output_n);
-      dsp.compute(d, input_n, output_n);
-      copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      compute<FAUSTFLOAT>(dsp, d, n_in, n_out, audio_in, audio_out);
 
       copy_displays(self, st);
     }
@@ -349,21 +361,12 @@ struct faust_node_utils
       const int64_t n_in = dsp.getNumInputs();
       const int64_t n_out = dsp.getNumOutputs();
 
-      float* inputs_ = (float*)alloca(n_in * d * sizeof(float));
-      float* outputs_ = (float*)alloca(n_out * d * sizeof(float));
-
-      float** input_n = (float**)alloca(sizeof(float*) * n_in);
-      float** output_n = (float**)alloca(sizeof(float*) * n_out);
-
       copy_controls(self);
       dsp.updateAllZones();
 
       copy_midi(self, dsp, midi_in);
 
-      copy_input(self, d, n_in, inputs_, input_n, audio_in);
-      init_output(self, d, n_out, outputs_, output_n);
-      dsp.compute(d, input_n, output_n);
-      copy_output(self, d, n_out, outputs_, output_n, audio_out);
+      compute<FAUSTFLOAT>(dsp, d, n_in, n_out, audio_in, audio_out);
 
       copy_displays(self, st);
     }
@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/dataflow/audio_kernels.hpp>
 #include <ossia/dataflow/graph_node.hpp>
 #include <ossia/dataflow/port.hpp>
 
@@ -48,18 +49,21 @@ public:
 
       const auto* input = in[i].data();
       auto* output = out[i].data();
+      const auto g = ossia::audio_processing_sample(gain);
       if (cur_chan_size < last_pos)
       {
-        for (int64_t j = first_pos; j < cur_chan_size; j++)
-          output[j] = gain * input[j];
+        if (cur_chan_size > first_pos)
+          ossia::kernels::gain(
+              input + first_pos, output + first_pos, g,
+              cur_chan_size - first_pos);
 
         for (int64_t j = cur_chan_size; j < last_pos; j++)
           output[j] = 0.;
       }
-      else
+      else if (last_pos > first_pos)
       {
-        for (int64_t j = first_pos; j < last_pos; j++)
-          out[i][j] = gain * input[j];
+        ossia::kernels::gain(
+            input + first_pos, output + first_pos, g, last_pos - first_pos);
       }
     }
   }
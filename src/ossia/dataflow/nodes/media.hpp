@@ -6,8 +6,15 @@
 
 namespace ossia
 {
-// Used in nodes
-using audio_channel = ossia::small_pod_vector<double, 256>;
+// Used in nodes.
+// With OSSIA_AUDIO_FLOAT, the whole dataflow processes audio in single precision,
+// which is what the drivers, the sound files and Faust provide.
+#if defined(OSSIA_AUDIO_FLOAT)
+using audio_processing_sample = float;
+#else
+using audio_processing_sample = double;
+#endif
+using audio_channel = ossia::small_pod_vector<audio_processing_sample, 256>;
 using audio_vector = ossia::small_vector<audio_channel, 2>;
 
 
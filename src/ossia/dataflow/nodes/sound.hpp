@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <ossia/dataflow/audio_kernels.hpp>
 #include <ossia/dataflow/node_process.hpp>
 #include <ossia/dataflow/port.hpp>
 #include <ossia/detail/pod_vector.hpp>
@@ -63,99 +64,47 @@ constexpr audio_sample convert_sample<float, 32>(float i)
   return i;
 }
 
-inline void read_u8(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
+//! Reads interleaved frames of a sound file into the channels of ap
+inline void read_pcm(
+    kernels::pcm_format format, ossia::mutable_audio_span<float>& ap,
+    const void* data, int64_t samples)
 {
   const auto channels = ap.size();
-  auto d = reinterpret_cast<int8_t*>(data);
+  ossia::small_vector<float*, 8> dst(channels);
+  for (std::size_t i = 0; i < channels; i++)
+    dst[i] = ap[i].data();
 
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j]
-          = convert_sample<uint8_t, 8>(d[j * channels + i]);
-    }
-  }
+  kernels::decode_pcm(format, data, dst.data(), channels, samples);
 }
 
-inline void read_s16(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
+inline void read_u8(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
 {
-  const auto channels = ap.size();
-  auto d = reinterpret_cast<int16_t*>(data);
-
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j]
-          = convert_sample<int16_t, 16>(d[j * channels + i]);
-    }
-  }
+  read_pcm(kernels::pcm_format::u8, ap, data, samples);
 }
 
+inline void read_s16(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
+{
+  read_pcm(kernels::pcm_format::s16, ap, data, samples);
+}
 
 inline void read_s24(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
 {
-  const auto channels = ap.size();
-  const auto frame_bytes = channels * 3;
-
-  auto bytes = reinterpret_cast<uint8_t*>(data);
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      int32_t sample = 0;
-      sample += (bytes[3 * i] << 8);
-      sample += (bytes[3 * i + 1] << 16);
-      sample += (bytes[3 * i + 2] << 24);
-
-      ap[i][j]
-          = convert_sample<int32_t, 24>(sample);
-    }
-    bytes += frame_bytes;
-  }
+  read_pcm(kernels::pcm_format::s24, ap, data, samples);
 }
 
 inline void read_s32(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
 {
-  const auto channels = ap.size();
-  auto d = reinterpret_cast<int32_t*>(data);
-
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j] = convert_sample<int32_t, 32>(d[j * channels + i]);
-    }
-  }
+  read_pcm(kernels::pcm_format::s32, ap, data, samples);
 }
 
 inline void read_f32(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
 {
-  const auto channels = ap.size();
-  auto d = reinterpret_cast<float*>(data);
-
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j] = d[j * channels + i];
-    }
-  }
+  read_pcm(kernels::pcm_format::f32, ap, data, samples);
 }
 
 inline void read_f64(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples)
 {
-  const auto channels = ap.size();
-  auto d = reinterpret_cast<double*>(data);
-
-  for (int64_t j = 0; j < samples; j++)
-  {
-    for (std::size_t i = 0; i < channels; i++)
-    {
-      ap[i][j] = d[j * channels + i];
-    }
-  }
+  read_pcm(kernels::pcm_format::f64, ap, data, samples);
 }
 
 
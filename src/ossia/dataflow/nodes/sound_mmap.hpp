@@ -10,6 +10,48 @@
 
 #include <type_traits>
 
+namespace ossia::snd
+{
+using pcm_converter
+    = void (*)(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples);
+
+//! Gives the function converting the frames read from a file to float,
+//! or nullptr if its format is not supported.
+inline pcm_converter drwav_converter(const drwav_handle& hdl) noexcept
+{
+  switch(hdl.translatedFormatTag())
+  {
+    case DR_WAVE_FORMAT_PCM:
+    {
+      switch(hdl.bitsPerSample())
+      {
+        case 8:
+          return read_u8;
+        case 16:
+          return read_s16;
+        case 24:
+          return read_s24;
+        case 32:
+          return read_s32;
+      }
+      break;
+    }
+    case DR_WAVE_FORMAT_IEEE_FLOAT:
+    {
+      switch(hdl.bitsPerSample())
+      {
+        case 32:
+          return read_f32;
+        case 64:
+          return read_f64;
+      }
+      break;
+    }
+  }
+  return nullptr;
+}
+}
+
 namespace ossia::nodes
 {
 
@@ -37,49 +79,8 @@ public:
 
   void set_sound(drwav_handle hdl)
   {
-    using namespace snd;
     m_handle = std::move(hdl);
-    if(m_handle)
-    {
-      switch(m_handle.translatedFormatTag())
-      {
-        case DR_WAVE_FORMAT_PCM:
-        {
-          switch(m_handle.bitsPerSample())
-          {
-            case 8:
-              m_converter = read_u8;
-              break;
-            case 16:
-              m_converter = read_s16;
-              break;
-            case 24:
-              m_converter = read_s24;
-              break;
-            case 32:
-              m_converter = read_s32;
-              break;
-          }
-          break;
-        }
-        case DR_WAVE_FORMAT_IEEE_FLOAT:
-        {
-          switch(m_handle.bitsPerSample())
-          {
-            case 32:
-              m_converter = read_f32;
-              break;
-            case 64:
-              m_converter = read_f64;
-              break;
-          }
-          break;
-        }
-        default:
-          m_converter = nullptr;
-          break;
-      }
-    }
+    m_converter = m_handle ? snd::drwav_converter(m_handle) : nullptr;
   }
 
   void transport(time_value date) override
@@ -355,8 +356,7 @@ private:
   std::size_t start{};
   std::size_t upmix{};
 
-  using read_fn_t = void(*)(ossia::mutable_audio_span<float>& ap, void* data, int64_t samples);
-  read_fn_t m_converter{};
+  snd::pcm_converter m_converter{};
   std::vector<double> m_safetyBuffer;
   std::vector<std::vector<float>> m_resampleBuffer;
 };
@@ -0,0 +1,359 @@
+#include <ossia/dataflow/nodes/sound_stream.hpp>
+#include <ossia/detail/algorithms.hpp>
+
+namespace ossia
+{
+// Frames decoded at once, and at most for one voice before going to the next
+static constexpr int64_t decode_frames = 4096;
+static constexpr int64_t refill_frames = 4 * decode_frames;
+
+sound_stream_voice::sound_stream_voice(
+    drwav_handle hdl, snd::pcm_converter converter, std::size_t frames)
+    : m_handle{std::move(hdl)}
+    , m_converter{converter}
+    , m_ring(m_handle.channels())
+    , m_capacity{std::max(int64_t(frames), decode_frames)}
+{
+  for(auto& chan : m_ring)
+    chan.resize(m_capacity);
+  m_scratch.resize(decode_frames * m_ring.size());
+}
+
+sound_stream_voice::~sound_stream_voice() = default;
+
+void sound_stream_voice::seek(
+    int64_t pos, const sound_stream_loop& loop) noexcept
+{
+  // e.g. transport() to where the node already is
+  if(pos == m_read_pos && loop == m_loop)
+    return;
+
+  m_read_pos = pos;
+  m_loop = loop;
+  m_loop_offset.store(loop.offset, std::memory_order_relaxed);
+  m_loop_duration.store(loop.duration, std::memory_order_relaxed);
+  m_loops.store(loop.loops, std::memory_order_relaxed);
+  m_read.store(pos, std::memory_order_relaxed);
+  m_requested.store(++m_generation, std::memory_order_release);
+}
+
+void sound_stream_voice::update_loop(const sound_stream_loop& loop) noexcept
+{
+  // The worker may have decoded up to a capacity past the read position.
+  // Those frames are still valid if the loop did not wrap around yet
+  // with either the old or the new settings: e.g. when the loop is set
+  // at the first tick, after the start of the prefetching.
+  const int64_t end = m_read_pos + m_capacity;
+  const auto first_iteration = [end](const sound_stream_loop& l) {
+    return !l.loops || l.duration <= 0 || end <= l.duration;
+  };
+
+  if(loop.offset == m_loop.offset && first_iteration(loop)
+     && first_iteration(m_loop))
+  {
+    m_loop = loop;
+    m_loop_offset.store(loop.offset, std::memory_order_relaxed);
+    m_loop_duration.store(loop.duration, std::memory_order_relaxed);
+    m_loops.store(loop.loops, std::memory_order_relaxed);
+  }
+  else
+  {
+    seek(m_read_pos, loop);
+  }
+}
+
+bool sound_stream_voice::refill() noexcept
+{
+  const auto generation = m_requested.load(std::memory_order_acquire);
+  const int64_t read = m_read.load(std::memory_order_acquire);
+
+  // Loaded after the read position: see update_loop
+  sound_stream_loop loop{
+      m_loop_offset.load(std::memory_order_relaxed),
+      m_loop_duration.load(std::memory_order_relaxed),
+      m_loops.load(std::memory_order_relaxed)};
+  if(loop.duration <= 0)
+    loop.loops = false;
+
+  if(generation != m_produced)
+  {
+    m_produced = generation;
+    m_write_pos = read;
+    m_written.store(read, std::memory_order_relaxed);
+    m_written_generation.store(generation, std::memory_order_release);
+  }
+  else if(m_write_pos < read)
+  {
+    // The audio thread went past the decoded frames
+    m_write_pos = read;
+  }
+
+  const int64_t end = read + m_capacity;
+  int64_t budget = refill_frames;
+  while(m_write_pos < end && budget > 0)
+  {
+    if(m_requested.load(std::memory_order_relaxed) != generation)
+      return true;
+
+    int64_t frames = std::min(
+        {end - m_write_pos, budget, decode_frames,
+         m_capacity - m_write_pos % m_capacity});
+
+    int64_t file_pos = loop.offset + m_write_pos;
+    if(loop.loops)
+    {
+      const int64_t in_loop = m_write_pos % loop.duration;
+      file_pos = loop.offset + in_loop;
+      frames = std::min(frames, loop.duration - in_loop);
+    }
+
+    decode(m_write_pos % m_capacity, file_pos, frames);
+    m_write_pos += frames;
+    budget -= frames;
+    m_written.store(m_write_pos, std::memory_order_release);
+  }
+
+  return m_write_pos < end;
+}
+
+void sound_stream_voice::decode(
+    int64_t slot, int64_t file_pos, int64_t frames) noexcept
+{
+  const std::size_t channels = m_ring.size();
+  const int64_t total = m_handle.totalPCMFrameCount();
+
+  int64_t count = 0;
+  if(file_pos >= 0 && file_pos < total)
+  {
+    if(file_pos == m_file_pos || m_handle.seek_to_pcm_frame(file_pos))
+    {
+      count = m_handle.read_pcm_frames(
+          std::min(frames, total - file_pos), m_scratch.data());
+
+      ossia::mutable_audio_span<float> dst(channels);
+      for(std::size_t c = 0; c < channels; c++)
+        dst[c] = gsl::span<float>(m_ring[c].data() + slot, count);
+      m_converter(dst, m_scratch.data(), count);
+      m_file_pos = file_pos + count;
+    }
+    else
+    {
+      m_file_pos = -1;
+    }
+  }
+
+  // Out of the file
+  for(std::size_t c = 0; c < channels; c++)
+    std::fill_n(m_ring[c].data() + slot + count, frames - count, 0.f);
+}
+
+int64_t sound_stream_voice::buffered() const noexcept
+{
+  if(m_written_generation.load(std::memory_order_acquire)
+     != m_requested.load(std::memory_order_acquire))
+    return 0;
+
+  return std::max(
+      m_written.load(std::memory_order_acquire)
+          - m_read.load(std::memory_order_acquire),
+      int64_t(0));
+}
+
+sound_stream_pool::sound_stream_pool(int workers)
+{
+  for(int i = 0; i < workers; i++)
+    m_threads.emplace_back([this] { work(); });
+}
+
+sound_stream_pool::~sound_stream_pool()
+{
+  {
+    std::lock_guard lck{m_mutex};
+    m_running = false;
+  }
+  m_cv.notify_all();
+
+  for(auto& t : m_threads)
+    t.join();
+}
+
+std::shared_ptr<sound_stream_pool> sound_stream_pool::default_pool()
+{
+  static std::mutex mutex;
+  static std::weak_ptr<sound_stream_pool> pool;
+
+  std::lock_guard lck{mutex};
+  auto p = pool.lock();
+  if(!p)
+  {
+    const int workers
+        = std::clamp(int(std::thread::hardware_concurrency()) / 2, 1, 4);
+    p = std::make_shared<sound_stream_pool>(workers);
+    pool = p;
+  }
+  return p;
+}
+
+void sound_stream_pool::add(std::shared_ptr<sound_stream_voice> v)
+{
+  {
+    std::lock_guard lck{m_mutex};
+    m_voices.push_back(std::move(v));
+  }
+  m_cv.notify_all();
+}
+
+void sound_stream_pool::remove(const std::shared_ptr<sound_stream_voice>& v)
+{
+  {
+    std::lock_guard lck{m_mutex};
+    ossia::remove_erase(m_voices, v);
+  }
+
+  // Taken for good: the workers which still see the voice will skip it.
+  while(v->m_busy.test_and_set(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+void sound_stream_pool::work()
+{
+  std::vector<std::shared_ptr<sound_stream_voice>> voices;
+
+  std::unique_lock lck{m_mutex};
+  while(m_running)
+  {
+    voices = m_voices;
+    lck.unlock();
+
+    bool pending = false;
+    for(auto& v : voices)
+    {
+      if(!v->m_busy.test_and_set(std::memory_order_acquire))
+      {
+        pending |= v->refill();
+        v->m_busy.clear(std::memory_order_release);
+      }
+    }
+    voices.clear();
+
+    lck.lock();
+    // The audio thread does not signal the workers, so that it never
+    // makes system calls: idle workers check the voices periodically.
+    if(!pending && m_running)
+      m_cv.wait_for(lck, std::chrono::milliseconds(1));
+  }
+}
+
+namespace nodes
+{
+sound_stream::sound_stream(std::shared_ptr<sound_stream_pool> pool)
+    : m_pool{std::move(pool)}
+{
+  m_outlets.push_back(&audio_out);
+}
+
+sound_stream::~sound_stream()
+{
+  if(m_voice)
+    m_pool->remove(m_voice);
+}
+
+void sound_stream::set_sound(drwav_handle hdl)
+{
+  if(m_voice)
+  {
+    m_pool->remove(m_voice);
+    m_voice.reset();
+  }
+
+  m_handle = std::move(hdl);
+  if(!m_handle)
+    return;
+
+  if(auto converter = snd::drwav_converter(m_handle))
+  {
+    m_voice = std::make_shared<sound_stream_voice>(
+        m_handle, converter, m_buffer_frames);
+    m_pool->add(m_voice);
+  }
+}
+
+void sound_stream::transport(time_value date)
+{
+  if(!m_handle)
+    return;
+
+  const auto pos = to_sample(date, m_handle.sampleRate());
+  m_resampler.transport(pos);
+
+  // Start prefetching from there before the next tick
+  if(m_voice)
+    m_voice->seek(pos, loop());
+}
+
+void sound_stream::run(
+    const ossia::token_request& t, ossia::exec_state_facade e) noexcept
+{
+  if(!m_voice)
+    return;
+
+  // TODO do the backwards play head
+  if(!t.forward())
+    return;
+
+  const auto channels = m_handle.channels();
+  const auto len = m_handle.totalPCMFrameCount();
+
+  ossia::audio_port& ap = *audio_out;
+  ap.samples.resize(channels);
+
+  const auto [samples_to_read, samples_to_write]
+      = snd::sample_info(e.bufferSize(), e.modelToSamples(), t);
+  if(samples_to_write <= 0)
+    return;
+
+  const auto samples_offset = t.physical_start(e.modelToSamples());
+  if(t.tempo > 0)
+  {
+    if(t.prev_date < m_prev_date)
+    {
+      // Sentinel: we never played.
+      if(m_prev_date == ossia::time_value{ossia::time_value::infinite_min})
+      {
+        if(t.prev_date != 0_tv)
+          transport(t.prev_date);
+        else
+          m_prev_date = 0_tv;
+      }
+      else
+      {
+        transport(t.prev_date);
+      }
+    }
+
+    for(std::size_t chan = 0; chan < channels; chan++)
+    {
+      ap.samples[chan].resize(e.bufferSize());
+    }
+
+    double stretch_ratio = update_stretch(t, e);
+
+    m_resampler.run(
+        *this, t, e, stretch_ratio, channels, len, samples_to_read,
+        samples_to_write, samples_offset, ap);
+
+    for(std::size_t chan = 0; chan < channels; chan++)
+    {
+      snd::do_fade(
+          t.start_discontinuous, t.end_discontinuous, ap.samples[chan],
+          samples_offset, samples_to_write);
+    }
+
+    ossia::snd::perform_upmix(this->upmix, channels, ap);
+    ossia::snd::perform_start_offset(this->start, ap);
+
+    m_prev_date = t.date;
+  }
+}
+}
+}
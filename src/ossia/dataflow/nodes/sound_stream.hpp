@@ -0,0 +1,280 @@
+#pragma once
+#include <ossia/dataflow/nodes/sound_mmap.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ossia
+{
+//! How the play positions of a streamed sound map to frames of the file
+struct sound_stream_loop
+{
+  int64_t offset{};
+  int64_t duration{};
+  bool loops{};
+
+  bool operator==(const sound_stream_loop& other) const noexcept
+  {
+    return offset == other.offset && duration == other.duration
+           && loops == other.loops;
+  }
+  bool operator!=(const sound_stream_loop& other) const noexcept
+  {
+    return !(*this == other);
+  }
+};
+
+/**
+ * @brief Decodes a sound file ahead of the play head of a streaming node.
+ *
+ * The audio thread and one worker of a sound_stream_pool share a ring of
+ * deinterleaved frames, indexed by play position, i.e. before applying the
+ * loop and start offset. The audio thread only copies contiguous blocks out
+ * of it: when the frames it needs are not decoded yet, after a seek or
+ * because the disk is too slow, it outputs silence for them, counts an
+ * underrun, and the worker continues from where it will read next.
+ *
+ * Only one worker at a time refills a given voice.
+ */
+class OSSIA_EXPORT sound_stream_voice
+{
+public:
+  sound_stream_voice(
+      drwav_handle hdl, snd::pcm_converter converter, std::size_t frames);
+  ~sound_stream_voice();
+
+  sound_stream_voice(const sound_stream_voice&) = delete;
+  sound_stream_voice& operator=(const sound_stream_voice&) = delete;
+
+  //! Audio thread: copies the frames at [pos, pos + frames) to each channel.
+  //! Returns false if some were missing and replaced by silence.
+  template <typename T>
+  bool read(
+      int64_t pos, int64_t frames, const sound_stream_loop& loop,
+      T** out) noexcept;
+
+  //! Audio thread: starts prefetching from another position.
+  void seek(int64_t pos, const sound_stream_loop& loop) noexcept;
+
+  //! Worker: decodes the next frames. Returns true if there is more to do.
+  bool refill() noexcept;
+
+  //! Frames decoded ahead of the read position
+  int64_t buffered() const noexcept;
+
+  //! Number of reads which had to output silence
+  uint64_t underruns() const noexcept
+  {
+    return m_underruns.load(std::memory_order_relaxed);
+  }
+
+  //! Number of frames replaced by silence
+  uint64_t missing_frames() const noexcept
+  {
+    return m_missing_frames.load(std::memory_order_relaxed);
+  }
+
+  std::size_t channels() const noexcept { return m_ring.size(); }
+
+private:
+  friend class sound_stream_pool;
+
+  void update_loop(const sound_stream_loop& loop) noexcept;
+  void decode(int64_t slot, int64_t file_pos, int64_t frames) noexcept;
+
+  drwav_handle m_handle;
+  snd::pcm_converter m_converter{};
+  std::vector<ossia::float_vector> m_ring;
+  const int64_t m_capacity{};
+
+  // Written by the audio thread
+  int64_t m_read_pos{};
+  sound_stream_loop m_loop{};
+  uint32_t m_generation{1};
+  std::atomic<int64_t> m_read{};
+  std::atomic<uint32_t> m_requested{1};
+  std::atomic<int64_t> m_loop_offset{};
+  std::atomic<int64_t> m_loop_duration{};
+  std::atomic_bool m_loops{};
+  std::atomic<uint64_t> m_underruns{};
+  std::atomic<uint64_t> m_missing_frames{};
+
+  // Written by the worker
+  std::atomic<int64_t> m_written{};
+  std::atomic<uint32_t> m_written_generation{};
+  int64_t m_write_pos{};
+  int64_t m_file_pos{-1};
+  uint32_t m_produced{};
+  ossia::double_vector m_scratch;
+
+  // Held by the worker refilling the voice
+  std::atomic_flag m_busy = ATOMIC_FLAG_INIT;
+};
+
+/**
+ * @brief Threads decoding the sound_stream_voice added to them.
+ *
+ * Each worker goes through the voices in turn and decodes a bounded amount of
+ * frames for each, so that a long seek does not starve the other voices.
+ */
+class OSSIA_EXPORT sound_stream_pool
+{
+public:
+  explicit sound_stream_pool(int workers);
+  ~sound_stream_pool();
+
+  //! Pool shared by the streaming nodes which are not given one
+  static std::shared_ptr<sound_stream_pool> default_pool();
+
+  void add(std::shared_ptr<sound_stream_voice> v);
+
+  //! Once this returns, no worker uses the voice anymore.
+  void remove(const std::shared_ptr<sound_stream_voice>& v);
+
+private:
+  void work();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<std::shared_ptr<sound_stream_voice>> m_voices;
+  std::vector<std::thread> m_threads;
+  bool m_running{true};
+};
+
+template <typename T>
+bool sound_stream_voice::read(
+    int64_t pos, int64_t frames, const sound_stream_loop& loop,
+    T** out) noexcept
+{
+  if(pos != m_read_pos)
+    seek(pos, loop);
+  else if(loop != m_loop)
+    update_loop(loop);
+
+  const std::size_t channels = m_ring.size();
+  int64_t available = 0;
+  if(m_written_generation.load(std::memory_order_acquire) == m_generation)
+  {
+    available = std::clamp(
+        m_written.load(std::memory_order_acquire) - pos, int64_t(0), frames);
+
+    // At most two contiguous blocks, as the ring wraps around
+    const int64_t slot = pos % m_capacity;
+    const int64_t first = std::min(available, m_capacity - slot);
+    for(std::size_t c = 0; c < channels; c++)
+    {
+      const float* src = m_ring[c].data();
+      std::copy_n(src + slot, first, out[c]);
+      std::copy_n(src, available - first, out[c] + first);
+    }
+  }
+
+  if(available < frames)
+  {
+    for(std::size_t c = 0; c < channels; c++)
+      std::fill_n(out[c] + available, frames - available, T{});
+    m_underruns.fetch_add(1, std::memory_order_relaxed);
+    m_missing_frames.fetch_add(frames - available, std::memory_order_relaxed);
+  }
+
+  m_read_pos = pos + frames;
+  m_read.store(m_read_pos, std::memory_order_release);
+  return available == frames;
+}
+
+namespace nodes
+{
+/**
+ * @brief Plays a sound file decoded ahead of time by a sound_stream_pool.
+ *
+ * Unlike sound_mmap, the audio thread never seeks nor decodes in the file:
+ * it copies the frames prefetched in a ring by the workers, so that cold
+ * pages of the file and the looping of many sounds do not stall it.
+ */
+class OSSIA_EXPORT sound_stream final : public ossia::sound_node
+{
+public:
+  explicit sound_stream(
+      std::shared_ptr<sound_stream_pool> pool
+      = sound_stream_pool::default_pool());
+  ~sound_stream();
+
+  std::string label() const noexcept override
+  {
+    return "sound_stream";
+  }
+
+  void set_start(std::size_t v)
+  {
+    start = v;
+  }
+
+  void set_upmix(std::size_t v)
+  {
+    upmix = v;
+  }
+
+  //! Frames decoded ahead of the play head, for the sounds set afterwards
+  void set_buffer_frames(std::size_t v)
+  {
+    m_buffer_frames = v;
+  }
+
+  void set_sound(drwav_handle hdl);
+
+  void transport(time_value date) override;
+
+  template <typename T>
+  void fetch_audio(int64_t start, int64_t samples_to_write, T** audio_array) noexcept
+  {
+    m_voice->read(start, samples_to_write, loop(), audio_array);
+  }
+
+  void
+  run(const ossia::token_request& t, ossia::exec_state_facade e) noexcept override;
+
+  std::size_t channels() const
+  {
+    return m_handle ? m_handle.channels() : 0;
+  }
+  std::size_t duration() const
+  {
+    return m_handle ? m_handle.totalPCMFrameCount() : 0;
+  }
+
+  int64_t buffered() const noexcept
+  {
+    return m_voice ? m_voice->buffered() : 0;
+  }
+  uint64_t underruns() const noexcept
+  {
+    return m_voice ? m_voice->underruns() : 0;
+  }
+  uint64_t missing_frames() const noexcept
+  {
+    return m_voice ? m_voice->missing_frames() : 0;
+  }
+
+private:
+  sound_stream_loop loop() const noexcept
+  {
+    return {m_start_offset_samples, m_loop_duration_samples, m_loops};
+  }
+
+  std::shared_ptr<sound_stream_pool> m_pool;
+  std::shared_ptr<sound_stream_voice> m_voice;
+  drwav_handle m_handle{};
+
+  ossia::audio_outlet audio_out;
+
+  std::size_t start{};
+  std::size_t upmix{};
+  std::size_t m_buffer_frames{32768};
+};
+}
+}
@@ -60,7 +60,11 @@ struct rubberband_stretcher
       for(std::size_t i = 0; i < chan; i++)
       {
         input[i] =  (float*) alloca(sizeof(float) * std::max((int64_t)16, samples_to_read));
-        output[i] = (float*) alloca(sizeof(float) * samples_to_write);
+        // In single precision, rubberband writes in the port directly
+        if constexpr (std::is_same_v<audio_processing_sample, float>)
+          output[i] = ap.samples[i].data() + samples_offset;
+        else
+          output[i] = (float*) alloca(sizeof(float) * samples_to_write);
       }
 
       while (m_rubberBand->available() < samples_to_write)
@@ -75,11 +79,14 @@ struct rubberband_stretcher
 
       m_rubberBand->retrieve(output, std::min((int)samples_to_write, m_rubberBand->available()));
 
-      for (std::size_t i = 0; i < chan; i++)
+      if constexpr (!std::is_same_v<audio_processing_sample, float>)
       {
-        for (int64_t j = 0; j < samples_to_write; j++)
+        for (std::size_t i = 0; i < chan; i++)
         {
-          ap.samples[i][j + samples_offset] = double(output[i][j]);
+          for (int64_t j = 0; j < samples_to_write; j++)
+          {
+            ap.samples[i][j + samples_offset] = audio_processing_sample(output[i][j]);
+          }
         }
       }
     }
@@ -2,11 +2,14 @@
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include <ossia/audio/audio_parameter.hpp>
+#include <ossia/dataflow/audio_kernels.hpp>
 #include <ossia/dataflow/dataflow.hpp>
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/port.hpp>
 #include <ossia/network/value/destination.hpp>
 
+#include <cmath>
+
 namespace ossia
 {
 
@@ -139,7 +142,7 @@ struct outlet_inserter
 void outlet::write(execution_state& e)
 {
   apply_to_destination(
-      address, e.exec_devices(),
+      address, e.exec_devices(), address_cache, e.tree_version(),
       [&](ossia::net::parameter_base* addr, bool unique) {
         if (unique)
         {
@@ -197,28 +200,157 @@ texture_outlet::~texture_outlet()
 }
 
 
-void audio_outlet::post_process()
+namespace
+{
+void read_pan(const ossia::value& v, pan_weight& pan)
+{
+  if(auto list = v.target<std::vector<ossia::value>>())
+  {
+    pan.clear();
+    for(const auto& weight : *list)
+      pan.push_back(ossia::convert<float>(weight));
+  }
+  else
+  {
+    // Stereo balance: the louder side stays at unity
+    const double balance = ossia::clamp(ossia::convert<float>(v), -1.f, 1.f);
+    pan.resize(2);
+    pan[0] = std::min(1., 1. - balance);
+    pan[1] = std::min(1., 1. + balance);
+  }
+}
+}
+
+void audio_outlet::update_targets() noexcept
 {
-  // TODO do that better in a sample accurate way
-  if(auto& gain_msg = std::as_const(gain_inlet).data.get_data(); !gain_msg.empty())
-    gain = ossia::convert<float>(gain_msg.back().value);
+  const auto C = data.samples.size();
+  while(pan.size() < C)
+    pan.push_back(1.);
 
-  // TODO pan
-  switch(data.samples.size())
+  for(std::size_t chan = 0; chan < C; chan++)
   {
-  case 0:
+    auto& r = m_ramps[chan];
+    // A mono outlet is not panned
+    const double target = C == 1 ? gain : gain * pan[chan];
+    if(target == r.target)
+      continue;
+
+    r.target = target;
+    switch(smoothing)
+    {
+      case no_smoothing:
+        r.current = target;
+        r.remaining = 0;
+        break;
+      case linear_smoothing:
+        r.remaining = std::max(smoothing_samples, int64_t(1));
+        r.step = (target - r.current) / r.remaining;
+        break;
+      case exponential_smoothing:
+        break;
+    }
+  }
+}
+
+void audio_outlet::render(std::size_t from, std::size_t to) noexcept
+{
+  if(from >= to)
     return;
 
-  case 1:
-    process_audio_out_mono(*this);
-    break;
+  const auto len = int64_t(to - from);
+  for(std::size_t chan = 0, C = data.samples.size(); chan < C; chan++)
+  {
+    auto& r = m_ramps[chan];
+    auto& samples = data.samples[chan];
+
+    // The ramps advance even on the part of the buffer that a shorter channel lacks
+    const auto available = int64_t(std::min(samples.size(), to)) - int64_t(from);
+    auto ptr = samples.data() + from;
+    int64_t done = 0;
 
-  default:
-    process_audio_out_general(*this);
-    break;
+    if(r.current != r.target)
+    {
+      if(smoothing == exponential_smoothing)
+      {
+        const double delta = (r.current - r.target) * m_ratio;
+        if(available > 0)
+          kernels::gain_curve(ptr, ptr, r.target, delta, m_ratio, available);
+
+        const double end_delta = delta * std::pow(m_ratio, len - 1);
+        // Done under -100 dB
+        r.current = std::abs(end_delta) < 1e-5 ? r.target : r.target + end_delta;
+        continue;
+      }
+      else if(r.remaining > 0)
+      {
+        done = std::min(r.remaining, len);
+        const auto count = std::min(done, available);
+        if(count > 0)
+          kernels::gain_ramp(ptr, ptr, r.current + r.step, r.step, count);
+
+        r.remaining -= done;
+        r.current = r.remaining > 0 ? r.current + r.step * done : r.target;
+      }
+      else
+      {
+        r.current = r.target;
+      }
+    }
+
+    if(r.current != 1. && available > done)
+      kernels::gain(ptr + done, ptr + done, r.current, available - done);
   }
 }
 
+void audio_outlet::post_process()
+{
+  const auto C = data.samples.size();
+  if(m_ramps.size() < C)
+  {
+    // New channels start at their weight, without ramp
+    const auto prev = m_ramps.size();
+    m_ramps.resize(C);
+    for(std::size_t chan = prev; chan < C; chan++)
+    {
+      auto& r = m_ramps[chan];
+      r.current = r.target = C == 1 ? gain : gain * (chan < pan.size() ? pan[chan] : 1.);
+    }
+  }
+  if(smoothing == exponential_smoothing)
+    m_ratio = std::exp(-1. / std::max(smoothing_samples, int64_t(1)));
+
+  std::size_t frames = 0;
+  for(const auto& chan : data.samples)
+    frames = std::max(frames, chan.size());
+
+  update_targets();
+
+  // Apply the changes of gain and pan in the order of their timestamps
+  const auto& gain_msg = std::as_const(gain_inlet).data.get_data();
+  const auto& pan_msg = std::as_const(pan_inlet).data.get_data();
+  auto g = gain_msg.begin();
+  auto p = pan_msg.begin();
+  std::size_t pos = 0;
+  while(g != gain_msg.end() || p != pan_msg.end())
+  {
+    const bool is_gain
+        = p == pan_msg.end()
+          || (g != gain_msg.end() && g->timestamp <= p->timestamp);
+    const ossia::timed_value& msg = is_gain ? *g++ : *p++;
+
+    const auto ts = std::size_t(ossia::clamp(msg.timestamp, int64_t(pos), int64_t(frames)));
+    render(pos, ts);
+    pos = ts;
+
+    if(is_gain)
+      gain = ossia::convert<float>(msg.value);
+    else
+      read_pan(msg.value, pan);
+    update_targets();
+  }
+  render(pos, frames);
+}
+
 midi_inlet::~midi_inlet()
 {
 
@@ -232,25 +364,18 @@ midi_outlet::~midi_outlet()
 void process_audio_out_mono(ossia::audio_port& i, ossia::audio_outlet& audio_out)
 {
   ossia::audio_port& o = *audio_out;
-  const double g = audio_out.gain;
+  const auto g = audio_processing_sample(audio_out.gain);
 
   ensure_vector_sizes(i.samples, audio_out.data.samples);
 
-  const auto N = i.samples[0].size();
-  const auto i_ptr = i.samples[0].data();
-  const auto o_ptr  = o.samples[0].data();
-
-  for(std::size_t sample = 0; sample < N; sample++)
-  {
-    o_ptr[sample] = i_ptr[sample] * g;
-  }
+  kernels::gain(i.samples[0].data(), o.samples[0].data(), g, i.samples[0].size());
 }
 
 void process_audio_out_general(ossia::audio_port& i, ossia::audio_outlet& audio_out)
 {
   const auto C = i.samples.size();
   ossia::audio_port& o = *audio_out;
-  const double g = audio_out.gain;
+  const auto g = audio_processing_sample(audio_out.gain);
 
   while(audio_out.pan.size() < C)
     audio_out.pan.push_back(1.);
@@ -264,21 +389,11 @@ void process_audio_out_general(ossia::audio_port& i, ossia::audio_outlet& audio_
     auto i_ptr = i.samples[chan].data();
     auto o_ptr  = o.samples[chan].data();
 
-    const auto vol = audio_out.pan[chan] * g;
+    const auto vol = audio_processing_sample(audio_out.pan[chan]) * g;
     if(vol == 1.)
-    {
-      for(std::size_t sample = 0; sample < N; sample++)
-      {
-        o_ptr[sample] = i_ptr[sample];
-      }
-    }
+      std::copy_n(i_ptr, N, o_ptr);
     else
-    {
-      for(std::size_t sample = 0; sample < N; sample++)
-      {
-        o_ptr[sample] = i_ptr[sample] * vol;
-      }
-    }
+      kernels::gain(i_ptr, o_ptr, vol, N);
   }
 }
 
@@ -286,24 +401,18 @@ void process_audio_out_mono(ossia::audio_outlet& audio_out)
 {
   ossia::audio_port& o = *audio_out;
 
-  const double g = audio_out.gain;
+  const auto g = audio_processing_sample(audio_out.gain);
   if(g == 1.)
     return;
 
-  const auto N = o.samples[0].size();
-  const auto o_ptr  = o.samples[0].data();
-
-  for(std::size_t sample = 0; sample < N; sample++)
-  {
-    o_ptr[sample] *= g;
-  }
+  kernels::gain(o.samples[0].data(), o.samples[0].data(), g, o.samples[0].size());
 }
 
 void process_audio_out_general(ossia::audio_outlet& audio_out)
 {
   ossia::audio_port& o = *audio_out;
   const auto C = o.samples.size();
-  const double g = audio_out.gain;
+  const auto g = audio_processing_sample(audio_out.gain);
 
   while(audio_out.pan.size() < C)
     audio_out.pan.push_back(1.);
@@ -314,13 +423,10 @@ void process_audio_out_general(ossia::audio_outlet& audio_out)
 
     auto o_ptr  = o.samples[chan].data();
 
-    const auto vol = audio_out.pan[chan] * g;
+    const auto vol = audio_processing_sample(audio_out.pan[chan]) * g;
     if(vol == 1.)
       continue;
-    for(std::size_t sample = 0; sample < N; sample++)
-    {
-      o_ptr[sample] *= vol;
-    }
+    kernels::gain(o_ptr, o_ptr, vol, N);
   }
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/dataflow/dataflow.hpp>
 #include <ossia/dataflow/dataflow_fwd.hpp>
 #include <ossia/dataflow/value_port.hpp>
 #include <ossia/dataflow/audio_port.hpp>
@@ -86,6 +87,7 @@ public:
   virtual void post_process();
 
   destination_t address;
+  destination_cache address_cache;
   ossia::small_vector<graph_edge*, 2> sources;
   ossia::small_vector<value_inlet*, 2> child_inlets;
 
@@ -152,6 +154,7 @@ public:
   auto& cables() const noexcept { return targets; }
 
   destination_t address;
+  destination_cache address_cache;
   ossia::small_vector<graph_edge*, 2> targets;
   ossia::small_vector<value_inlet*, 2> child_inlets;
 
@@ -302,10 +305,22 @@ struct OSSIA_EXPORT audio_outlet : public ossia::outlet
 
   std::size_t which() const noexcept final override { return audio_port::which; }
 
+  //! Applies the gain and pan changes received on gain_inlet and pan_inlet
+  //! at their timestamps in the buffer.
+  //! The pan is either a list of per-channel weights, or a stereo balance in [-1; 1].
   void post_process() override;
 
+  enum smoothing_mode : int8_t
+  {
+    no_smoothing,
+    linear_smoothing,     //!< Ramps over smoothing_samples
+    exponential_smoothing //!< Time constant of smoothing_samples
+  };
+
   double gain{1.};
   pan_weight pan{1., 1.};
+  smoothing_mode smoothing{no_smoothing};
+  int64_t smoothing_samples{64};
 
   ossia::value_inlet gain_inlet;
   ossia::value_inlet pan_inlet;
@@ -320,6 +335,20 @@ private:
     this->child_inlets[0] = &gain_inlet;
     this->child_inlets[1] = &pan_inlet;
   }
+
+  void update_targets() noexcept;
+  void render(std::size_t from, std::size_t to) noexcept;
+
+  // Weight applied to each channel, moving towards gain * pan
+  struct ramp
+  {
+    double current{1.};
+    double target{1.};
+    double step{};
+    int64_t remaining{};
+  };
+  ossia::small_vector<ramp, 2> m_ramps;
+  double m_ratio{};
 };
 
 #if BOOST_VERSION >= 107200
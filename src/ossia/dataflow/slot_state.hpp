@@ -0,0 +1,160 @@
+#pragma once
+#include <ossia/detail/hash_map.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ossia
+{
+/**
+ * @brief State of a tick for each parameter written by the graph.
+ *
+ * Each parameter gets a dense slot the first time it is seen, usually when
+ * its ports are registered, and its data is stored contiguously by slot.
+ * The slots written since the last call to clear_touched() are tracked:
+ * iteration, size() and empty() only consider them, so that a commit does not
+ * walk over all the parameters which did not receive anything.
+ *
+ * Iterating yields std::pair<Key*, T>&, like a map from parameters to data.
+ * Slots are never released: the data of a parameter which is not written
+ * anymore stays allocated until the state is destroyed.
+ */
+template <typename Key, typename T>
+class slot_state
+{
+public:
+  using value_type = std::pair<Key*, T>;
+
+  template <typename Entries, typename Value>
+  class iterator_impl
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = slot_state::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    iterator_impl(Entries& entries, const int32_t* touched) noexcept
+        : m_entries{&entries}, m_touched{touched}
+    {
+    }
+
+    //! The slot of the current entry
+    int32_t slot() const noexcept { return *m_touched; }
+
+    reference operator*() const noexcept { return (*m_entries)[*m_touched]; }
+    pointer operator->() const noexcept { return &(*m_entries)[*m_touched]; }
+    iterator_impl& operator++() noexcept
+    {
+      ++m_touched;
+      return *this;
+    }
+    iterator_impl operator++(int) noexcept
+    {
+      auto it = *this;
+      ++m_touched;
+      return it;
+    }
+
+    friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs) noexcept
+    {
+      return lhs.m_touched == rhs.m_touched;
+    }
+    friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs) noexcept
+    {
+      return lhs.m_touched != rhs.m_touched;
+    }
+
+  private:
+    Entries* m_entries{};
+    const int32_t* m_touched{};
+  };
+
+  using iterator = iterator_impl<std::vector<value_type>, value_type>;
+  using const_iterator
+      = iterator_impl<const std::vector<value_type>, const value_type>;
+
+  void reserve(std::size_t n)
+  {
+    m_slots.reserve(n);
+    m_entries.reserve(n);
+    m_touched_flags.reserve(n);
+    m_touched.reserve(n);
+  }
+
+  //! The slot of the key, allocated on the first call
+  int32_t slot(Key* key)
+  {
+    auto it = m_slots.find(key);
+    if (it != m_slots.end())
+      return it->second;
+
+    const auto slot = int32_t(m_entries.size());
+    m_slots.emplace(key, slot);
+    m_entries.emplace_back(key, T{});
+    m_touched_flags.push_back(false);
+    return slot;
+  }
+
+  //! The data of the key, which is marked as written for this tick
+  T& operator[](Key* key) { return touch(slot(key)); }
+
+  T& touch(int32_t slot)
+  {
+    if (!m_touched_flags[slot])
+    {
+      m_touched_flags[slot] = true;
+      m_touched.push_back(slot);
+    }
+    return m_entries[slot].second;
+  }
+
+  //! The data of the key if it has a slot, whether it was written or not
+  T* find(const Key* key) noexcept
+  {
+    auto it = m_slots.find(const_cast<Key*>(key));
+    return it != m_slots.end() ? &m_entries[it->second].second : nullptr;
+  }
+  const T* find(const Key* key) const noexcept
+  {
+    auto it = m_slots.find(const_cast<Key*>(key));
+    return it != m_slots.end() ? &m_entries[it->second].second : nullptr;
+  }
+
+  //! Forgets which slots were written. Their data is left as is.
+  void clear_touched() noexcept
+  {
+    for (auto slot : m_touched)
+      m_touched_flags[slot] = false;
+    m_touched.clear();
+  }
+
+  std::size_t slot_count() const noexcept { return m_entries.size(); }
+
+  std::size_t size() const noexcept { return m_touched.size(); }
+  bool empty() const noexcept { return m_touched.empty(); }
+
+  iterator begin() noexcept { return {m_entries, m_touched.data()}; }
+  iterator end() noexcept
+  {
+    return {m_entries, m_touched.data() + m_touched.size()};
+  }
+  const_iterator begin() const noexcept
+  {
+    return {m_entries, m_touched.data()};
+  }
+  const_iterator end() const noexcept
+  {
+    return {m_entries, m_touched.data() + m_touched.size()};
+  }
+
+private:
+  ossia::fast_hash_map<Key*, int32_t> m_slots;
+  std::vector<value_type> m_entries;
+  std::vector<bool> m_touched_flags;
+  std::vector<int32_t> m_touched;
+};
+}
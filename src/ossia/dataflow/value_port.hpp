@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/dataflow/delay_ring.hpp>
 #include <ossia/dataflow/timed_value.hpp>
 #include <ossia/dataflow/typed_value.hpp>
 #include <ossia/dataflow/value_vector.hpp>
@@ -61,7 +62,7 @@ private:
 
 struct value_delay_line
 {
-  std::vector<value_vector<ossia::typed_value>> data;
+  delay_ring<value_vector<ossia::typed_value>> data;
 };
 
 OSSIA_EXPORT
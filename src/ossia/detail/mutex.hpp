@@ -6,18 +6,54 @@
 #include <shared_mutex>
 #endif
 
+#if defined(OSSIA_RT_AUDIT)
+#include <ossia/detail/rt_audit.hpp>
+#endif
+
 namespace ossia
 {
+#if defined(OSSIA_RT_AUDIT)
+//! Reports the blocking acquisitions made in a real-time region
+template <typename Mutex>
+struct audited_mutex : Mutex
+{
+  void lock()
+  {
+    rt_audit::check(rt_audit::violation::lock);
+    Mutex::lock();
+  }
+};
+
+template <typename Mutex>
+struct audited_shared_mutex : audited_mutex<Mutex>
+{
+  void lock_shared()
+  {
+    rt_audit::check(rt_audit::violation::lock);
+    Mutex::lock_shared();
+  }
+};
+#endif
+
 #if defined(OSSIA_SHARED_MUTEX_AVAILABLE)
+#if defined(OSSIA_RT_AUDIT)
+using mutex_t = audited_mutex<std::mutex>;
+using shared_mutex_t = audited_shared_mutex<std::shared_timed_mutex>;
+#else
 using mutex_t = std::mutex;
+using shared_mutex_t = std::shared_timed_mutex;
+#endif
 using lock_t = std::lock_guard<mutex_t>;
 
-using shared_mutex_t = std::shared_timed_mutex;
 using write_lock_t = std::lock_guard<shared_mutex_t>;
 using read_lock_t = std::shared_lock<shared_mutex_t>;
 #else
+#if defined(OSSIA_RT_AUDIT)
+using mutex_t = audited_mutex<std::mutex>;
+#else
 using mutex_t = std::mutex;
-using shared_mutex_t = std::mutex;
+#endif
+using shared_mutex_t = mutex_t;
 using lock_t = std::lock_guard<mutex_t>;
 using write_lock_t = std::lock_guard<mutex_t>;
 using read_lock_t = std::lock_guard<mutex_t>;
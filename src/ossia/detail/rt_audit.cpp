@@ -0,0 +1,303 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/detail/rt_audit.hpp>
+
+#if defined(OSSIA_RT_AUDIT)
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define OSSIA_RT_AUDIT_BACKTRACE 1
+#endif
+
+namespace ossia::rt_audit
+{
+namespace
+{
+constexpr int max_frames = 16;
+constexpr int max_call_sites = 256;
+
+struct call_site
+{
+  void* frames[max_frames];
+  int frame_count;
+  violation kind;
+  std::size_t hits;
+};
+
+// Everything here is in static storage and constant-initialized:
+// recording a violation must not allocate, and may happen before main().
+struct audit_data
+{
+  std::atomic<std::size_t> counts[3];
+  std::atomic_flag sites_lock = ATOMIC_FLAG_INIT;
+  call_site sites[max_call_sites];
+  int site_count;
+  std::size_t dropped_sites;
+};
+audit_data g_audit;
+
+thread_local int t_depth = 0;
+thread_local bool t_recording = false;
+
+const char* violation_name(violation v) noexcept
+{
+  switch (v)
+  {
+    case violation::allocation:
+      return "allocation";
+    case violation::deallocation:
+      return "deallocation";
+    case violation::lock:
+      return "lock";
+  }
+  return "";
+}
+
+void record(const call_site& site) noexcept
+{
+  auto& d = g_audit;
+  while (d.sites_lock.test_and_set(std::memory_order_acquire))
+    ;
+
+  bool found = false;
+  for (int i = 0; i < d.site_count; i++)
+  {
+    auto& s = d.sites[i];
+    if (s.kind == site.kind && s.frame_count == site.frame_count
+        && std::memcmp(s.frames, site.frames, sizeof(void*) * site.frame_count) == 0)
+    {
+      s.hits++;
+      found = true;
+      break;
+    }
+  }
+
+  if (!found)
+  {
+    if (d.site_count < max_call_sites)
+    {
+      d.sites[d.site_count] = site;
+      d.sites[d.site_count].hits = 1;
+      d.site_count++;
+    }
+    else
+    {
+      d.dropped_sites++;
+    }
+  }
+
+  d.sites_lock.clear(std::memory_order_release);
+}
+
+struct audit_init
+{
+  audit_init() noexcept
+  {
+#if defined(OSSIA_RT_AUDIT_BACKTRACE)
+    // The first backtrace() loads the unwinder, which allocates
+    void* frame{};
+    backtrace(&frame, 1);
+#endif
+  }
+
+  ~audit_init()
+  {
+    std::size_t total = 0;
+    for (auto& c : g_audit.counts)
+      total += c.load();
+    if (total == 0)
+      return;
+
+    print_report();
+    if (std::getenv("OSSIA_RT_AUDIT_STRICT"))
+      std::_Exit(EXIT_FAILURE);
+  }
+} g_audit_init;
+}
+
+void enter() noexcept
+{
+  t_depth++;
+}
+
+void leave() noexcept
+{
+  t_depth--;
+}
+
+bool in_region() noexcept
+{
+  return t_depth > 0;
+}
+
+void check(violation v) noexcept
+{
+  // Whatever the recording itself does is not reported
+  if (t_depth <= 0 || t_recording)
+    return;
+  t_recording = true;
+
+  g_audit.counts[int(v)].fetch_add(1, std::memory_order_relaxed);
+
+  call_site site{};
+  site.kind = v;
+#if defined(OSSIA_RT_AUDIT_BACKTRACE)
+  site.frame_count = backtrace(site.frames, max_frames);
+#endif
+  record(site);
+
+  t_recording = false;
+}
+
+std::size_t count(violation v) noexcept
+{
+  return g_audit.counts[int(v)].load(std::memory_order_relaxed);
+}
+
+void reset() noexcept
+{
+  auto& d = g_audit;
+  while (d.sites_lock.test_and_set(std::memory_order_acquire))
+    ;
+  for (auto& c : d.counts)
+    c.store(0, std::memory_order_relaxed);
+  d.site_count = 0;
+  d.dropped_sites = 0;
+  d.sites_lock.clear(std::memory_order_release);
+}
+
+void print_report() noexcept
+{
+  auto& d = g_audit;
+  std::fprintf(
+      stderr,
+      "ossia: %zu allocation(s), %zu deallocation(s) and %zu lock(s) in "
+      "real-time regions\n",
+      count(violation::allocation), count(violation::deallocation),
+      count(violation::lock));
+
+  while (d.sites_lock.test_and_set(std::memory_order_acquire))
+    ;
+  for (int i = 0; i < d.site_count; i++)
+  {
+    const auto& s = d.sites[i];
+    std::fprintf(stderr, "\n%zu %s(s) from:\n", s.hits, violation_name(s.kind));
+    std::fflush(stderr);
+#if defined(OSSIA_RT_AUDIT_BACKTRACE)
+    // Skip check() itself
+    if (s.frame_count > 1)
+      backtrace_symbols_fd(s.frames + 1, s.frame_count - 1, 2);
+#endif
+  }
+  if (d.dropped_sites > 0)
+    std::fprintf(
+        stderr, "\n... and %zu other call sites\n", d.dropped_sites);
+  d.sites_lock.clear(std::memory_order_release);
+}
+}
+
+#if defined(__GLIBC__)
+// The allocator of the whole process is interposed.
+// The symbols of libossia are looked up before the ones of the libc.
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void __libc_free(void*);
+
+OSSIA_EXPORT void* malloc(std::size_t sz) noexcept
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  return __libc_malloc(sz);
+}
+
+OSSIA_EXPORT void* calloc(std::size_t n, std::size_t sz) noexcept
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  return __libc_calloc(n, sz);
+}
+
+OSSIA_EXPORT void* realloc(void* p, std::size_t sz) noexcept
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  return __libc_realloc(p, sz);
+}
+
+OSSIA_EXPORT void* memalign(std::size_t align, std::size_t sz) noexcept
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  return __libc_memalign(align, sz);
+}
+
+OSSIA_EXPORT void* aligned_alloc(std::size_t align, std::size_t sz) noexcept
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  return __libc_memalign(align, sz);
+}
+
+OSSIA_EXPORT int
+posix_memalign(void** res, std::size_t align, std::size_t sz) noexcept
+{
+  if (align % sizeof(void*) != 0 || (align & (align - 1)) != 0)
+    return EINVAL;
+
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  auto p = __libc_memalign(align, sz);
+  if (!p)
+    return ENOMEM;
+  *res = p;
+  return 0;
+}
+
+OSSIA_EXPORT void free(void* p) noexcept
+{
+  if (p)
+    ossia::rt_audit::check(ossia::rt_audit::violation::deallocation);
+  __libc_free(p);
+}
+}
+#else
+// Elsewhere, only the C++ allocations are seen
+void* operator new(std::size_t sz)
+{
+  ossia::rt_audit::check(ossia::rt_audit::violation::allocation);
+  if (auto p = std::malloc(sz ? sz : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t sz)
+{
+  return ::operator new(sz);
+}
+
+void operator delete(void* p) noexcept
+{
+  if (p)
+    ossia::rt_audit::check(ossia::rt_audit::violation::deallocation);
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  ::operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  ::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  ::operator delete(p);
+}
+#endif
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <cstddef>
+
+/**
+ * \file rt_audit.hpp
+ *
+ * Auditing of the real-time audio tick.
+ *
+ * When libossia is built with OSSIA_RT_AUDIT, the heap allocations and the
+ * acquisitions of ossia mutexes happening in a real-time region
+ * (between audio_engine::tick_start and tick_end, or in the tick functors)
+ * are counted and their call stacks are recorded.
+ * A report is printed on stderr when the process exits; if the
+ * OSSIA_RT_AUDIT_STRICT environment variable is set, the process then
+ * exits with a failure code if anything was recorded.
+ *
+ * Otherwise, all of this compiles to nothing.
+ */
+namespace ossia::rt_audit
+{
+enum class violation
+{
+  allocation,
+  deallocation,
+  lock
+};
+
+#if defined(OSSIA_RT_AUDIT)
+//! Marks the beginning of a real-time region on the current thread. Regions nest.
+OSSIA_EXPORT void enter() noexcept;
+
+//! Marks the end of a real-time region on the current thread.
+OSSIA_EXPORT void leave() noexcept;
+
+//! True if the current thread is in a real-time region.
+OSSIA_EXPORT bool in_region() noexcept;
+
+//! Records a violation with the call stack, if the current thread is in a region.
+OSSIA_EXPORT void check(violation v) noexcept;
+
+//! Number of violations of this kind recorded since the start or the last reset().
+OSSIA_EXPORT std::size_t count(violation v) noexcept;
+
+//! Forgets the recorded violations.
+OSSIA_EXPORT void reset() noexcept;
+
+//! Prints the recorded violations, grouped by call stack, on stderr.
+OSSIA_EXPORT void print_report() noexcept;
+#else
+inline void enter() noexcept { }
+inline void leave() noexcept { }
+inline bool in_region() noexcept { return false; }
+inline void check(violation) noexcept { }
+inline std::size_t count(violation) noexcept { return 0; }
+inline void reset() noexcept { }
+inline void print_report() noexcept { }
+#endif
+
+//! Marks a real-time region for the duration of a scope
+struct region
+{
+  region() noexcept { enter(); }
+  ~region() noexcept { leave(); }
+
+  region(const region&) = delete;
+  region(region&&) = delete;
+  region& operator=(const region&) = delete;
+  region& operator=(region&&) = delete;
+};
+}
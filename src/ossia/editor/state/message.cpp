@@ -9,7 +9,47 @@
 #include <ossia/network/value/value_traits.hpp>
 namespace ossia
 {
+namespace
+{
+struct push_value
+{
+  template <typename T>
+  void operator()(ossia::net::parameter_base& addr, T&& val) const
+  {
+    addr.push_value(std::forward<T>(val));
+  }
+};
+
+// Only sets the value: the caller is in charge of pushing it.
+// What the protocols would filter out is not kept.
+struct set_value
+{
+  std::optional<ossia::net::bundle_element>& changed;
+
+  template <typename T>
+  void operator()(ossia::net::parameter_base& addr, T&& val) const
+  {
+    if (auto res = addr.set_value(std::forward<T>(val));
+        res.valid() && !addr.filter_value(res))
+      changed = ossia::net::bundle_element{&addr, std::move(res)};
+  }
+};
+}
+
 void message::launch()
+{
+  launch_impl(push_value{});
+}
+
+std::optional<ossia::net::bundle_element> message::launch_deferred()
+{
+  std::optional<ossia::net::bundle_element> changed;
+  launch_impl(set_value{changed});
+  return changed;
+}
+
+template <typename Push>
+void message::launch_impl(Push push)
 {
   ossia::net::parameter_base& addr = dest.value.get();
   const auto& unit = dest.unit;
@@ -18,13 +58,12 @@ void message::launch()
   {
     if (!unit || unit == addr_unit)
     {
-      addr.push_value(message_value);
+      push(addr, message_value);
     }
     else
     {
       // Convert from this message's unit to the address's unit
-      addr.push_value(
-          ossia::convert(message_value, unit, addr_unit));
+      push(addr, ossia::convert(message_value, unit, addr_unit));
     }
   }
   else
@@ -42,7 +81,7 @@ void message::launch()
           ossia::apply(
               vec_merger{dest, dest}, cur.v, message_value.v);
 
-          addr.push_value(std::move(cur));
+          push(addr, std::move(cur));
           break;
         }
         case ossia::val_type::LIST:
@@ -51,7 +90,7 @@ void message::launch()
           // Insert the value of this message in the existing value array
           value_merger<true>::insert_in_list(
               cur_list, message_value, dest.index);
-          addr.push_value(std::move(cur));
+          push(addr, std::move(cur));
           break;
         }
         default:
@@ -60,14 +99,14 @@ void message::launch()
           std::vector<ossia::value> t{std::move(cur)};
           value_merger<true>::insert_in_list(
               t, message_value, dest.index);
-          addr.push_value(std::move(t));
+          push(addr, std::move(t));
           break;
         }
       }
     }
     else
     {
-      addr.push_value(ossia::to_value(ossia::convert(
+      push(addr, ossia::to_value(ossia::convert(
           ossia::merge(
               ossia::convert(ossia::net::get_value(addr), unit),
               std::move(message_value), dest.index),
@@ -77,22 +116,50 @@ void message::launch()
 }
 
 void piecewise_message::launch()
+{
+  launch_impl(push_value{});
+}
+
+std::optional<ossia::net::bundle_element> piecewise_message::launch_deferred()
+{
+  std::optional<ossia::net::bundle_element> changed;
+  launch_impl(set_value{changed});
+  return changed;
+}
+
+template <typename Push>
+void piecewise_message::launch_impl(Push push)
 {
   // If values are missing, merge with the existing ones
   auto cur = address.get().value();
   if (auto cur_list = cur.target<std::vector<ossia::value>>())
   {
     value_merger<true>::merge_list(*cur_list, std::move(message_value));
-    address.get().push_value(std::move(cur));
+    push(address.get(), std::move(cur));
   }
   else
   {
-    address.get().push_value(std::move(message_value));
+    push(address.get(), std::move(message_value));
   }
 }
 
 template <std::size_t N>
 void piecewise_vec_message<N>::launch()
+{
+  launch_impl(push_value{});
+}
+
+template <std::size_t N>
+std::optional<ossia::net::bundle_element> piecewise_vec_message<N>::launch_deferred()
+{
+  std::optional<ossia::net::bundle_element> changed;
+  launch_impl(set_value{changed});
+  return changed;
+}
+
+template <std::size_t N>
+template <typename Push>
+void piecewise_vec_message<N>::launch_impl(Push push)
 {
   ossia::net::parameter_base& addr = address.get();
   auto addr_unit = addr.get_unit();
@@ -100,7 +167,7 @@ void piecewise_vec_message<N>::launch()
   {
     if (used_values.all())
     {
-      addr.push_value(std::move(message_value));
+      push(addr, std::move(message_value));
     }
     else
     {
@@ -117,7 +184,7 @@ void piecewise_vec_message<N>::launch()
           }
         }
 
-        addr.push_value(val);
+        push(addr, val);
       }
     }
   }
@@ -145,8 +212,7 @@ void piecewise_vec_message<N>::launch()
       }
       */
 
-      addr.push_value(
-          ossia::convert(std::move(message_value), unit, addr_unit));
+      push(addr, ossia::convert(std::move(message_value), unit, addr_unit));
     }
     else
     {
@@ -166,7 +232,7 @@ void piecewise_vec_message<N>::launch()
       }
       */
 
-      addr.push_value(to_value( // Go from Unit domain to Value domain
+      push(addr, to_value( // Go from Unit domain to Value domain
           convert(              // Convert to the resulting address unit
               merge(       // Merge the automation value with the "unit" value
                   convert( // Put the current value in the Unit domain
@@ -182,4 +248,10 @@ void piecewise_vec_message<N>::launch()
 template OSSIA_EXPORT void piecewise_vec_message<2>::launch();
 template OSSIA_EXPORT void piecewise_vec_message<3>::launch();
 template OSSIA_EXPORT void piecewise_vec_message<4>::launch();
+template OSSIA_EXPORT std::optional<ossia::net::bundle_element>
+piecewise_vec_message<2>::launch_deferred();
+template OSSIA_EXPORT std::optional<ossia::net::bundle_element>
+piecewise_vec_message<3>::launch_deferred();
+template OSSIA_EXPORT std::optional<ossia::net::bundle_element>
+piecewise_vec_message<4>::launch_deferred();
 }
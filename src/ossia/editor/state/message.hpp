@@ -1,4 +1,5 @@
 #pragma once
+#include <ossia/network/base/parameter_data.hpp>
 #include <ossia/network/common/destination_qualifiers.hpp>
 #include <ossia/network/value/destination.hpp>
 #include <ossia/network/value/value.hpp>
@@ -7,6 +8,7 @@
 
 #include <bitset>
 #include <memory>
+#include <optional>
 #include <utility>
 
 /**
@@ -18,6 +20,7 @@ namespace net
 {
 class parameter_base;
 }
+
 /**
  * @brief The message struct
  *
@@ -37,6 +40,11 @@ struct OSSIA_EXPORT message
   }
   void launch();
 
+  //! Sets the value of the parameter without pushing it to the network.
+  //! Returns the value the caller has to push, if any: the parameter
+  //! may have been set again by the time it is pushed.
+  std::optional<ossia::net::bundle_element> launch_deferred();
+
   friend bool operator==(const message& lhs, const message& rhs)
   {
     return lhs.dest == rhs.dest && lhs.message_value == rhs.message_value;
@@ -69,6 +77,10 @@ struct OSSIA_EXPORT message
       : dest{d.value, d.index, u}, message_value{std::move(v)}
   {
   }
+
+private:
+  template <typename Push>
+  void launch_impl(Push push);
 };
 
 struct OSSIA_EXPORT piecewise_message
@@ -83,6 +95,9 @@ struct OSSIA_EXPORT piecewise_message
   }
   void launch();
 
+  //! \see message::launch_deferred
+  std::optional<ossia::net::bundle_element> launch_deferred();
+
   friend bool
   operator==(const piecewise_message& lhs, const piecewise_message& rhs)
   {
@@ -96,6 +111,10 @@ struct OSSIA_EXPORT piecewise_message
     return &lhs.address.get() != &rhs.address.get()
            || lhs.message_value != rhs.message_value || lhs.unit != rhs.unit;
   }
+
+private:
+  template <typename Push>
+  void launch_impl(Push push);
 };
 
 template <std::size_t N>
@@ -112,6 +131,9 @@ struct piecewise_vec_message
   }
   void launch();
 
+  //! \see message::launch_deferred
+  std::optional<ossia::net::bundle_element> launch_deferred();
+
   friend bool operator==(
       const piecewise_vec_message& lhs, const piecewise_vec_message& rhs)
   {
@@ -127,5 +149,9 @@ struct piecewise_vec_message
            || lhs.message_value != rhs.message_value || lhs.unit != rhs.unit
            || lhs.used_values != rhs.used_values;
   }
+
+private:
+  template <typename Push>
+  void launch_impl(Push push);
 };
 }
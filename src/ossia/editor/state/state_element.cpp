@@ -8,6 +8,30 @@
 
 namespace ossia
 {
+namespace
+{
+struct state_deferred_execution_visitor
+{
+  std::vector<ossia::net::bundle_element>& to_push;
+
+  template <typename T>
+  void operator()(T& m)
+  {
+    if (auto v = m.launch_deferred())
+      to_push.push_back(std::move(*v));
+  }
+
+  void operator()(ossia::state& s)
+  {
+    for (auto& e : s)
+      ossia::apply(*this, e);
+  }
+
+  void operator()()
+  {
+  }
+};
+}
 
 void control_message::launch()
 {
@@ -20,6 +44,11 @@ void launch(state_element& e)
   ossia::apply(state_execution_visitor{}, e);
 }
 
+void launch_deferred(state_element& e, std::vector<ossia::net::bundle_element>& to_push)
+{
+  ossia::apply(state_deferred_execution_visitor{to_push}, e);
+}
+
 std::ostream& print(std::ostream& out, const state_element& e)
 {
   ossia::apply(state_print_visitor{out, {}}, e);
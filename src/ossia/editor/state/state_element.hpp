@@ -16,6 +16,16 @@ namespace ossia
  */
 OSSIA_EXPORT void launch(state_element& e);
 
+/**
+ * @brief launch_deferred Launch a \ref state_element without pushing
+ *
+ * The values are set on the parameters, and appended in order
+ * to \p to_push : the caller is in charge of pushing them,
+ * for instance with protocol_base::push_bundle_values.
+ */
+OSSIA_EXPORT void launch_deferred(
+    state_element& e, std::vector<ossia::net::bundle_element>& to_push);
+
 /**
  * @brief print Print a \ref state_element
  */
@@ -0,0 +1,271 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/network/base/address_index.hpp>
+#include <ossia/network/base/node.hpp>
+#include <ossia/network/base/parameter.hpp>
+
+#include <functional>
+#include <string_view>
+
+namespace ossia
+{
+namespace net
+{
+namespace
+{
+// Marks a reader as active in the current epoch for its lifetime
+struct read_section
+{
+  std::atomic<int>& readers;
+
+  read_section(std::atomic<int>& epoch, std::atomic<int>* counters) noexcept
+      : readers{counters[epoch.load()]}
+  {
+    readers.fetch_add(1);
+  }
+
+  ~read_section()
+  {
+    readers.fetch_sub(1);
+  }
+};
+}
+
+struct address_index::entry
+{
+  std::string address;
+  parameter_base* param{};
+  std::size_t hash{};
+  std::atomic<entry*> next{};
+};
+
+struct address_index::table
+{
+  explicit table(std::size_t size) : buckets(size) { }
+
+  ~table()
+  {
+    for (auto& b : buckets)
+    {
+      for (entry* e = b.load(); e;)
+      {
+        entry* next = e->next.load();
+        delete e;
+        e = next;
+      }
+    }
+  }
+
+  std::atomic<entry*>& bucket(std::size_t hash) noexcept
+  {
+    return buckets[hash & (buckets.size() - 1)];
+  }
+
+  // Always a power of two
+  std::vector<std::atomic<entry*>> buckets;
+};
+
+static std::size_t address_hash(std::string_view address) noexcept
+{
+  return std::hash<std::string_view>{}(address);
+}
+
+address_index::address_index(device_base& dev)
+    : m_table{new table{64}}
+{
+  dev.on_node_created.connect<&address_index::on_node_created>(*this);
+  dev.on_node_removing.connect<&address_index::on_node_removing>(*this);
+  dev.on_node_renamed.connect<&address_index::on_node_renamed>(*this);
+  dev.on_parameter_created.connect<&address_index::on_parameter_created>(
+      *this);
+  dev.on_parameter_removing.connect<&address_index::on_parameter_removing>(
+      *this);
+
+  std::lock_guard<std::mutex> lock{m_mutex};
+  add_tree(dev.get_root_node());
+}
+
+address_index::~address_index()
+{
+  for (auto r : {&m_retired, &m_grace})
+  {
+    for (auto e : r->entries)
+      delete e;
+    for (auto t : r->tables)
+      delete t;
+  }
+  delete m_table.load();
+}
+
+parameter_base* address_index::find(std::string_view address) const noexcept
+{
+  read_section _{m_epoch, m_readers};
+
+  const auto hash = address_hash(address);
+  for (entry* e = m_table.load()->bucket(hash).load(); e; e = e->next.load())
+  {
+    if (e->hash == hash && e->address == address)
+      return e->param;
+  }
+  return nullptr;
+}
+
+void address_index::insert(std::string address, parameter_base* param)
+{
+  const auto hash = address_hash(address);
+  auto& t = *m_table.load();
+  auto& head = t.bucket(hash);
+
+  std::atomic<entry*>* link = &head;
+  for (entry* e = link->load(); e; link = &e->next, e = link->load())
+  {
+    if (e->hash == hash && e->address == address)
+    {
+      // Entries are immutable: the readers see either the old or the new one
+      auto n = new entry{std::move(address), param, hash};
+      n->next.store(e->next.load());
+      link->store(n);
+      m_retired.entries.push_back(e);
+      return;
+    }
+  }
+
+  auto n = new entry{std::move(address), param, hash};
+  n->next.store(head.load());
+  head.store(n);
+
+  if (++m_count > t.buckets.size())
+    grow();
+}
+
+void address_index::erase(std::string_view address, const parameter_base* param)
+{
+  const auto hash = address_hash(address);
+  auto& t = *m_table.load();
+
+  std::atomic<entry*>* link = &t.bucket(hash);
+  for (entry* e = link->load(); e; link = &e->next, e = link->load())
+  {
+    if (e->hash == hash && e->address == address)
+    {
+      // Readers on the entry still find the rest of the list through it
+      if (e->param == param)
+      {
+        link->store(e->next.load());
+        m_retired.entries.push_back(e);
+        m_count--;
+      }
+      return;
+    }
+  }
+}
+
+void address_index::grow()
+{
+  // Amortized by the doubling: the current table stays readable meanwhile
+  auto old = m_table.load();
+  auto t = new table{2 * old->buckets.size()};
+  for (auto& b : old->buckets)
+  {
+    for (entry* e = b.load(); e; e = e->next.load())
+    {
+      auto& head = t->bucket(e->hash);
+      auto n = new entry{e->address, e->param, e->hash};
+      n->next.store(head.load());
+      head.store(n);
+    }
+  }
+
+  m_table.store(t);
+  m_retired.tables.push_back(old);
+}
+
+void address_index::reclaim()
+{
+  // What was retired before the last epoch change can be freed once the
+  // readers counted in the previous epoch have left. If some are still
+  // there, a later edit will try again: the writer never waits for them.
+  if (m_retired.entries.empty() && m_retired.tables.empty()
+      && m_grace.entries.empty() && m_grace.tables.empty())
+    return;
+
+  const int epoch = m_epoch.load();
+  if (m_readers[1 - epoch].load() != 0)
+    return;
+
+  for (auto e : m_grace.entries)
+    delete e;
+  for (auto t : m_grace.tables)
+    delete t;
+  m_grace.entries.clear();
+  m_grace.tables.clear();
+  std::swap(m_grace, m_retired);
+
+  m_epoch.store(1 - epoch);
+}
+
+void address_index::add_tree(node_base& node)
+{
+  if (auto param = node.get_parameter())
+    add(*param);
+
+  for (auto child : node.children_copy())
+    add_tree(*child);
+}
+
+void address_index::add(const parameter_base& param)
+{
+  remove(param);
+
+  auto& address = param.get_node().osc_address();
+  insert(address, const_cast<parameter_base*>(&param));
+  m_parameters[&param] = address;
+}
+
+void address_index::remove(const parameter_base& param)
+{
+  auto it = m_parameters.find(&param);
+  if (it == m_parameters.end())
+    return;
+
+  erase(it->second, &param);
+  m_parameters.erase(it);
+}
+
+void address_index::on_node_created(node_base& node)
+{
+  // Nodes usually get their parameter afterwards,
+  // but some protocols create them with one.
+  if (auto param = node.get_parameter())
+    on_parameter_created(*param);
+}
+
+void address_index::on_node_removing(node_base& node)
+{
+  if (auto param = node.get_parameter())
+    on_parameter_removing(*param);
+}
+
+void address_index::on_node_renamed(node_base& node, std::string)
+{
+  // The addresses of all the children have changed too
+  std::lock_guard<std::mutex> lock{m_mutex};
+  add_tree(node);
+  reclaim();
+}
+
+void address_index::on_parameter_created(const parameter_base& param)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  add(param);
+  reclaim();
+}
+
+void address_index::on_parameter_removing(const parameter_base& param)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  remove(param);
+  reclaim();
+}
+}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <ossia/detail/hash_map.hpp>
+#include <ossia/network/base/device.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ossia
+{
+namespace net
+{
+class parameter_base;
+
+/**
+ * @brief Index of the parameters of a device by OSC address.
+ *
+ * Used by the protocols to dispatch incoming messages
+ * without walking the device tree.
+ *
+ * The index follows the tree through the signals of the device, and is
+ * updated in place on the thread editing the tree. Readers never take a
+ * lock nor allocate : the index is a hash table whose buckets are lists
+ * of immutable entries, which the writer relinks atomically. Removed
+ * entries, and the previous table when it grows, are freed by a later edit
+ * once all the readers which could see them have left (a simple RCU scheme):
+ * edits never wait for the readers.
+ *
+ * \see device_base::set_address_index
+ */
+class OSSIA_EXPORT address_index final : public Nano::Observer
+{
+public:
+  explicit address_index(device_base& dev);
+  ~address_index();
+
+  address_index(const address_index&) = delete;
+  address_index(address_index&&) = delete;
+  address_index& operator=(const address_index&) = delete;
+  address_index& operator=(address_index&&) = delete;
+
+  //! The parameter at this exact address, or nullptr if it is unknown.
+  //! Wait-free.
+  parameter_base* find(std::string_view address) const noexcept;
+
+private:
+  struct entry;
+  struct table;
+
+  void on_node_created(node_base& node);
+  void on_node_removing(node_base& node);
+  void on_node_renamed(node_base& node, std::string old_name);
+  void on_parameter_created(const parameter_base& param);
+  void on_parameter_removing(const parameter_base& param);
+
+  //! (Re-)indexes all the parameters under this node
+  void add_tree(node_base& node);
+  void add(const parameter_base& param);
+  void remove(const parameter_base& param);
+
+  void insert(std::string address, parameter_base* param);
+  void erase(std::string_view address, const parameter_base* param);
+  void grow();
+  void reclaim();
+
+  // Writer side, protected by m_mutex
+  std::mutex m_mutex;
+  ossia::fast_hash_map<const parameter_base*, std::string> m_parameters;
+  std::size_t m_count{};
+
+  // Unlinked from the table, freed once the readers of their epoch have left
+  struct retired
+  {
+    std::vector<entry*> entries;
+    std::vector<table*> tables;
+  };
+  retired m_retired;  // Since the last epoch change
+  retired m_grace;    // Before the last epoch change
+
+  // Reader side
+  std::atomic<table*> m_table{};
+  mutable std::atomic<int> m_epoch{};
+  mutable std::atomic<int> m_readers[2]{};
+};
+
+//! Looks the address up in the index of the device, if it has one.
+inline parameter_base*
+find_indexed_parameter(const device_base& dev, std::string_view address) noexcept
+{
+  if (auto index = dev.get_address_index())
+    return index->find(address);
+  return nullptr;
+}
+}
+}
@@ -1,5 +1,6 @@
 // This is an open source non-commercial project. Dear PVS-Studio, please check
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/network/base/address_index.hpp>
 #include <ossia/network/base/device.hpp>
 #include <ossia/network/base/protocol.hpp>
 
@@ -19,6 +20,14 @@ protocol_base& device_base::get_protocol() const
   return *m_protocol;
 }
 
+void device_base::set_address_index(bool enabled)
+{
+  if (enabled && !m_address_index)
+    m_address_index = std::make_unique<address_index>(*this);
+  else if (!enabled)
+    m_address_index.reset();
+}
+
 void device_base::apply_incoming_message(
     const message_origin_identifier& id,
     parameter_base& param,
@@ -11,6 +11,7 @@ namespace net
 {
 struct parameter_data;
 class protocol_base;
+class address_index;
 
 /**
  * @brief What a device is able to do
@@ -35,6 +36,7 @@ struct message_origin_identifier;
  * - after a node has been created : device_base::on_node_created
  * - after a node has been renamed : device_base::on_node_renamed
  * - before a node is removed : device_base::on_node_removing
+ * - after a node has been removed : device_base::on_node_removed
  *
  * - after a parameter has been created : device_base::on_parameter_created
  * - before a parameter is being removed : device_base::on_parameter_removing
@@ -95,6 +97,21 @@ public:
     m_echo = echo;
   }
 
+  /**
+   * @brief Maintains an index of the parameters by OSC address.
+   *
+   * Incoming messages are then dispatched without walking the tree,
+   * at the cost of some bookkeeping on each tree edit.
+   * It must not be disabled while the protocol is receiving messages.
+   *
+   * \see address_index
+   */
+  void set_address_index(bool enabled);
+  const address_index* get_address_index() const noexcept
+  {
+    return m_address_index.get();
+  }
+
   void apply_incoming_message(
       const message_origin_identifier& id,
       ossia::net::parameter_base& param,
@@ -109,6 +126,8 @@ public:
       on_node_created; // The node being created
   Nano::Signal<void(node_base&)>
       on_node_removing; // The node being removed
+  Nano::Signal<void(node_base&)>
+      on_node_removed; // The parent of the node, once it has been destroyed
   Nano::Signal<void(node_base&, std::string)>
       on_node_renamed; // Node has the new name, second argument is the old
                        // name
@@ -139,6 +158,10 @@ protected:
   std::unique_ptr<ossia::net::protocol_base> m_protocol;
   device_capabilities m_capabilities{};
   bool m_echo{false};
+
+private:
+  // Last so that it is disconnected before the signals are destroyed
+  std::unique_ptr<address_index> m_address_index;
 };
 
 template <typename T>
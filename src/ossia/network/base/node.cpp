@@ -78,6 +78,7 @@ node_base* node_base::create_child(std::string name)
     if ((ptr = res.get()))
     {
       m_children.push_back(std::move(res));
+      index_child(*ptr);
     }
   }
 
@@ -152,6 +153,7 @@ node_base* node_base::add_child(std::unique_ptr<node_base> n)
       {
         write_lock_t lock{m_mutex};
         m_children.push_back(std::move(n));
+        index_child(*ptr);
       }
       dev.on_node_created(*ptr);
       return ptr;
@@ -166,20 +168,87 @@ node_base* node_base::find_child(ossia::string_view name)
     SPDLOG_TRACE((&ossia::logger()), "locking(findChild)");
     read_lock_t lock{m_mutex};
     SPDLOG_TRACE((&ossia::logger()), "locked(findChild)");
-    for (auto& node : m_children)
+    if (m_children.size() < child_index_threshold)
     {
-      if (node->get_name() == name)
+      for (auto& node : m_children)
       {
-        SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
-        return node.get();
+        if (node->get_name() == name)
+        {
+          SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
+          return node.get();
+        }
       }
+
+      SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
+      return nullptr;
+    }
+
+    // Some implementations fill m_children directly: an index of a different
+    // size than the children is out of date.
+    if (m_child_index && m_child_index->size() == m_children.size())
+    {
+      SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
+      return find_indexed_child(name);
     }
   }
 
-  SPDLOG_TRACE((&ossia::logger()), "unlocked(findChild)");
+  write_lock_t lock{m_mutex};
+  rebuild_child_index();
+  return find_indexed_child(name);
+}
+
+node_base* node_base::find_indexed_child(ossia::string_view name) const
+{
+  auto it = m_child_index->find(name);
+  if (it != m_child_index->end() && it->second->get_name() == name)
+    return it->second;
   return nullptr;
 }
 
+void node_base::rebuild_child_index() const
+{
+  if (!m_child_index)
+    m_child_index = std::make_unique<ossia::string_map<node_base*>>();
+  else
+    m_child_index->clear();
+
+  m_child_index->reserve(m_children.size());
+  for (auto& node : m_children)
+    m_child_index->emplace(node->get_name(), node.get());
+}
+
+void node_base::index_child(node_base& child)
+{
+  if (m_child_index)
+    m_child_index->emplace(child.get_name(), &child);
+}
+
+void node_base::unindex_child(const node_base& child)
+{
+  if (m_child_index)
+  {
+    auto it = m_child_index->find(child.get_name());
+    if (it != m_child_index->end() && it->second == &child)
+      m_child_index->erase(it);
+  }
+}
+
+void node_base::on_child_renamed(
+    const node_base& child, const std::string& old_name)
+{
+  write_lock_t lock{m_mutex};
+  if (m_child_index)
+  {
+    auto it = m_child_index->find(old_name);
+    if (it != m_child_index->end() && it->second == &child)
+    {
+      auto ptr = it->second;
+      m_child_index->erase(it);
+      m_child_index->emplace(child.get_name(), ptr);
+    }
+  }
+}
+
 #if defined(OSSIA_QT)
 node_base* node_base::find_child(const QString& name)
 {
@@ -229,6 +298,7 @@ bool node_base::remove_child(const std::string& name)
 
     if (it != m_children.end())
     {
+      unindex_child(**it);
       cld = std::move(*it);
       m_children.erase(it);
     }
@@ -239,6 +309,8 @@ bool node_base::remove_child(const std::string& name)
     cld->clear_children();
     dev.on_node_removing(*cld);
     removing_child(*cld);
+    cld.reset();
+    dev.on_node_removed(*this);
 
     return true;
   }
@@ -262,6 +334,7 @@ bool node_base::remove_child(const node_base& n)
 
     if (it != m_children.end())
     {
+      unindex_child(**it);
       cld = std::move(*it);
       m_children.erase(it);
     }
@@ -273,6 +346,7 @@ bool node_base::remove_child(const node_base& n)
     dev.on_node_removing(*cld);
     removing_child(*cld);
     cld.reset();
+    dev.on_node_removed(*this);
     return true;
   }
   else
@@ -292,6 +366,7 @@ void node_base::clear_children()
   {
     write_lock_t lock{m_mutex};
     to_remove = std::move(m_children);
+    m_child_index.reset();
   }
 
   for (auto& child : to_remove)
@@ -302,6 +377,9 @@ void node_base::clear_children()
     removing_child(*child);
     child.reset();
   }
+
+  if (!to_remove.empty())
+    dev.on_node_removed(*this);
 }
 
 std::vector<node_base*> node_base::children_copy() const
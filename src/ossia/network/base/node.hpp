@@ -4,6 +4,7 @@
 #include <ossia/detail/locked_container.hpp>
 #include <ossia/detail/mutex.hpp>
 #include <ossia/detail/ptr_container.hpp>
+#include <ossia/detail/string_map.hpp>
 #include <ossia/detail/string_view.hpp>
 #include <ossia/network/base/name_validation.hpp>
 #include <ossia/network/common/parameter_properties.hpp>
@@ -48,6 +49,10 @@ class OSSIA_EXPORT node_base
 {
 public:
   using children_t = std::vector<std::unique_ptr<node_base>>;
+
+  //! Past this number of children, find_child uses a hash index of the names.
+  static constexpr std::size_t child_index_threshold = 32;
+
   node_base() = default;
   node_base(const node_base&) = delete;
   node_base(node_base&&) = delete;
@@ -149,6 +154,8 @@ public:
    *
    * If you need to find a child recursively, see ossia::net::find_node.
    *
+   * Nodes with more than child_index_threshold children build an index of
+   * their children names on the first lookup, which is then kept up-to-date.
    */
   node_base* find_child(ossia::string_view name);
 #if defined(OSSIA_QT)
@@ -164,6 +171,9 @@ public:
   //! Remove all the children.
   void clear_children();
 
+  //! Must be called by the implementations of set_name on the parent node.
+  void on_child_renamed(const node_base& child, const std::string& old_name);
+
   operator const extended_attributes&() const
   {
     return m_extended;
@@ -214,6 +224,14 @@ protected:
   mutable shared_mutex_t m_mutex;
   extended_attributes m_extended{0};
   std::string m_oscAddressCache;
+
+private:
+  node_base* find_indexed_child(ossia::string_view name) const;
+  void rebuild_child_index() const;
+  void index_child(node_base& child);
+  void unindex_child(const node_base& child);
+
+  mutable std::unique_ptr<ossia::string_map<node_base*>> m_child_index;
 };
 }
 }
@@ -10,6 +10,8 @@ namespace ossia
 {
 namespace net
 {
+class parameter_base;
+
 /**
  * @brief The data that can be found inside a parameter
  *
@@ -169,5 +171,19 @@ public:
     return critical;
   }
 };
+
+/**
+ * @brief A value to send for a parameter, as part of a bundle.
+ *
+ * The value is already filtered, e.g. by the repetition filter of the
+ * parameter when it was set: only its domain remains to apply.
+ *
+ * \see protocol_base::push_bundle_values
+ */
+struct bundle_element
+{
+  const parameter_base* parameter{};
+  ossia::value value;
+};
 }
 }
@@ -54,6 +54,17 @@ bool protocol_base::push_raw_bundle(
   return b;
 }
 
+bool protocol_base::push_bundle_values(
+    const std::vector<ossia::net::bundle_element>& v)
+{
+  bool b = !v.empty();
+  for (auto& e : v)
+  {
+    b &= push(*e.parameter, e.value);
+  }
+  return b;
+}
+
 std::future<void> protocol_base::update_async(node_base& node_base)
 {
   // Mock implementation for devices which haven't been ported to async yet
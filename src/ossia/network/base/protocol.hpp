@@ -19,6 +19,7 @@ class parameter_base;
 class node_base;
 class device_base;
 struct full_parameter_data;
+struct bundle_element;
 
 class protocol_base;
 
@@ -97,6 +98,14 @@ public:
    */
   virtual bool push_raw_bundle(const std::vector<full_parameter_data>&);
 
+  /**
+   * @brief Send many values in one go, in order, if the protocol supports it
+   *
+   * Unlike with push_bundle, each element comes with its value, so a
+   * parameter may be sent several times. By default, each value is pushed.
+   */
+  virtual bool push_bundle_values(const std::vector<bundle_element>&);
+
   /**
    * @brief Notify the network that a parameter should be listened to.
    *
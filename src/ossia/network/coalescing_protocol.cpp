@@ -0,0 +1,286 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/network/base/device.hpp>
+#include <ossia/network/base/osc_address.hpp>
+#include <ossia/network/base/parameter.hpp>
+#include <ossia/network/coalescing_protocol.hpp>
+
+#include <algorithm>
+
+namespace ossia::net
+{
+struct coalescing_protocol::group final : timer_wheel::entry
+{
+  group(coalescing_protocol& s, duration p) : self{s}, period{p} { }
+
+  void on_timer() noexcept override { self.flush(*this); }
+
+  coalescing_protocol& self;
+  duration period{};
+  // Slots pushed since the last flush
+  std::vector<std::size_t> dirty;
+};
+
+coalescing_protocol::coalescing_protocol(
+    std::shared_ptr<timer_wheel> wheel, coalescing_configuration conf,
+    std::unique_ptr<protocol_base> arg)
+    : protocol_base{arg->get_flags()}
+    , m_wheel{std::move(wheel)}
+    , m_protocol{std::move(arg)}
+    , m_bundle{conf.bundle}
+{
+  m_groups.push_back(std::make_unique<group>(*this, conf.period));
+  m_default = m_groups.front().get();
+
+  for (auto& [address, period] : conf.overrides)
+  {
+    m_overrides[address] = period;
+    find_group(period);
+  }
+
+  for (auto& g : m_groups)
+    m_wheel->schedule(*g, g->period);
+}
+
+coalescing_protocol::~coalescing_protocol()
+{
+  // Once cancelled, the groups are not flushed anymore
+  for (auto& g : m_groups)
+    m_wheel->cancel(*g);
+
+  if (m_device)
+    m_device->on_parameter_removing
+        .disconnect<&coalescing_protocol::parameter_removed>(this);
+}
+
+auto coalescing_protocol::find_group(duration d) -> group*
+{
+  // The default group keeps its own period when it changes
+  for (std::size_t i = 1; i < m_groups.size(); i++)
+    if (m_groups[i]->period == d)
+      return m_groups[i].get();
+
+  return m_groups.emplace_back(std::make_unique<group>(*this, d)).get();
+}
+
+std::size_t coalescing_protocol::find_slot(const parameter_base& p)
+{
+  if (auto it = m_index.find(&p); it != m_index.end())
+    return it->second;
+
+  std::size_t idx{};
+  if (!m_free.empty())
+  {
+    idx = m_free.back();
+    m_free.pop_back();
+  }
+  else
+  {
+    idx = m_slots.size();
+    m_slots.emplace_back();
+  }
+
+  auto& s = m_slots[idx];
+  s.parameter = &p;
+  s.owner = configured_group(p);
+
+  m_index[&p] = idx;
+  return idx;
+}
+
+auto coalescing_protocol::configured_group(const parameter_base& p) -> group*
+{
+  if (!m_overrides.empty())
+  {
+    auto it = m_overrides.find(ossia::net::osc_parameter_string(p.get_node()));
+    if (it != m_overrides.end())
+      return find_group(it->second);
+  }
+  return m_default;
+}
+
+void coalescing_protocol::set_period(duration d)
+{
+  {
+    std::lock_guard lock{m_mutex};
+    m_default->period = d;
+  }
+  m_wheel->schedule(*m_default, d);
+}
+
+void coalescing_protocol::set_period(const parameter_base& p, duration d)
+{
+  group* g{};
+  bool created{};
+  {
+    std::lock_guard lock{m_mutex};
+    const auto n = m_groups.size();
+    g = find_group(d);
+    created = m_groups.size() != n;
+    m_slots[find_slot(p)].owner = g;
+  }
+
+  // cancel() waits for a running flush(), which takes m_mutex: the wheel is
+  // never called with m_mutex taken.
+  if (created)
+    m_wheel->schedule(*g, d);
+}
+
+void coalescing_protocol::reset_period(const parameter_base& p)
+{
+  std::lock_guard lock{m_mutex};
+  if (auto it = m_index.find(&p); it != m_index.end())
+  {
+    // A pending value is still sent with the previous period
+    m_slots[it->second].owner = configured_group(p);
+  }
+}
+
+template <typename T>
+bool coalescing_protocol::push_impl(const parameter_base& addr, T&& v)
+{
+  std::lock_guard lock{m_mutex};
+  const auto idx = find_slot(addr);
+  auto& s = m_slots[idx];
+  s.value = std::forward<T>(v);
+  if (!s.dirty)
+  {
+    s.dirty = true;
+    s.owner->dirty.push_back(idx);
+  }
+  return true;
+}
+
+bool coalescing_protocol::push(const parameter_base& addr, const ossia::value& v)
+{
+  return push_impl(addr, v);
+}
+
+bool coalescing_protocol::push(const parameter_base& addr, ossia::value&& v)
+{
+  return push_impl(addr, std::move(v));
+}
+
+void coalescing_protocol::flush(group& g) noexcept
+{
+  std::lock_guard flush_lock{m_flushMutex};
+  {
+    std::lock_guard lock{m_mutex};
+    // Only grows with the number of parameters
+    const auto n = std::max(g.dirty.size(), m_slots.size());
+    if (m_flush.capacity() < g.dirty.size())
+    {
+      m_flush.reserve(n);
+      m_flushBundle.reserve(n);
+    }
+
+    for (auto idx : g.dirty)
+    {
+      auto& s = m_slots[idx];
+      if (s.dirty)
+      {
+        s.dirty = false;
+        m_flush.emplace_back(s.parameter, std::move(s.value));
+      }
+    }
+    g.dirty.clear();
+  }
+
+  if (m_flush.empty())
+    return;
+
+  try
+  {
+    if (m_bundle)
+    {
+      m_flushBundle.clear();
+      for (auto& [p, v] : m_flush)
+        m_flushBundle.push_back(p);
+      m_protocol->push_bundle(m_flushBundle);
+    }
+    else
+    {
+      for (auto& [p, v] : m_flush)
+        m_protocol->push(*p, std::move(v));
+    }
+  }
+  catch (const std::exception& e)
+  {
+    ossia::logger().error("[coalescing_protocol::flush]: {}", e.what());
+  }
+  catch (...)
+  {
+    ossia::logger().error("[coalescing_protocol::flush]: unknown error");
+  }
+
+  m_flush.clear();
+}
+
+void coalescing_protocol::parameter_removed(const parameter_base& p)
+{
+  std::lock_guard flush_lock{m_flushMutex};
+  std::lock_guard lock{m_mutex};
+  if (auto it = m_index.find(&p); it != m_index.end())
+  {
+    // The index may still be in a list of dirty slots: it is skipped there
+    auto& s = m_slots[it->second];
+    s.parameter = nullptr;
+    s.value = ossia::value{};
+    s.owner = nullptr;
+    s.dirty = false;
+
+    m_free.push_back(it->second);
+    m_index.erase(it);
+  }
+}
+
+bool coalescing_protocol::pull(parameter_base& address)
+{
+  return m_protocol->pull(address);
+}
+
+bool coalescing_protocol::push_raw(const full_parameter_data& address)
+{
+  return m_protocol->push_raw(address);
+}
+
+bool coalescing_protocol::echo_incoming_message(
+    const message_origin_identifier& id, const parameter_base& p,
+    const ossia::value& v)
+{
+  return m_protocol->echo_incoming_message(id, p, v);
+}
+
+bool coalescing_protocol::observe(parameter_base& address, bool enable)
+{
+  return m_protocol->observe(address, enable);
+}
+
+bool coalescing_protocol::update(node_base& node)
+{
+  return m_protocol->update(node);
+}
+
+void coalescing_protocol::set_logger(const network_logger& l)
+{
+  m_protocol->set_logger(l);
+}
+
+const network_logger& coalescing_protocol::get_logger() const noexcept
+{
+  return m_protocol->get_logger();
+}
+
+void coalescing_protocol::stop()
+{
+  m_protocol->stop();
+}
+
+void coalescing_protocol::set_device(device_base& dev)
+{
+  m_device = &dev;
+  m_protocol->set_device(dev);
+  dev.on_parameter_removing.connect<&coalescing_protocol::parameter_removed>(
+      this);
+}
+}
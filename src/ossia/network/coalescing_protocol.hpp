@@ -0,0 +1,126 @@
+#pragma once
+#include <ossia/detail/hash_map.hpp>
+#include <ossia/network/base/protocol.hpp>
+#include <ossia/network/timer_wheel.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ossia::net
+{
+struct coalescing_configuration
+{
+  //! Minimum time between two values sent for a parameter
+  std::chrono::milliseconds period{10};
+
+  //! Periods of some parameters, by OSC address, e.g. {"/foo/bar", 50ms}
+  std::vector<std::pair<std::string, std::chrono::milliseconds>> overrides;
+
+  //! The values of a flush are sent in a single bundle
+  bool bundle{false};
+};
+
+/**
+ * @brief Limits the rate of the values sent by a protocol.
+ *
+ * Unlike rate_limiting_protocol, which runs a thread for each device, the
+ * values are flushed by a timer_wheel shared by every device of a
+ * network_context. Only the last value pushed to a parameter during a period
+ * is sent: values pushed more often are coalesced.
+ *
+ * The parameters are grouped by period, and each group is an entry of the
+ * wheel. Once a parameter has been pushed, sending its values does not
+ * allocate.
+ *
+ * With bundle, the wrapped protocol gets a push_bundle of the parameters:
+ * it sends their current value, which is the last one pushed.
+ */
+class OSSIA_EXPORT coalescing_protocol final
+    : public ossia::net::protocol_base
+{
+public:
+  using duration = timer_wheel::clock::duration;
+
+  coalescing_protocol(
+      std::shared_ptr<timer_wheel> wheel, coalescing_configuration conf,
+      std::unique_ptr<protocol_base> arg);
+  ~coalescing_protocol() override;
+
+  //! Changes the period of the parameters without an override
+  void set_period(duration d);
+
+  //! Overrides the period of a parameter
+  void set_period(const ossia::net::parameter_base& p, duration d);
+  void reset_period(const ossia::net::parameter_base& p);
+
+  protocol_base& wrapped() const noexcept { return *m_protocol; }
+
+private:
+  struct group;
+  struct slot
+  {
+    const ossia::net::parameter_base* parameter{};
+    ossia::value value;
+    group* owner{};
+    bool dirty{};
+  };
+
+  bool pull(ossia::net::parameter_base&) override;
+  bool push(const ossia::net::parameter_base& addr, const ossia::value& v) override;
+  bool push(const ossia::net::parameter_base& addr, ossia::value&& v) override;
+  bool push_raw(const full_parameter_data&) override;
+  bool echo_incoming_message(
+      const message_origin_identifier&, const parameter_base&,
+      const ossia::value& v) override;
+  bool observe(ossia::net::parameter_base&, bool) override;
+  bool update(ossia::net::node_base& node_base) override;
+
+  void set_logger(const network_logger& l) override;
+  const network_logger& get_logger() const noexcept override;
+
+  void stop() override;
+  void set_device(ossia::net::device_base& dev) override;
+
+  void parameter_removed(const ossia::net::parameter_base& b);
+
+  template <typename T>
+  bool push_impl(const ossia::net::parameter_base& addr, T&& v);
+  std::size_t find_slot(const ossia::net::parameter_base& p);
+  group* find_group(duration d);
+  group* configured_group(const ossia::net::parameter_base& p);
+  void flush(group& g) noexcept;
+
+  std::shared_ptr<timer_wheel> m_wheel;
+  std::unique_ptr<ossia::net::protocol_base> m_protocol;
+  ossia::net::device_base* m_device{};
+  const bool m_bundle{};
+  ossia::fast_hash_map<std::string, duration> m_overrides;
+
+  // Taken to push: the slots and the lists of dirty slots
+  std::mutex m_mutex;
+  std::vector<slot> m_slots;
+  std::vector<std::size_t> m_free;
+  ossia::fast_hash_map<const ossia::net::parameter_base*, std::size_t> m_index;
+  std::vector<std::unique_ptr<group>> m_groups;
+  group* m_default{};
+
+  // Taken while the values are sent, so that their parameters are not
+  // removed meanwhile. Always taken before m_mutex.
+  std::mutex m_flushMutex;
+  std::vector<std::pair<const ossia::net::parameter_base*, ossia::value>> m_flush;
+  std::vector<const ossia::net::parameter_base*> m_flushBundle;
+};
+
+template <typename Protocol, typename... Args>
+auto coalesce_output(
+    std::shared_ptr<timer_wheel> wheel, coalescing_configuration conf,
+    Args&&... args)
+{
+  return std::make_unique<coalescing_protocol>(
+      std::move(wheel), std::move(conf),
+      std::make_unique<Protocol>(std::forward<Args>(args)...));
+}
+}
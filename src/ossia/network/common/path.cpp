@@ -6,6 +6,7 @@
 #include <ossia/network/base/node_functions.hpp>
 #include <ossia/network/base/parameter.hpp>
 #include <ossia/network/common/path.hpp>
+#include <ossia/network/common/pattern_matcher.hpp>
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -14,7 +15,8 @@
 
 #include <tsl/hopscotch_set.h>
 
-#include <regex>
+#include <memory>
+#include <mutex>
 
 namespace ossia
 {
@@ -85,13 +87,13 @@ void get_all_children(std::vector<ossia::net::node_base*>& vec)
   get_all_children_rec(vec, inserted);
 }
 
-void match_device_with_regex(
-    std::vector<ossia::net::node_base*>& vec, const std::regex& r)
+void match_device_with_pattern(
+    std::vector<ossia::net::node_base*>& vec, const pattern_matcher& m)
 {
   for (auto it = vec.cbegin(); it != vec.cend();)
   {
     const auto& name = (*it)->get_device().get_name();
-    if (!std::regex_match(name, r))
+    if (!m(name))
       it = vec.erase(it);
     else
       ++it;
@@ -110,8 +112,8 @@ void match_device_simple(
   }
 }
 
-void match_with_regex(
-    std::vector<ossia::net::node_base*>& vec, const std::regex& r)
+void match_with_pattern(
+    std::vector<ossia::net::node_base*>& vec, const pattern_matcher& m)
 {
   ossia::small_vector<ossia::net::node_base*, 16> old(vec.begin(), vec.end());
   vec.clear();
@@ -120,7 +122,7 @@ void match_with_regex(
   {
     for (auto& cld : node->children())
     {
-      if (std::regex_match(cld->get_name(), r))
+      if (m(cld->get_name()))
       {
         vec.push_back(cld.get());
       }
@@ -146,15 +148,15 @@ void match_simple(
   }
 }
 
-struct regex_cache
+struct pattern_cache
 {
-  static regex_cache& instance()
+  static pattern_cache& instance()
   {
-    static regex_cache c;
+    static pattern_cache c;
     return c;
   }
 
-  ossia::string_map<std::regex> map;
+  ossia::string_map<std::shared_ptr<const pattern_matcher>> map;
   std::mutex mutex;
 };
 
@@ -191,23 +193,27 @@ std::string substitute_characters(const std::string& part)
   return res;
 }
 
-std::regex make_regex(std::string& part)
+std::shared_ptr<const pattern_matcher> make_pattern(std::string part)
 {
-  // Perform the various regex-like replacements
-  // note: seriously, don't do this with regex if possible
-  net::expand_ranges(part);
-  std::string res = "^";
-  res += substitute_characters(part);
-  res += "$";
+  auto& cache = pattern_cache::instance();
+  std::lock_guard<std::mutex> _(cache.mutex);
+
+  auto it = cache.map.find(part);
+  if (it != cache.map.end())
+    return it->second;
 
-  return std::regex{res};
+  std::string orig = part;
+  net::expand_ranges(part);
+  auto m = std::make_shared<const pattern_matcher>(part);
+  cache.map.insert(std::make_pair(std::move(orig), m));
+  return m;
 }
 
-constexpr bool is_regex(std::string_view v)
+constexpr bool is_wildcard(std::string_view v)
 {
   for(char c : v)
   {
-    if(c == '(' || c == '{' || c == '[' || c == '*' || c == '?' || c == '^' || c == '$' || c == '\\' || c == '/' || c == '.' || c == ',' || c == '!')
+    if(c == '?' || c == '*' || c == '[' || c == ']' || c == '{' || c == '}' || c == '!')
     {
       return true;
     }
@@ -217,30 +223,14 @@ constexpr bool is_regex(std::string_view v)
 
 void add_device_part(std::string part, path& p)
 {
-  // TODO LRU cache
-  if(!is_regex(part))
+  if(!is_wildcard(part))
   {
     p.child_functions.push_back([=, p = std::move(part)](auto& v) { match_device_simple(v, p); });
   }
   else
   {
-    auto& map = regex_cache::instance();
-    std::lock_guard<std::mutex> _(map.mutex);
-
-    auto it = map.map.find(part);
-    if (it != map.map.end())
-    {
-      p.child_functions.push_back(
-          [r = it->second](auto& v) { match_device_with_regex(v, r); });
-    }
-    else
-    {
-      std::string orig = part;
-
-      std::regex r = make_regex(part);
-      p.child_functions.push_back([=](auto& v) { match_device_with_regex(v, r); });
-      map.map.insert(std::make_pair(std::move(orig), std::move(r)));
-    }
+    p.child_functions.push_back(
+        [m = make_pattern(std::move(part))](auto& v) { match_device_with_pattern(v, *m); });
   }
 }
 
@@ -249,31 +239,14 @@ void add_relative_path(std::string& part, path& p)
   using namespace std::literals;
   if (part != ".."sv)
   {
-    if(!is_regex(part))
+    if(!is_wildcard(part))
     {
       p.child_functions.push_back([p = std::move(part)](auto& v) { match_simple(v, p); });
     }
     else
     {
-      // TODO LRU cache
-      auto& map = regex_cache::instance();
-      std::lock_guard<std::mutex> _(map.mutex);
-
-      auto it = map.map.find(part);
-      if (it != map.map.end())
-      {
-        p.child_functions.push_back(
-            [r = it->second](auto& v) { match_with_regex(v, r); });
-      }
-      else
-      {
-        std::string orig = part;
-
-        std::regex r = make_regex(part);
-
-        p.child_functions.push_back([=](auto& v) { match_with_regex(v, r); });
-        map.map.insert(std::make_pair(std::move(orig), std::move(r)));
-      }
+      p.child_functions.push_back(
+          [m = make_pattern(std::move(part))](auto& v) { match_with_pattern(v, *m); });
     }
   }
   else
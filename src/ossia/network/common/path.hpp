@@ -178,19 +178,20 @@ inline path_element operator/(const path_element& lhs, const stop& rhs)
  * //bin/bo??o/bee
  * buz:/{bee,boo}*
  *
- * We have a translation phase :
- * Let [:ossia:] be the regex character class defined by
+ * Each part is compiled once into a pattern_matcher.
+ * Let [:ossia:] be the character class defined by
  * ossia::net::name_characters()
- * "?"      -> [:ossia:]?
- * "*"      -> [:ossia:]*
+ * "?"      -> zero or one [:ossia:]
+ * "*"      -> any number of [:ossia:]
  * "!"      -> any_instance()
  * "//"     -> any_path() /
  * ".."     -> get_parent()
- * "{1..5}" -> get_range()
- * "[..]"   -> already handled by the regex engine.
- * "{a,b}"  -> "(a|b)"
+ * "{1..5}" -> expanded to {1,2,3,4,5}
+ * "[a-z]"  -> a character class, "[!a-z]" for its complement
+ * "{a,b}"  -> either a or b
  *
- * All given paths are ended by "$"
+ * Parts are always matched against the whole node name,
+ * and the other characters, including ".", are matched literally.
  *
  * Given a path in the "user" format :
  * First try to find the largest absolute part from the beginning.
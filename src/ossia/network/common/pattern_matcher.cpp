@@ -0,0 +1,547 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check
+// it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <ossia/detail/small_vector.hpp>
+#include <ossia/network/base/name_validation.hpp>
+#include <ossia/network/common/pattern_matcher.hpp>
+#include <ossia/network/exceptions.hpp>
+
+#include <algorithm>
+
+namespace ossia
+{
+namespace traversal
+{
+namespace
+{
+// Past this many expanded literals, a program is smaller than the set.
+static constexpr std::size_t max_literals = 4096;
+
+// The NFA states are stored as a bit mask when building the DFA
+static constexpr std::size_t max_nfa_states = 64;
+static constexpr std::size_t max_dfa_states = 1024;
+
+// Characters which delimit the literal prefix and suffix of a pattern
+static constexpr std::string_view special_characters = "?*[]!{}";
+
+std::array<uint64_t, 4> make_set(std::string_view ranges) noexcept
+{
+  std::array<uint64_t, 4> s{};
+  auto add = [&](uint8_t c) { s[c >> 6] |= uint64_t(1) << (c & 63); };
+  for (std::size_t i = 0, N = ranges.size(); i < N; i++)
+  {
+    if (i + 2 < N && ranges[i + 1] == '-')
+    {
+      for (int c = uint8_t(ranges[i]); c <= uint8_t(ranges[i + 2]); c++)
+        add(uint8_t(c));
+      i += 2;
+    }
+    else
+    {
+      add(ranges[i]);
+    }
+  }
+  return s;
+}
+
+bool contains(const std::array<uint64_t, 4>& s, uint8_t c) noexcept
+{
+  return (s[c >> 6] >> (c & 63)) & 1;
+}
+
+const std::array<uint64_t, 4>& name_set() noexcept
+{
+  static const auto s = make_set(ossia::net::name_characters());
+  return s;
+}
+
+const std::array<uint64_t, 4>& instance_set() noexcept
+{
+  static const auto s = make_set(ossia::net::name_characters_no_instance());
+  return s;
+}
+
+[[noreturn]] void
+throw_malformed(std::string_view pattern, const char* reason)
+{
+  throw ossia::parse_error{
+      std::string("Malformed pattern '") + std::string(pattern) + "': "
+      + reason};
+}
+
+// Expands the {a,b} alternatives of a pattern which has no wildcard.
+// Returns false if there would be too many literals.
+bool expand_sequence(
+    std::string_view pattern, std::size_t& pos, bool in_braces,
+    std::vector<std::string>& res);
+
+bool expand_alternatives(
+    std::string_view pattern, std::size_t& pos,
+    std::vector<std::string>& res)
+{
+  res.clear();
+  for (;;)
+  {
+    std::vector<std::string> alt;
+    if (!expand_sequence(pattern, pos, true, alt))
+      return false;
+    if (pos >= pattern.size())
+      throw_malformed(pattern, "unterminated '{'");
+
+    res.insert(
+        res.end(), std::make_move_iterator(alt.begin()),
+        std::make_move_iterator(alt.end()));
+    if (res.size() > max_literals)
+      return false;
+
+    if (pattern[pos++] == '}')
+      return true;
+  }
+}
+
+bool expand_sequence(
+    std::string_view pattern, std::size_t& pos, bool in_braces,
+    std::vector<std::string>& res)
+{
+  res.assign(1, std::string{});
+  std::vector<std::string> alts;
+  while (pos < pattern.size())
+  {
+    const char c = pattern[pos];
+    if (c == '{')
+    {
+      ++pos;
+      if (!expand_alternatives(pattern, pos, alts))
+        return false;
+      if (res.size() * alts.size() > max_literals)
+        return false;
+
+      std::vector<std::string> product;
+      product.reserve(res.size() * alts.size());
+      for (const auto& head : res)
+        for (const auto& tail : alts)
+          product.push_back(head + tail);
+      res = std::move(product);
+    }
+    else if (in_braces && (c == ',' || c == '}'))
+    {
+      break;
+    }
+    else if (c == '}')
+    {
+      throw_malformed(pattern, "unbalanced '}'");
+    }
+    else
+    {
+      for (auto& str : res)
+        str += c;
+      ++pos;
+    }
+  }
+  return true;
+}
+}
+
+pattern_matcher::pattern_matcher(std::string_view pattern)
+{
+  const auto wildcards = std::count_if(
+      pattern.begin(), pattern.end(),
+      [](char c) { return c == '?' || c == '*' || c == '[' || c == '!'; });
+  const auto braces = std::count_if(
+      pattern.begin(), pattern.end(),
+      [](char c) { return c == '{' || c == '}'; });
+
+  if (wildcards == 0)
+  {
+    std::size_t pos = 0;
+    if (expand_sequence(pattern, pos, false, m_literals))
+    {
+      std::sort(m_literals.begin(), m_literals.end());
+      m_literals.erase(
+          std::unique(m_literals.begin(), m_literals.end()),
+          m_literals.end());
+      m_kind = kind::literals;
+      return;
+    }
+    m_literals.clear();
+  }
+  else if (
+      wildcards == 1 && braces == 0
+      && pattern.find('*') != std::string_view::npos)
+  {
+    const auto star = pattern.find('*');
+    m_prefix = pattern.substr(0, star);
+    m_suffix = pattern.substr(star + 1);
+    m_kind = kind::star;
+    return;
+  }
+
+  compile_program(pattern);
+}
+
+void pattern_matcher::compile_program(std::string_view pattern)
+{
+  const auto first = pattern.find_first_of(special_characters);
+  const auto last = pattern.find_last_of(special_characters);
+  if (first != std::string_view::npos)
+  {
+    m_prefix = pattern.substr(0, first);
+    m_suffix = pattern.substr(last + 1);
+  }
+
+  m_program.reserve(pattern.size() + 8);
+  compile_sequence(pattern, 0, false);
+  emit({instruction::match});
+  m_kind = kind::program;
+
+  compile_dfa();
+}
+
+void pattern_matcher::compile_dfa()
+{
+  const auto N = m_program.size();
+  if (N > max_nfa_states)
+    return;
+
+  auto bit = [](std::size_t pc) { return uint64_t(1) << pc; };
+
+  // Epsilon-closure of each instruction, restricted to the instructions
+  // which consume a character or accept the name.
+  std::vector<uint64_t> closure(N);
+  for (std::size_t pc = 0; pc < N; pc++)
+  {
+    uint64_t visited = 0;
+    ossia::small_vector<int32_t, 16> stack{int32_t(pc)};
+    while (!stack.empty())
+    {
+      const auto cur = stack.back();
+      stack.pop_back();
+      if (visited & bit(cur))
+        continue;
+      visited |= bit(cur);
+
+      const auto& i = m_program[cur];
+      if (i.op == instruction::split)
+      {
+        stack.push_back(i.x);
+        stack.push_back(i.y);
+      }
+      else if (i.op == instruction::jump)
+      {
+        stack.push_back(i.x);
+      }
+      else
+      {
+        closure[pc] |= bit(cur);
+      }
+    }
+  }
+
+  // Characters accepted by exactly the same instructions are equivalent
+  std::vector<uint64_t> class_accept;
+  for (int c = 0; c < 256; c++)
+  {
+    uint64_t accept = 0;
+    for (std::size_t pc = 0; pc < N; pc++)
+    {
+      const auto& i = m_program[pc];
+      if ((i.op == instruction::character && i.c == c)
+          || (i.op == instruction::set && contains(m_sets[i.x], uint8_t(c))))
+        accept |= bit(pc);
+    }
+
+    auto it = std::find(class_accept.begin(), class_accept.end(), accept);
+    m_classes[c] = uint8_t(it - class_accept.begin());
+    if (it == class_accept.end())
+      class_accept.push_back(accept);
+  }
+  m_class_count = int32_t(class_accept.size());
+
+  // Subset construction; -1 is the dead state.
+  std::vector<uint64_t> states{closure[m_prefix.size()]};
+  for (std::size_t s = 0; s < states.size(); s++)
+  {
+    if (states.size() > max_dfa_states)
+    {
+      m_dfa.clear();
+      return;
+    }
+
+    for (const uint64_t accept : class_accept)
+    {
+      uint64_t next = 0;
+      uint64_t active = states[s] & accept;
+      for (std::size_t pc = 0; active; pc++, active >>= 1)
+        if (active & 1)
+          next |= closure[pc + 1];
+
+      if (next == 0)
+      {
+        m_dfa.push_back(-1);
+        continue;
+      }
+
+      auto it = std::find(states.begin(), states.end(), next);
+      m_dfa.push_back(int16_t(it - states.begin()));
+      if (it == states.end())
+        states.push_back(next);
+    }
+  }
+
+  const uint64_t final_state = bit(N - 1);
+  m_accepting.reserve(states.size());
+  for (auto s : states)
+    m_accepting.push_back((s & final_state) != 0);
+
+  m_kind = kind::dfa;
+}
+
+int32_t pattern_matcher::emit(instruction i)
+{
+  m_program.push_back(i);
+  return int32_t(m_program.size() - 1);
+}
+
+int32_t pattern_matcher::add_set(const char_set& s)
+{
+  auto it = std::find(m_sets.begin(), m_sets.end(), s);
+  if (it != m_sets.end())
+    return int32_t(it - m_sets.begin());
+  m_sets.push_back(s);
+  return int32_t(m_sets.size() - 1);
+}
+
+std::size_t pattern_matcher::compile_sequence(
+    std::string_view pattern, std::size_t pos, bool in_braces)
+{
+  const int32_t name = add_set(name_set());
+  while (pos < pattern.size())
+  {
+    const char c = pattern[pos];
+    switch (c)
+    {
+      case '{':
+        pos = compile_alternatives(pattern, pos + 1);
+        continue;
+      case ',':
+      case '}':
+        if (in_braces)
+          return pos;
+        if (c == '}')
+          throw_malformed(pattern, "unbalanced '}'");
+        emit({instruction::character, uint8_t(c)});
+        break;
+      case '[':
+        pos = compile_set(pattern, pos + 1);
+        continue;
+      case '?':
+      {
+        // Zero or one character, like the historical regex translation
+        const auto s = emit({instruction::split});
+        emit({instruction::set, 0, name});
+        m_program[s].x = s + 1;
+        m_program[s].y = int32_t(m_program.size());
+        break;
+      }
+      case '*':
+      {
+        const auto s = emit({instruction::split});
+        emit({instruction::set, 0, name});
+        emit({instruction::jump, 0, s});
+        m_program[s].x = s + 1;
+        m_program[s].y = int32_t(m_program.size());
+        break;
+      }
+      case '!':
+      {
+        // An optional instance suffix : (\.[name_characters_no_instance]+)?
+        const auto s = emit({instruction::split});
+        emit({instruction::character, '.'});
+        const auto l = emit({instruction::set, 0, add_set(instance_set())});
+        emit({instruction::split, 0, l, l + 2});
+        m_program[s].x = s + 1;
+        m_program[s].y = int32_t(m_program.size());
+        break;
+      }
+      default:
+        emit({instruction::character, uint8_t(c)});
+        break;
+    }
+    ++pos;
+  }
+  return pos;
+}
+
+std::size_t pattern_matcher::compile_alternatives(
+    std::string_view pattern, std::size_t pos)
+{
+  ossia::small_vector<int32_t, 8> jumps;
+  for (;;)
+  {
+    const auto s = emit({instruction::split});
+    pos = compile_sequence(pattern, pos, true);
+    if (pos >= pattern.size())
+      throw_malformed(pattern, "unterminated '{'");
+
+    if (pattern[pos++] == ',')
+    {
+      jumps.push_back(emit({instruction::jump}));
+      m_program[s].x = s + 1;
+      m_program[s].y = int32_t(m_program.size());
+    }
+    else
+    {
+      // Last alternative: nothing left to try
+      m_program[s].op = instruction::jump;
+      m_program[s].x = s + 1;
+      break;
+    }
+  }
+
+  for (auto j : jumps)
+    m_program[j].x = int32_t(m_program.size());
+  return pos;
+}
+
+std::size_t
+pattern_matcher::compile_set(std::string_view pattern, std::size_t pos)
+{
+  const auto end = pattern.find(']', pos + 1);
+  if (end == std::string_view::npos)
+    throw_malformed(pattern, "unterminated '['");
+
+  bool negate = false;
+  if (pattern[pos] == '!' || pattern[pos] == '^')
+  {
+    negate = true;
+    ++pos;
+  }
+
+  auto s = make_set(pattern.substr(pos, end - pos));
+  if (negate)
+  {
+    for (auto& w : s)
+      w = ~w;
+  }
+
+  emit({instruction::set, 0, add_set(s)});
+  return end + 1;
+}
+
+bool pattern_matcher::operator()(std::string_view name) const noexcept
+{
+  switch (m_kind)
+  {
+    case kind::literals:
+      return std::binary_search(m_literals.begin(), m_literals.end(), name);
+
+    case kind::star:
+    {
+      const auto fixed = m_prefix.size() + m_suffix.size();
+      if (name.size() < fixed)
+        return false;
+      if (name.compare(0, m_prefix.size(), m_prefix) != 0)
+        return false;
+      if (name.compare(name.size() - m_suffix.size(), m_suffix.size(), m_suffix)
+          != 0)
+        return false;
+
+      const auto& set = name_set();
+      const auto end = name.size() - m_suffix.size();
+      for (auto i = m_prefix.size(); i < end; i++)
+        if (!contains(set, uint8_t(name[i])))
+          return false;
+      return true;
+    }
+
+    case kind::dfa:
+    case kind::program:
+    {
+      if (name.size() < m_prefix.size() + m_suffix.size())
+        return false;
+      if (name.compare(0, m_prefix.size(), m_prefix) != 0)
+        return false;
+      if (name.compare(name.size() - m_suffix.size(), m_suffix.size(), m_suffix)
+          != 0)
+        return false;
+      return m_kind == kind::dfa ? match_dfa(name) : match_program(name);
+    }
+  }
+  return false;
+}
+
+bool pattern_matcher::match_dfa(std::string_view name) const noexcept
+{
+  int32_t state = 0;
+  for (std::size_t k = m_prefix.size(); k < name.size(); k++)
+  {
+    state = m_dfa[state * m_class_count + m_classes[uint8_t(name[k])]];
+    if (state < 0)
+      return false;
+  }
+  return m_accepting[state];
+}
+
+bool pattern_matcher::match_program(std::string_view name) const noexcept
+{
+  // Pike VM: all the threads advance in lockstep on each character,
+  // so the match time is linear in the name length.
+  ossia::small_vector<int32_t, 32> lists[2], stack;
+  ossia::small_vector<uint32_t, 64> marks(m_program.size(), 0);
+  uint32_t generation = 1;
+
+  auto add_thread = [&](auto& list, int32_t pc) {
+    stack.push_back(pc);
+    while (!stack.empty())
+    {
+      pc = stack.back();
+      stack.pop_back();
+      if (marks[pc] == generation)
+        continue;
+      marks[pc] = generation;
+
+      const auto& i = m_program[pc];
+      switch (i.op)
+      {
+        case instruction::split:
+          stack.push_back(i.y);
+          stack.push_back(i.x);
+          break;
+        case instruction::jump:
+          stack.push_back(i.x);
+          break;
+        default:
+          list.push_back(pc);
+          break;
+      }
+    }
+  };
+
+  // The literal prefix has already been checked and is always
+  // compiled to the first instructions.
+  add_thread(lists[m_prefix.size() & 1], int32_t(m_prefix.size()));
+  for (std::size_t k = m_prefix.size(); k < name.size(); k++)
+  {
+    auto& current = lists[k & 1];
+    auto& next = lists[(k + 1) & 1];
+    if (current.empty())
+      return false;
+
+    ++generation;
+    const auto c = uint8_t(name[k]);
+    for (int32_t pc : current)
+    {
+      const auto& i = m_program[pc];
+      if ((i.op == instruction::character && i.c == c)
+          || (i.op == instruction::set && contains(m_sets[i.x], c)))
+        add_thread(next, pc + 1);
+    }
+    current.clear();
+  }
+
+  for (int32_t pc : lists[name.size() & 1])
+    if (m_program[pc].op == instruction::match)
+      return true;
+  return false;
+}
+}
+}
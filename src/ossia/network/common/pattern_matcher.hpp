@@ -0,0 +1,91 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ossia
+{
+namespace traversal
+{
+/**
+ * @brief Matches node names against a single part of an address pattern.
+ *
+ * The part is compiled once, when the path is built, in one of four forms :
+ * - a sorted set of literals, when the pattern only has {a,b} alternatives
+ *   (this covers the {1..5} ranges once they have been expanded),
+ * - a literal prefix and suffix around a single "*",
+ * - a DFA built from the NFA of the pattern, over classes of equivalent
+ *   characters, when it stays small,
+ * - otherwise the NFA itself, simulated by a Pike virtual machine
+ *   in linear time.
+ *
+ * The supported syntax is the one documented in \ref ossia::traversal :
+ * "?", "*", "[a-z]", "[!a-z]", "{a,b}" and "!" for instances.
+ * All the other characters, including ".", are matched literally.
+ *
+ * Matching does not allocate for the usual pattern sizes and is safe to call
+ * concurrently.
+ */
+class OSSIA_EXPORT pattern_matcher
+{
+public:
+  //! Compiles a pattern part. Ranges such as {1..5} must already be expanded.
+  //! Throws ossia::parse_error if the pattern is malformed.
+  explicit pattern_matcher(std::string_view pattern);
+
+  bool operator()(std::string_view name) const noexcept;
+
+private:
+  using char_set = std::array<uint64_t, 4>;
+  struct instruction
+  {
+    enum : uint8_t
+    {
+      character,
+      set,
+      split,
+      jump,
+      match
+    } op{};
+    uint8_t c{};
+    int32_t x{};
+    int32_t y{};
+  };
+
+  enum class kind : uint8_t
+  {
+    literals,
+    star,
+    dfa,
+    program
+  };
+
+  void compile_program(std::string_view pattern);
+  std::size_t compile_sequence(std::string_view pattern, std::size_t pos, bool in_braces);
+  std::size_t compile_alternatives(std::string_view pattern, std::size_t pos);
+  std::size_t compile_set(std::string_view pattern, std::size_t pos);
+  int32_t add_set(const char_set& s);
+  int32_t emit(instruction i);
+  void compile_dfa();
+
+  bool match_dfa(std::string_view name) const noexcept;
+  bool match_program(std::string_view name) const noexcept;
+
+  std::vector<std::string> m_literals;
+  std::vector<instruction> m_program;
+  std::vector<char_set> m_sets;
+  std::vector<int16_t> m_dfa;
+  std::vector<uint8_t> m_accepting;
+  std::array<uint8_t, 256> m_classes{};
+  int32_t m_class_count{};
+  std::string m_prefix;
+  std::string m_suffix;
+  kind m_kind{};
+};
+
+}
+}
@@ -55,9 +55,12 @@ node_base& generic_node_base::set_name(std::string name)
   auto old_name = std::move(m_name);
   if (m_parent)
   {
-    read_lock_t lock{m_mutex};
-    sanitize_name(name, m_parent->unsafe_children());
-    m_name = name;
+    {
+      read_lock_t lock{m_mutex};
+      sanitize_name(name, m_parent->unsafe_children());
+      m_name = name;
+    }
+    m_parent->on_child_renamed(*this, old_name);
   }
   else
   {
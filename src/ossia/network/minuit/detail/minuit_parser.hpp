@@ -1,5 +1,6 @@
 #pragma once
 #include <ossia/detail/small_vector.hpp>
+#include <ossia/network/base/address_index.hpp>
 #include <ossia/network/base/device.hpp>
 #include <ossia/network/base/node_attributes.hpp>
 #include <ossia/network/dataspace/dataspace_visitors.hpp>
@@ -389,16 +390,19 @@ struct minuit_behavior<minuit_command::Answer, minuit_operation::Listen>
     if (idx == std::string::npos)
     {
       // The OSC message is a standard OSC one, carrying a value.
-      auto node = ossia::net::find_node(dev.get_root_node(), full_address);
-      if (node)
+      auto addr = ossia::net::find_indexed_parameter(dev, full_address);
+      if (!addr)
       {
-        if (auto addr = node->get_parameter())
+        if (auto node = ossia::net::find_node(dev.get_root_node(), full_address))
+          addr = node->get_parameter();
+      }
+
+      if (addr)
+      {
+        if(auto v = ossia::net::get_filtered_value(
+            *addr, ++mess_it, mess.ArgumentsEnd(), mess.ArgumentCount() - 1); v.valid())
         {
-          if(auto v = ossia::net::get_filtered_value(
-              *addr, ++mess_it, mess.ArgumentsEnd(), mess.ArgumentCount() - 1); v.valid())
-          {
-            addr->set_value(std::move(v));
-          }
+          addr->set_value(std::move(v));
         }
       }
     }
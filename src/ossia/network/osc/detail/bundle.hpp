@@ -7,19 +7,38 @@
 #include <ossia/detail/buffer_pool.hpp>
 #include <oscpack/osc/OscOutboundPacketStream.h>
 
+#include <algorithm>
+#include <cstring>
 #include <optional>
 
 
 namespace ossia::net
 {
+static inline auto& access_parameter(const ossia::net::parameter_base* p) { return *p; }
+static inline auto& access_parameter(const ossia::net::full_parameter_data& p) { return p; }
+static inline auto& access_parameter(const ossia::net::bundle_element& e) { return *e.parameter; }
+
+template<typename Addr_T, typename Element>
+ossia::value bundle_value(const Addr_T& addr, const Element&)
+{
+  return filter_value(addr, addr.value());
+}
+
+// The value may not be the current one of the parameter anymore
+static inline ossia::value bundle_value(
+    const ossia::net::parameter_base& addr, const ossia::net::bundle_element& e)
+{
+  return filter_value(addr.get_domain(), e.value, addr.get_bounding());
+}
 
 template<typename OscPolicy>
 struct bundle_common_policy
 {
-  template<typename Addr_T>
-  void operator()(oscpack::OutboundPacketStream& str, ossia::value& val, const Addr_T& addr)
+  template<typename Element>
+  void operator()(oscpack::OutboundPacketStream& str, ossia::value& val, const Element& e)
   {
-    if (val = filter_value(addr, addr.value()); val.valid())
+    auto& addr = access_parameter(e);
+    if (val = bundle_value(addr, e); val.valid())
     {
       str << oscpack::BeginMessageN(osc_address(addr));
       val.apply(typename OscPolicy::dynamic_policy{{str, addr.get_unit()}});
@@ -31,22 +50,19 @@ struct bundle_common_policy
 template<typename OscPolicy>
 struct bundle_client_policy
 {
-  template<typename Addr_T>
-  void operator()(oscpack::OutboundPacketStream& str, ossia::value& val, const Addr_T& addr)
+  template<typename Element>
+  void operator()(oscpack::OutboundPacketStream& str, ossia::value& val, const Element& e)
   {
-    if (addr.get_access() == ossia::access_mode::GET)
+    if (access_parameter(e).get_access() == ossia::access_mode::GET)
       return;
 
-    bundle_common_policy<OscPolicy>{}(str, val, addr);
+    bundle_common_policy<OscPolicy>{}(str, val, e);
   }
 };
 
 template<typename OscPolicy>
 using bundle_server_policy = bundle_common_policy<OscPolicy>;
 
-static inline auto& access_parameter(const ossia::net::parameter_base* p) { return *p; }
-static inline auto& access_parameter(const ossia::net::full_parameter_data& p) { return p; }
-
 struct bundle
 {
   ossia::buffer_pool::buffer data;
@@ -65,9 +81,8 @@ try
     ossia::value val;
     for (const auto& a : addresses)
     {
-      auto& param = access_parameter(a);
-      ret.critical |= param.get_critical();
-      add_element_to_bundle(str, val, param);
+      ret.critical |= access_parameter(a).get_critical();
+      add_element_to_bundle(str, val, a);
     }
     str << oscpack::EndBundle();
     ret.data.resize(str.Size());
@@ -94,4 +109,82 @@ catch (...)
   return {};
 }
 
+/**
+ * @brief Sends the addresses in as many bundles as needed
+ *
+ * The messages are packed in order in bundles of at most max_size bytes,
+ * each of them being passed to the writer.
+ * A message which does not fit in max_size is sent alone in its bundle.
+ */
+template<typename NetworkPolicy, typename Addresses, typename Writer>
+bool write_bundles(
+    NetworkPolicy add_element_to_bundle, const Addresses& addresses,
+    Writer writer, std::size_t max_size = max_osc_bundle_size)
+{
+  // "#bundle" followed by the "immediately" time tag
+  static constexpr char header[16]
+      = {'#', 'b', 'u', 'n', 'd', 'l', 'e', '\0', 0, 0, 0, 0, 0, 0, 0, 1};
+
+  auto& pool = ossia::buffer_pool::instance();
+  auto message = pool.acquire(max_osc_message_size);
+  auto packet = pool.acquire(
+      std::max(max_size, sizeof(header) + 4 + max_osc_message_size));
+  std::memcpy(packet.data(), header, sizeof(header));
+  std::size_t packet_size = sizeof(header);
+
+  auto flush = [&] {
+    if (packet_size > sizeof(header))
+    {
+      writer(packet.data(), packet_size);
+      packet_size = sizeof(header);
+    }
+  };
+
+  bool ok = false;
+  ossia::value val;
+  for (const auto& a : addresses)
+  {
+    std::size_t message_size{};
+    try
+    {
+      oscpack::OutboundPacketStream str(message.data(), max_osc_message_size);
+      add_element_to_bundle(str, val, a);
+      message_size = str.Size();
+    }
+    catch (const oscpack::OutOfBufferMemoryException&)
+    {
+      ossia::logger().error(
+          "write_bundles: message too large (limit is {} bytes)",
+          max_osc_message_size);
+      continue;
+    }
+    catch (const std::runtime_error& e)
+    {
+      ossia::logger().error("write_bundles: {}", e.what());
+      continue;
+    }
+
+    if (message_size == 0)
+      continue;
+
+    if (packet_size + 4 + message_size > max_size)
+      flush();
+
+    // Bundle elements are prefixed by their big-endian size
+    auto out = packet.data() + packet_size;
+    out[0] = char((message_size >> 24) & 0xFF);
+    out[1] = char((message_size >> 16) & 0xFF);
+    out[2] = char((message_size >> 8) & 0xFF);
+    out[3] = char(message_size & 0xFF);
+    std::memcpy(out + 4, message.data(), message_size);
+    packet_size += 4 + message_size;
+    ok = true;
+  }
+  flush();
+
+  pool.release(std::move(message));
+  pool.release(std::move(packet));
+  return ok;
+}
+
 }
@@ -17,6 +17,10 @@ namespace ossia::net
 
 constexpr int max_osc_message_size = 65507;
 
+//! Ethernet MTU minus the IPv4 and UDP headers:
+//! bundles up to this size are sent without fragmentation.
+constexpr int max_osc_bundle_size = 1472;
+
 struct buffer_packed_osc_stream
 {
   std::unique_ptr<char[]> buffer;
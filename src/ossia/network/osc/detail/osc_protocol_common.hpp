@@ -127,12 +127,7 @@ struct osc_protocol_client : osc_protocol_common<OscVersion>
   template<typename T, typename Writer, typename Addresses>
   static bool push_bundle(T& self, Writer writer, const Addresses& addresses)
   {
-    if(auto bundle = make_bundle(bundle_client_policy<OscVersion>{}, addresses)) {
-      writer(bundle->data.data(), bundle->data.size());
-      ossia::buffer_pool::instance().release(std::move(bundle->data));
-      return true;
-    }
-    return false;
+    return write_bundles(bundle_client_policy<OscVersion>{}, addresses, writer);
   }
 };
 
@@ -155,12 +150,7 @@ struct osc_protocol_server : osc_protocol_common<OscVersion>
   template<typename T, typename Writer, typename Addresses>
   static bool push_bundle(T& self, Writer writer, const Addresses& addresses)
   {
-    if(auto bundle = make_bundle(bundle_server_policy<OscVersion>{}, addresses)) {
-      writer(bundle->data.data(), bundle->data.size());
-      ossia::buffer_pool::instance().release(std::move(bundle->data));
-      return true;
-    }
-    return false;
+    return write_bundles(bundle_server_policy<OscVersion>{}, addresses, writer);
   }
 };
 
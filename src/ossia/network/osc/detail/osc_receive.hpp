@@ -1,5 +1,6 @@
 #pragma once
 #include <ossia/detail/logger.hpp>
+#include <ossia/network/base/address_index.hpp>
 #include <ossia/network/base/device.hpp>
 #include <ossia/network/base/listening.hpp>
 #include <ossia/network/base/message_origin_identifier.hpp>
@@ -87,6 +88,13 @@ void on_input_message(
   {
     f.on_listened_value(**addr, dev, logger);
   }
+  else if (auto param = find_indexed_parameter(dev, addr_txt))
+  {
+    if constexpr (!SilentUpdate)
+      f.on_value(*param, dev);
+    else
+      f.on_value_quiet(*param, dev);
+  }
   else
   {
     // We still want to save the value even if it is not listened to.
@@ -188,23 +188,31 @@ bool osc_protocol::push_raw(const ossia::net::full_parameter_data& addr)
 bool osc_protocol::push_bundle(
     const std::vector<const parameter_base*>& addresses)
 {
-  if(auto bundle = make_bundle(bundle_server_policy<osc_1_0_policy>{}, addresses)) {
-    m_sender->socket().Send(bundle->data.data(), bundle->data.size());
-    ossia::buffer_pool::instance().release(std::move(bundle->data));
-    return true;
-  }
-  return false;
+  return write_bundles(
+      bundle_server_policy<osc_1_0_policy>{}, addresses,
+      [this](const char* data, std::size_t sz) {
+        m_sender->socket().Send(data, sz);
+      });
 }
 
 bool osc_protocol::push_raw_bundle(
     const std::vector<ossia::net::full_parameter_data>& addresses)
 {
-  if(auto bundle = make_bundle(bundle_server_policy<osc_1_0_policy>{}, addresses)) {
-    m_sender->socket().Send(bundle->data.data(), bundle->data.size());
-    ossia::buffer_pool::instance().release(std::move(bundle->data));
-    return true;
-  }
-  return false;
+  return write_bundles(
+      bundle_server_policy<osc_1_0_policy>{}, addresses,
+      [this](const char* data, std::size_t sz) {
+        m_sender->socket().Send(data, sz);
+      });
+}
+
+bool osc_protocol::push_bundle_values(
+    const std::vector<ossia::net::bundle_element>& values)
+{
+  return write_bundles(
+      bundle_server_policy<osc_1_0_policy>{}, values,
+      [this](const char* data, std::size_t sz) {
+        m_sender->socket().Send(data, sz);
+      });
 }
 
 bool osc_protocol::observe(ossia::net::parameter_base& address, bool enable)
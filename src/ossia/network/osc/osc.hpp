@@ -61,6 +61,7 @@ public:
   bool
   push_bundle(const std::vector<const ossia::net::parameter_base*>&) override;
   bool push_raw_bundle(const std::vector<full_parameter_data>&) override;
+  bool push_bundle_values(const std::vector<bundle_element>&) override;
 
   bool
   observe(ossia::net::parameter_base& parameter_base, bool enable) override;
@@ -12,6 +12,8 @@
 namespace ossia::net
 {
 struct rate_limiter;
+//! Runs a thread for each instance: coalescing_protocol shares a single
+//! timer_wheel between the devices of a network_context.
 class OSSIA_EXPORT rate_limiting_protocol final
     : public ossia::net::protocol_base
 {
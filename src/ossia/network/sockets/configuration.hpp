@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <optional>
@@ -33,6 +34,8 @@ struct send_socket_configuration : socket_configuration
 };
 struct receive_socket_configuration : socket_configuration
 {
+  //! Larger datagrams are discarded when received by batches
+  std::size_t max_datagram_size{65535};
 };
 
 struct double_fd_configuration
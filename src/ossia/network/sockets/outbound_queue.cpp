@@ -0,0 +1,393 @@
+#include <ossia/network/sockets/outbound_queue.hpp>
+#include <ossia/detail/logger.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace ossia::net
+{
+static std::size_t queue_capacity(std::size_t depth) noexcept
+{
+  std::size_t n = 2;
+  while (n < depth)
+    n *= 2;
+  return n;
+}
+
+outbound_queue::outbound_queue(const outbound_queue_configuration& conf)
+    : m_slots(queue_capacity(conf.depth))
+    , m_data(m_slots.size() * conf.max_packet_size)
+    , m_mask{m_slots.size() - 1}
+    , m_max_packet_size{conf.max_packet_size}
+    , m_overflow{conf.overflow}
+    , m_period{conf.drain_period}
+{
+  for (std::size_t i = 0; i < m_slots.size(); i++)
+    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+outbound_queue::~outbound_queue() = default;
+
+void outbound_queue::lock(slot& s) noexcept
+{
+  while (s.busy.test_and_set(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+// Bounded MPMC ring: the sequence of a slot is its position when it is free
+// for a producer, and its position + 1 once the packet is published.
+bool outbound_queue::push(const char* data, std::size_t sz) noexcept
+{
+  std::size_t pos = m_tail.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    slot& s = m_slots[pos & m_mask];
+    const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+    const auto dif = intptr_t(seq) - intptr_t(pos);
+    if (dif == 0)
+    {
+      if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        std::memcpy(this->data(pos), data, sz);
+        s.size = uint32_t(sz);
+        s.sequence.store(pos + 1, std::memory_order_release);
+
+        const std::size_t depth
+            = pos + 1 - m_head.load(std::memory_order_relaxed);
+        std::size_t max = m_max_depth.load(std::memory_order_relaxed);
+        while (depth > max && depth <= m_slots.size()
+               && !m_max_depth.compare_exchange_weak(
+                   max, depth, std::memory_order_relaxed))
+          ;
+        return true;
+      }
+    }
+    else if (dif < 0)
+    {
+      return false;
+    }
+    else
+    {
+      pos = m_tail.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename F>
+bool outbound_queue::pop(F&& f)
+{
+  std::size_t pos = m_head.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    slot& s = m_slots[pos & m_mask];
+    const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+    const auto dif = intptr_t(seq) - intptr_t(pos + 1);
+    if (dif == 0)
+    {
+      if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        // A producer may be coalescing into the packet
+        lock(s);
+        f(this->data(pos), std::size_t(s.size));
+
+        // Coalescing checks the sequence: it must not see the packet as
+        // queued anymore once it can take the slot.
+        s.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        s.busy.clear(std::memory_order_release);
+        return true;
+      }
+    }
+    else if (dif < 0)
+    {
+      return false;
+    }
+    else
+    {
+      pos = m_head.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool outbound_queue::coalesce(const char* data, std::size_t sz) noexcept
+{
+  // Only messages have an address
+  if (sz == 0 || data[0] == '#')
+    return false;
+
+  auto address_end = static_cast<const char*>(std::memchr(data, 0, sz));
+  if (!address_end)
+    return false;
+  const std::size_t address_size = address_end - data + 1;
+
+  // The newest packets first
+  const std::size_t head = m_head.load(std::memory_order_acquire);
+  const std::size_t tail = m_tail.load(std::memory_order_acquire);
+  const std::size_t count = std::min(tail - head, m_slots.size());
+  for (std::size_t i = 1; i <= count; i++)
+  {
+    const std::size_t pos = tail - i;
+    slot& s = m_slots[pos & m_mask];
+    if (s.busy.test_and_set(std::memory_order_acquire))
+      continue;
+
+    const bool same
+        = s.sequence.load(std::memory_order_acquire) == pos + 1
+          && s.size >= address_size
+          && std::memcmp(this->data(pos), data, address_size) == 0;
+    if (same)
+    {
+      std::memcpy(this->data(pos), data, sz);
+      s.size = uint32_t(sz);
+    }
+    s.busy.clear(std::memory_order_release);
+
+    if (same)
+      return true;
+  }
+  return false;
+}
+
+bool outbound_queue::enqueue(const char* data, std::size_t sz) noexcept
+{
+  if (sz > m_max_packet_size)
+  {
+    increment(m_oversized);
+    return false;
+  }
+
+  if (push(data, sz))
+  {
+    wake();
+    return true;
+  }
+
+  switch (m_overflow)
+  {
+    case overflow_policy::drop_oldest:
+    {
+      // Other producers may take the freed slot first
+      for (int i = 0; i < 4; i++)
+      {
+        if (pop([](const char*, std::size_t) {}))
+          increment(m_dropped);
+        if (push(data, sz))
+        {
+          wake();
+          return true;
+        }
+      }
+      break;
+    }
+    case overflow_policy::coalesce:
+    {
+      if (coalesce(data, sz))
+      {
+        increment(m_coalesced);
+        return true;
+      }
+      break;
+    }
+    case overflow_policy::drop_newest:
+      break;
+  }
+
+  increment(m_dropped);
+  return true;
+}
+
+std::size_t outbound_queue::drain()
+{
+  // Bounded so that continuous producers do not keep the thread
+  const std::size_t max = m_slots.size();
+  std::size_t n = 0;
+  auto send = [this](const char* data, std::size_t sz) {
+    try
+    {
+      m_send(data, sz);
+      increment(m_sent);
+    }
+    catch (const std::exception& e)
+    {
+      increment(m_failed);
+      ossia::logger().error("[outbound_queue::drain]: {}", e.what());
+    }
+    catch (...)
+    {
+      increment(m_failed);
+      ossia::logger().error("[outbound_queue::drain]: unknown error");
+    }
+  };
+
+  while (n < max && pop(send))
+    n++;
+  return n;
+}
+
+std::size_t outbound_queue::drain_batches()
+{
+  const std::size_t max = m_slots.size();
+  std::size_t n = 0;
+  while (n < max)
+  {
+    // The packets are copied out so that their slots are freed at once
+    std::size_t count = 0;
+    char* out = m_batch_data.data();
+    auto copy = [&](const char* data, std::size_t sz) {
+      std::memcpy(out, data, sz);
+      m_batch[count++] = boost::asio::const_buffer{out, sz};
+      out += sz;
+    };
+    while (count < m_batch.size() && pop(copy))
+      ;
+
+    if (count == 0)
+      break;
+    n += count;
+
+    std::size_t sent = 0;
+    try
+    {
+      sent = std::min(m_batch_send(m_batch.data(), count), count);
+    }
+    catch (const std::exception& e)
+    {
+      ossia::logger().error("[outbound_queue::drain]: {}", e.what());
+    }
+    catch (...)
+    {
+      ossia::logger().error("[outbound_queue::drain]: unknown error");
+    }
+    m_sent.fetch_add(sent, std::memory_order_relaxed);
+    m_failed.fetch_add(count - sent, std::memory_order_relaxed);
+  }
+  return n;
+}
+
+void outbound_queue::start(
+    boost::asio::io_context& ctx, send_function send)
+{
+  if (m_send || m_batch_send)
+  {
+    ossia::logger().error("[outbound_queue::start]: already started");
+    return;
+  }
+  m_send = std::move(send);
+  start(ctx);
+}
+
+void outbound_queue::start(
+    boost::asio::io_context& ctx, batch_send_function send)
+{
+  if (m_send || m_batch_send)
+  {
+    ossia::logger().error("[outbound_queue::start]: already started");
+    return;
+  }
+  m_batch_send = std::move(send);
+
+  const std::size_t batch = std::min(max_batch, m_slots.size());
+  m_batch_data.resize(batch * m_max_packet_size);
+  m_batch.resize(batch);
+  start(ctx);
+}
+
+void outbound_queue::start(boost::asio::io_context& ctx)
+{
+  m_context.store(&ctx);
+  wake();
+}
+
+void outbound_queue::wake() noexcept
+{
+  // Paired with the end of a drain: either the drain sees the new packet,
+  // or this sees that the drain is not armed anymore.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_armed.load(std::memory_order_relaxed) || m_armed.exchange(true))
+    return;
+
+  auto ctx = m_context.load();
+  if (!ctx)
+  {
+    // Not started yet: start() wakes the queue
+    m_armed.store(false);
+    return;
+  }
+
+  try
+  {
+    // The timer lives in the handlers: it must not outlive the io_context
+    boost::asio::post(*ctx, [self = shared_from_this(), ctx] {
+      self->schedule(std::make_shared<boost::asio::steady_timer>(*ctx));
+    });
+  }
+  catch (...)
+  {
+    m_armed.store(false);
+  }
+}
+
+void outbound_queue::schedule(std::shared_ptr<boost::asio::steady_timer> timer)
+{
+  auto& t = *timer;
+  t.expires_after(m_period);
+  t.async_wait([self = shared_from_this(),
+                timer = std::move(timer)](boost::system::error_code ec) mutable {
+    if (ec)
+      return;
+
+    // Paired with stop(): either it sees the drain, or the drain sees it
+    self->m_draining.store(true);
+    if (self->m_stopped.load())
+    {
+      self->m_draining.store(false);
+      return;
+    }
+
+    if (self->m_batch_send)
+      self->drain_batches();
+    else
+      self->drain();
+    self->m_draining.store(false);
+
+    // Once drained, the timer lapses until the next packet is queued
+    if (self->depth() == 0)
+    {
+      self->m_armed.store(false);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (self->depth() == 0 || self->m_armed.exchange(true))
+        return;
+    }
+    self->schedule(std::move(timer));
+  });
+}
+
+void outbound_queue::stop() noexcept
+{
+  m_stopped.store(true);
+  while (m_draining.load())
+    std::this_thread::yield();
+}
+
+std::size_t outbound_queue::depth() const noexcept
+{
+  const std::size_t head = m_head.load(std::memory_order_relaxed);
+  const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+  return tail > head ? std::min(tail - head, m_slots.size()) : 0;
+}
+
+outbound_queue::counters outbound_queue::read() const noexcept
+{
+  counters c;
+  c.sent = m_sent.load(std::memory_order_relaxed);
+  c.dropped = m_dropped.load(std::memory_order_relaxed);
+  c.failed = m_failed.load(std::memory_order_relaxed);
+  c.coalesced = m_coalesced.load(std::memory_order_relaxed);
+  c.oversized = m_oversized.load(std::memory_order_relaxed);
+  c.depth = depth();
+  c.max_depth = m_max_depth.load(std::memory_order_relaxed);
+  return c;
+}
+}
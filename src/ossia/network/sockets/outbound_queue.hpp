@@ -0,0 +1,160 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ossia::net
+{
+//! What an outbound_queue does with a packet when it is full
+enum class overflow_policy : uint8_t
+{
+  drop_oldest, //!< The oldest queued packet is discarded
+  drop_newest, //!< The new packet is discarded
+  coalesce     //!< The new packet replaces a queued one with the same address
+};
+
+struct outbound_queue_configuration
+{
+  //! Maximum number of queued packets, rounded up to a power of two
+  std::size_t depth{512};
+
+  //! Larger packets are not queued but sent directly by the caller
+  std::size_t max_packet_size{1024};
+
+  overflow_policy overflow{overflow_policy::drop_oldest};
+
+  //! Delay after which the io_context thread sends the packets queued,
+  //! and period at which it sends them until the queue is empty
+  std::chrono::microseconds drain_period{1000};
+};
+
+/**
+ * @brief Queue of the packets written to a socket, sent from its io_context.
+ *
+ * The protocols write their encoded packets with enqueue(), which copies
+ * them in a preallocated ring, so that pushing values from the execution
+ * thread does not wait for the network. Once started, the io_context thread
+ * sends the queued packets every drain_period, as long as there are some:
+ * an idle queue does not wake the io_context up. Only the first packet
+ * queued while the queue is idle posts to the io_context; the others
+ * never allocate, lock nor do system calls.
+ *
+ * When the ring is full, the overflow_policy decides which packet is lost.
+ * Coalescing only replaces OSC messages whose address is the same as the new
+ * one: bundles are never coalesced.
+ */
+class OSSIA_EXPORT outbound_queue
+    : public std::enable_shared_from_this<outbound_queue>
+{
+public:
+  using send_function = std::function<void(const char*, std::size_t)>;
+  //! Returns how many of the packets were sent
+  using batch_send_function
+      = std::function<std::size_t(const boost::asio::const_buffer*, std::size_t)>;
+
+  //! Maximum number of packets given at once to a batch_send_function
+  static constexpr std::size_t max_batch = 64;
+
+  struct counters
+  {
+    uint64_t sent{};
+    uint64_t dropped{};
+    uint64_t failed{}; //!< Dequeued but not sent by the socket
+    uint64_t coalesced{};
+    uint64_t oversized{};
+    std::size_t depth{};
+    std::size_t max_depth{};
+  };
+
+  explicit outbound_queue(const outbound_queue_configuration& conf);
+  ~outbound_queue();
+
+  outbound_queue(const outbound_queue&) = delete;
+  outbound_queue& operator=(const outbound_queue&) = delete;
+
+  //! Queues a copy of the packet. Returns false if it is larger than
+  //! max_packet_size: it must then be sent directly.
+  bool enqueue(const char* data, std::size_t sz) noexcept;
+
+  //! Sends the queued packets from a thread running ctx.
+  //! The queue must be owned by a std::shared_ptr, and is started once: it
+  //! serves a single socket.
+  void start(boost::asio::io_context& ctx, send_function send);
+
+  //! Same, but sends the queued packets by batches, e.g. with sendmmsg.
+  void start(boost::asio::io_context& ctx, batch_send_function send);
+
+  //! After stop() returns, send is not called anymore.
+  void stop() noexcept;
+
+  std::size_t capacity() const noexcept { return m_slots.size(); }
+  std::size_t depth() const noexcept;
+  counters read() const noexcept;
+
+private:
+  struct slot
+  {
+    std::atomic<std::size_t> sequence{};
+    // Taken to read or overwrite the data of a queued packet
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    uint32_t size{};
+  };
+
+  char* data(std::size_t pos) noexcept
+  {
+    return m_data.data() + (pos & m_mask) * m_max_packet_size;
+  }
+
+  bool push(const char* data, std::size_t sz) noexcept;
+  template <typename F>
+  bool pop(F&& f);
+  bool coalesce(const char* data, std::size_t sz) noexcept;
+  std::size_t drain();
+  std::size_t drain_batches();
+  void start(boost::asio::io_context& ctx);
+  void wake() noexcept;
+  void schedule(std::shared_ptr<boost::asio::steady_timer> timer);
+
+  static void lock(slot& s) noexcept;
+  static void increment(std::atomic<uint64_t>& v) noexcept
+  {
+    v.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  std::vector<slot> m_slots;
+  std::vector<char> m_data;
+  const std::size_t m_mask{};
+  const std::size_t m_max_packet_size{};
+  const overflow_policy m_overflow{};
+  const std::chrono::microseconds m_period{};
+
+  alignas(64) std::atomic<std::size_t> m_head{};
+  alignas(64) std::atomic<std::size_t> m_tail{};
+
+  alignas(64) std::atomic<uint64_t> m_sent{};
+  std::atomic<uint64_t> m_dropped{};
+  std::atomic<uint64_t> m_failed{};
+  std::atomic<uint64_t> m_coalesced{};
+  std::atomic<uint64_t> m_oversized{};
+  std::atomic<std::size_t> m_max_depth{};
+
+  send_function m_send;
+  batch_send_function m_batch_send;
+  std::vector<char> m_batch_data;
+  std::vector<boost::asio::const_buffer> m_batch;
+  std::atomic<boost::asio::io_context*> m_context{};
+  // A drain is scheduled
+  std::atomic_bool m_armed{};
+  std::atomic_bool m_stopped{};
+  std::atomic_bool m_draining{};
+};
+}
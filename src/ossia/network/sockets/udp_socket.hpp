@@ -9,17 +9,66 @@
 #include <nano_signal_slot.hpp>
 #include <ossia/detail/logger.hpp>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 namespace ossia::net
 {
+#if defined(__linux__)
+//! Preallocated datagrams for recvmmsg
+struct udp_datagram_batch
+{
+  static constexpr int count = 16;
+
+  // Left uninitialized: only the pages actually received into are touched
+  explicit udp_datagram_batch(std::size_t max_size)
+      : data{new char[count * max_size]}
+      , max_size{max_size}
+  {
+    for(int i = 0; i < count; i++)
+    {
+      iov[i].iov_base = data.get() + i * max_size;
+      iov[i].iov_len = max_size;
+      msgs[i] = {};
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  //! Number of datagrams read without blocking, -1 on error
+  int receive(int fd) noexcept
+  {
+    return ::recvmmsg(fd, msgs, count, MSG_DONTWAIT, nullptr);
+  }
+
+  const char* datagram(int i) const noexcept { return data.get() + i * max_size; }
+  std::size_t size(int i) const noexcept { return msgs[i].msg_len; }
+
+  //! The datagram was larger than max_size
+  bool truncated(int i) const noexcept { return msgs[i].msg_hdr.msg_flags & MSG_TRUNC; }
+
+  std::unique_ptr<char[]> data;
+  std::size_t max_size{};
+  iovec iov[count];
+  mmsghdr msgs[count];
+};
+#endif
 
 class udp_receive_socket
 {
   using proto = boost::asio::ip::udp;
 public:
-  udp_receive_socket(const socket_configuration& conf, boost::asio::io_context& ctx)
+  udp_receive_socket(const receive_socket_configuration& conf, boost::asio::io_context& ctx)
       : m_context {ctx}
       , m_endpoint {boost::asio::ip::make_address(conf.host), conf.port}
       , m_socket {ctx}
+      , m_max_datagram_size {std::clamp(conf.max_datagram_size, std::size_t(1), sizeof(m_data))}
   {
   }
 
@@ -37,8 +86,19 @@ public:
     });
   }
 
+  //! On Linux, reads the available datagrams in batches, else one at a time
   template <typename F>
   void receive(F f)
+  {
+#if defined(__linux__)
+    receive_batch(std::move(f));
+#else
+    receive_one(std::move(f));
+#endif
+  }
+
+  template <typename F>
+  void receive_one(F f)
   {
     m_socket.async_receive_from(
         boost::asio::buffer(m_data), m_endpoint,
@@ -62,16 +122,79 @@ public:
             }
           }
 
-          this->receive(f);
+          this->receive_one(f);
         });
   }
 
+#if defined(__linux__)
+  template <typename F>
+  void receive_batch(F f)
+  {
+    if(!m_batch)
+      m_batch = std::make_unique<udp_datagram_batch>(m_max_datagram_size);
+
+    m_socket.async_wait(
+        proto::socket::wait_read,
+        [this, f](auto ec) {
+          if (ec == boost::asio::error::operation_aborted)
+            return;
+
+          // Bounded so that the other sockets of the context get served:
+          // async_wait is triggered again if datagrams remain.
+          for(int batches = 0; !ec && batches < 4; batches++)
+          {
+            const int n = m_batch->receive(m_socket.native_handle());
+            if(n < 0)
+            {
+              if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                ossia::logger().error("[udp_socket::receive]: {}", std::strerror(errno));
+              break;
+            }
+
+            for(int i = 0; i < n; i++)
+            {
+              if(m_batch->size(i) == 0)
+                continue;
+              if(m_batch->truncated(i))
+              {
+                ossia::logger().error(
+                    "[udp_socket::receive]: datagram larger than {} bytes discarded",
+                    m_max_datagram_size);
+                continue;
+              }
+              try
+              {
+                f(m_batch->datagram(i), m_batch->size(i));
+              }
+              catch (const std::exception& e)
+              {
+                ossia::logger().error("[udp_socket::receive]: {}", e.what());
+              }
+              catch (...)
+              {
+                ossia::logger().error("[udp_socket::receive]: unknown error");
+              }
+            }
+
+            if(n < udp_datagram_batch::count)
+              break;
+          }
+
+          this->receive_batch(f);
+        });
+  }
+#endif
+
   Nano::Signal<void()> on_close;
 
   boost::asio::io_context& m_context;
   proto::endpoint m_endpoint;
   proto::socket m_socket;
   alignas(16) char m_data[65535];
+  std::size_t m_max_datagram_size{};
+#if defined(__linux__)
+  std::unique_ptr<udp_datagram_batch> m_batch;
+#endif
 };
 
 class udp_send_socket
@@ -110,6 +233,76 @@ public:
     m_socket.send_to(boost::asio::buffer(data, sz), m_endpoint);
   }
 
+  //! Sends each buffer as a datagram, with sendmmsg on Linux.
+  //! The datagrams which cannot be sent are skipped and logged.
+  //! Returns the number of datagrams sent.
+  std::size_t write_many(const boost::asio::const_buffer* bufs, std::size_t n)
+  {
+    std::size_t sent_count = 0;
+    std::size_t failed = 0;
+    boost::system::error_code error;
+#if defined(__linux__)
+    constexpr std::size_t max_batch = 64;
+    mmsghdr msgs[max_batch];
+    iovec iov[max_batch];
+
+    while(n > 0)
+    {
+      const std::size_t count = std::min(n, max_batch);
+      for(std::size_t i = 0; i < count; i++)
+      {
+        iov[i].iov_base = const_cast<void*>(bufs[i].data());
+        iov[i].iov_len = bufs[i].size();
+        msgs[i] = {};
+        msgs[i].msg_hdr.msg_name = m_endpoint.data();
+        msgs[i].msg_hdr.msg_namelen = m_endpoint.size();
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      // Only sent k of count: the next call starts at the first one not sent
+      const int sent = ::sendmmsg(m_socket.native_handle(), msgs, count, 0);
+      if(sent > 0)
+      {
+        bufs += sent;
+        n -= sent;
+        sent_count += sent;
+        continue;
+      }
+
+      if(sent < 0 && errno == EINTR)
+        continue;
+
+      // The first datagram failed: drop it and go on with the others
+      error = {sent < 0 ? errno : EIO, boost::asio::error::get_system_category()};
+      bufs++;
+      n--;
+      failed++;
+    }
+#else
+    for(std::size_t i = 0; i < n; i++)
+    {
+      boost::system::error_code ec;
+      m_socket.send_to(bufs[i], m_endpoint, 0, ec);
+      if(ec)
+      {
+        error = ec;
+        failed++;
+      }
+      else
+      {
+        sent_count++;
+      }
+    }
+#endif
+
+    if(failed > 0)
+      ossia::logger().error(
+          "[udp_socket::write_many]: {} datagrams not sent: {}", failed,
+          error.message());
+    return sent_count;
+  }
+
   Nano::Signal<void()> on_close;
 
   boost::asio::io_context& m_context;
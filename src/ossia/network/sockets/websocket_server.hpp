@@ -245,6 +245,23 @@ public:
           message.data(), message.size(), websocketpp::frame::opcode::binary);
   }
 
+  using message_ptr = server_t::message_ptr;
+
+  //! A binary message built once, to be sent to several connections
+  static message_ptr make_binary_message(std::string_view message)
+  {
+    auto msg = websocketpp::lib::make_shared<server_t::message_ptr::element_type>(
+        nullptr, websocketpp::frame::opcode::binary, message.size());
+    msg->set_payload(message.data(), message.size());
+    return msg;
+  }
+
+  void send_message(connection_handler hdl, const message_ptr& message)
+  {
+    auto con = m_server.get_con_from_hdl(hdl);
+    con->send(message);
+  }
+
   server_t& impl()
   {
     return m_server;
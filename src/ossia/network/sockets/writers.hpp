@@ -1,5 +1,6 @@
 #pragma once
 #include <ossia/detail/config.hpp>
+#include <ossia/network/sockets/outbound_queue.hpp>
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/error.hpp>
@@ -19,6 +20,19 @@ struct socket_writer
   }
 };
 
+//! Writes in an outbound_queue if there is one, else in the socket
+template<typename T>
+struct queued_socket_writer
+{
+  T& socket;
+  outbound_queue* queue{};
+  void operator()(const char* data, std::size_t sz) const
+  {
+    if(!queue || !queue->enqueue(data, sz))
+      socket.write(data,sz);
+  }
+};
+
 template<typename Socket>
 struct multi_socket_writer
 {
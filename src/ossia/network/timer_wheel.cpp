@@ -0,0 +1,165 @@
+#include <ossia/network/timer_wheel.hpp>
+
+#include <algorithm>
+
+namespace ossia::net
+{
+timer_wheel::entry::~entry() = default;
+
+std::shared_ptr<timer_wheel> timer_wheel::create(
+    network_context_ptr ctx, std::chrono::microseconds resolution,
+    std::size_t buckets)
+{
+  std::shared_ptr<timer_wheel> w{
+      new timer_wheel{std::move(ctx), resolution, buckets}};
+  w->wait();
+  return w;
+}
+
+timer_wheel::timer_wheel(
+    network_context_ptr ctx, std::chrono::microseconds resolution,
+    std::size_t buckets)
+    : m_context{std::move(ctx)}
+    , m_timer{m_context->context}
+    , m_resolution{std::max(resolution, std::chrono::microseconds{1})}
+    , m_start{clock::now()}
+    , m_buckets(std::max(buckets, std::size_t(1)))
+{
+}
+
+timer_wheel::~timer_wheel() = default;
+
+void timer_wheel::wait()
+{
+  // Due times are computed from the start so that the ticks do not drift
+  m_timer.expires_at(m_start + (m_tick + 1) * m_resolution);
+  m_timer.async_wait(
+      [self = weak_from_this()](boost::system::error_code ec) {
+        if (ec)
+          return;
+        if (auto w = self.lock())
+        {
+          w->tick();
+          w->wait();
+        }
+      });
+}
+
+void timer_wheel::tick()
+{
+  const int64_t n = m_buckets.size();
+  const int64_t now = (clock::now() - m_start) / m_resolution;
+
+  std::unique_lock lock{m_mutex};
+  m_tickThread = std::this_thread::get_id();
+
+  // After a stall of more than a revolution, the missed ticks are skipped
+  if (now - m_tick > n)
+    m_tick = now - n;
+
+  while (m_tick < now)
+  {
+    m_tick++;
+    entry* e = m_buckets[m_tick % n];
+    while (e)
+    {
+      entry* next = e->m_next;
+      if (e->m_rounds > 0)
+      {
+        e->m_rounds--;
+      }
+      else
+      {
+        // Inserted at the head of its bucket: not visited again by this loop
+        unlink(*e);
+        insert(*e, m_tick + e->m_period);
+        if (!e->m_due)
+        {
+          e->m_due = true;
+          m_due.push_back(e);
+        }
+      }
+      e = next;
+    }
+  }
+
+  // The entries are called without the wheel locked, so that a slow one
+  // does not hold back the others: cancel() takes them out of m_due,
+  // or waits until they return.
+  for (std::size_t i = 0; i < m_due.size(); i++)
+  {
+    entry* e = m_due[i];
+    if (!e)
+      continue;
+
+    m_due[i] = nullptr;
+    e->m_due = false;
+    m_running = e;
+    lock.unlock();
+    e->on_timer();
+    lock.lock();
+    m_running = nullptr;
+    m_returned.notify_all();
+  }
+  m_due.clear();
+}
+
+void timer_wheel::insert(entry& e, int64_t due) noexcept
+{
+  const int64_t n = m_buckets.size();
+  const int64_t delay = std::max(due - m_tick, int64_t(1));
+
+  e.m_bucket = (m_tick + delay) % n;
+  e.m_rounds = (delay - 1) / n;
+  e.m_prev = nullptr;
+  e.m_next = m_buckets[e.m_bucket];
+  if (e.m_next)
+    e.m_next->m_prev = &e;
+  m_buckets[e.m_bucket] = &e;
+  e.m_scheduled = true;
+}
+
+void timer_wheel::unlink(entry& e) noexcept
+{
+  if (e.m_prev)
+    e.m_prev->m_next = e.m_next;
+  else
+    m_buckets[e.m_bucket] = e.m_next;
+  if (e.m_next)
+    e.m_next->m_prev = e.m_prev;
+
+  e.m_prev = nullptr;
+  e.m_next = nullptr;
+  e.m_scheduled = false;
+}
+
+void timer_wheel::schedule(entry& e, clock::duration period)
+{
+  const int64_t ticks = std::max(
+      int64_t((period + m_resolution - clock::duration{1}) / m_resolution),
+      int64_t(1));
+
+  std::lock_guard lock{m_mutex};
+  if (e.m_scheduled)
+    unlink(e);
+  e.m_period = ticks;
+  insert(e, m_tick + ticks);
+}
+
+void timer_wheel::cancel(entry& e)
+{
+  std::unique_lock lock{m_mutex};
+  if (e.m_scheduled)
+    unlink(e);
+
+  if (e.m_due)
+  {
+    e.m_due = false;
+    *std::find(m_due.begin(), m_due.end(), &e) = nullptr;
+  }
+
+  // An entry cancelling itself from on_timer() does not wait for itself
+  if (m_running == &e && std::this_thread::get_id() != m_tickThread)
+    m_returned.wait(lock, [&] { return m_running != &e; });
+}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <ossia/detail/config.hpp>
+#include <ossia/network/context.hpp>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ossia::net
+{
+/**
+ * @brief Periodic timers of a network_context, all driven by a single
+ * steady_timer.
+ *
+ * The timers are hashed in a ring of buckets by the tick at which they are
+ * due: on each tick of resolution, only the entries of the current bucket
+ * are looked at. Entries are intrusive, hence scheduling them does not
+ * allocate, and any number of them costs a single asio wait per tick.
+ *
+ * The entries are called from a thread running the io_context, without the
+ * wheel locked, so that a slow entry does not block the others from being
+ * scheduled or cancelled. cancel() returns once the entry cannot be called
+ * anymore: if it is running on another thread, it waits until it returns.
+ */
+class OSSIA_EXPORT timer_wheel
+    : public std::enable_shared_from_this<timer_wheel>
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  struct OSSIA_EXPORT entry
+  {
+    entry() = default;
+    entry(const entry&) = delete;
+    entry& operator=(const entry&) = delete;
+    virtual ~entry();
+
+    virtual void on_timer() noexcept = 0;
+
+  private:
+    friend class timer_wheel;
+    entry* m_prev{};
+    entry* m_next{};
+    int64_t m_period{};
+    int64_t m_rounds{};
+    std::size_t m_bucket{};
+    bool m_scheduled{};
+    // In m_due of the wheel, about to be called
+    bool m_due{};
+  };
+
+  //! The wheel runs as soon as it is created, until it is destroyed.
+  static std::shared_ptr<timer_wheel> create(
+      network_context_ptr ctx,
+      std::chrono::microseconds resolution = std::chrono::milliseconds{1},
+      std::size_t buckets = 1024);
+  ~timer_wheel();
+
+  timer_wheel(const timer_wheel&) = delete;
+  timer_wheel& operator=(const timer_wheel&) = delete;
+
+  //! Calls e every period, rounded up to the resolution, starting one period
+  //! from now. An entry already scheduled is rescheduled.
+  void schedule(entry& e, clock::duration period);
+  void cancel(entry& e);
+
+  std::chrono::microseconds resolution() const noexcept { return m_resolution; }
+  const network_context_ptr& context() const noexcept { return m_context; }
+
+private:
+  timer_wheel(
+      network_context_ptr ctx, std::chrono::microseconds resolution,
+      std::size_t buckets);
+
+  void wait();
+  void tick();
+  void insert(entry& e, int64_t due) noexcept;
+  void unlink(entry& e) noexcept;
+
+  network_context_ptr m_context;
+  boost::asio::steady_timer m_timer;
+  const std::chrono::microseconds m_resolution{};
+  const clock::time_point m_start{};
+
+  std::mutex m_mutex;
+  std::vector<entry*> m_buckets;
+  // Last tick processed
+  int64_t m_tick{};
+
+  // Entries of the current tick, and the one being called
+  std::vector<entry*> m_due;
+  entry* m_running{};
+  std::condition_variable m_returned;
+  std::thread::id m_tickThread;
+};
+}
@@ -10,6 +10,13 @@
 
 namespace ossia::net
 {
+template<typename Protocol>
+static std::unique_ptr<osc_protocol_base> with_outbound_queue(std::unique_ptr<Protocol> proto, const osc_protocol_configuration& config)
+{
+  proto->set_outbound_queue(config.outbound);
+  return proto;
+}
+
 template<typename OscVersion>
 std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&& ctx, osc_protocol_configuration&& config)
 {
@@ -27,11 +34,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
             -> std::unique_ptr<osc_protocol_base>
         {
           if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local), config);
           else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote), config);
           else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local), config);
           else
             return {};
         }
@@ -50,11 +57,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
         {
 #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
           if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, unix_datagram_socket>>(std::move(ctx), *conf.remote, *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, unix_datagram_socket>>(std::move(ctx), *conf.remote, *conf.local), config);
           else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, null_socket>>(std::move(ctx), *conf.remote);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, null_socket>>(std::move(ctx), *conf.remote), config);
           else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, unix_datagram_socket>>(std::move(ctx), *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, unix_datagram_socket>>(std::move(ctx), *conf.local), config);
           else
             return {};
 #endif
@@ -108,11 +115,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
             -> std::unique_ptr<osc_protocol_base>
         {
           if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, udp_receive_socket>>(std::move(ctx), *conf.remote, *conf.local), config);
           else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, udp_send_socket, null_socket>>(std::move(ctx), *conf.remote), config);
           else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, udp_receive_socket>>(std::move(ctx), *conf.local), config);
           else
             return {};
         }
@@ -131,11 +138,11 @@ std::unique_ptr<osc_protocol_base> make_osc_protocol_impl(network_context_ptr&&
         {
 #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
           if(conf.remote && conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, unix_datagram_socket>>(std::move(ctx), *conf.remote, *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, unix_datagram_socket>>(std::move(ctx), *conf.remote, *conf.local), config);
           else if(conf.remote)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, null_socket>>(std::move(ctx), *conf.remote);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, unix_datagram_socket, null_socket>>(std::move(ctx), *conf.remote), config);
           else if(conf.local)
-            return std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, unix_datagram_socket>>(std::move(ctx), *conf.local);
+            return with_outbound_queue(std::make_unique<osc_generic_bidir_protocol<client_type, null_socket, unix_datagram_socket>>(std::move(ctx), *conf.local), config);
           else
             return {};
 #endif
@@ -2,6 +2,7 @@
 #include <ossia/network/base/protocol.hpp>
 #include <ossia/network/context_functions.hpp>
 #include <ossia/network/sockets/configuration.hpp>
+#include <ossia/network/sockets/outbound_queue.hpp>
 
 #include <ossia/detail/variant.hpp>
 
@@ -29,6 +30,10 @@ struct osc_protocol_configuration
       , ws_client_configuration
       , ws_server_configuration
    > transport;
+
+  // Only relevant for UDP and UNIX_DGRAM: if set, the packets are sent through this queue
+  // from the io_context thread. It can only be used by a single protocol.
+  std::shared_ptr<outbound_queue> outbound;
 };
 
 using osc_protocol_base = can_learn<protocol_base>;
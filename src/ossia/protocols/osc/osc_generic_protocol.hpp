@@ -11,6 +11,7 @@
 #include <ossia/network/domain/domain.hpp>
 #include <ossia/network/exceptions.hpp>
 #include <ossia/network/sockets/null_socket.hpp>
+#include <ossia/network/sockets/udp_socket.hpp>
 #include <ossia/network/sockets/configuration.hpp>
 #include <ossia/network/generic/generic_device.hpp>
 #include <ossia/network/generic/generic_parameter.hpp>
@@ -33,7 +34,7 @@ class osc_generic_bidir_protocol
 {
 public:
   //using socket_type = Socket;
-  using writer_type = socket_writer<SendSocket>;
+  using writer_type = queued_socket_writer<SendSocket>;
 
   osc_generic_bidir_protocol(
       network_context_ptr ctx, const send_fd_configuration& send_conf, const receive_fd_configuration& recv_conf)
@@ -142,6 +143,41 @@ public:
 
   ~osc_generic_bidir_protocol() override
   {
+    if(m_queue)
+      m_queue->stop();
+  }
+
+  //! Sends the packets from the io_context thread instead of the thread pushing the values.
+  //! To be called before pushing values.
+  void set_outbound_queue(std::shared_ptr<outbound_queue> queue)
+  {
+    if constexpr(!std::is_same_v<SendSocket, ossia::net::null_socket>)
+    {
+      if(m_queue)
+        m_queue->stop();
+
+      m_queue = std::move(queue);
+      if(!m_queue)
+        return;
+
+      if constexpr(std::is_same_v<SendSocket, udp_send_socket>)
+      {
+        m_queue->start(m_ctx->context, [this] (const boost::asio::const_buffer* bufs, std::size_t n) {
+          return to_client.write_many(bufs, n);
+        });
+      }
+      else
+      {
+        m_queue->start(m_ctx->context, [this] (const char* data, std::size_t sz) {
+          to_client.write(data, sz);
+        });
+      }
+    }
+  }
+
+  const std::shared_ptr<outbound_queue>& get_outbound_queue() const noexcept
+  {
+    return m_queue;
   }
 
   bool update(ossia::net::node_base& node_base) override
@@ -241,6 +277,19 @@ public:
     }
   }
 
+  bool push_bundle_values(
+      const std::vector<ossia::net::bundle_element>& values) override
+  {
+    if constexpr(!std::is_same_v<SendSocket, ossia::net::null_socket>)
+    {
+      return OscMode::push_bundle(*this, writer(), values);
+    }
+    else
+    {
+      return false;
+    }
+  }
+
   void on_received_message(const oscpack::ReceivedMessage& m)
   {
     if constexpr(!std::is_same_v<RecvSocket, ossia::net::null_socket>)
@@ -256,7 +305,7 @@ public:
 
   auto writer() noexcept
   {
-    return writer_type{to_client};
+    return writer_type{to_client, m_queue.get()};
   }
 
   using ossia::net::protocol_base::m_logger;
@@ -268,6 +317,7 @@ public:
 
   RecvSocket from_client;
   SendSocket to_client;
+  std::shared_ptr<outbound_queue> m_queue;
 };
 
 template<typename OscMode, typename Socket>
@@ -355,6 +405,12 @@ public:
     return OscMode::push_bundle(*this, writer(), addresses);
   }
 
+  bool push_bundle_values(
+      const std::vector<ossia::net::bundle_element>& values) override
+  {
+    return OscMode::push_bundle(*this, writer(), values);
+  }
+
   void on_received_message(const oscpack::ReceivedMessage& m)
   {
     return OscMode::on_received_message(*this, m);
@@ -471,6 +527,12 @@ public:
     return OscMode::push_bundle(*this, writer(), addresses);
   }
 
+  bool push_bundle_values(
+      const std::vector<ossia::net::bundle_element>& values) override
+  {
+    return OscMode::push_bundle(*this, writer(), values);
+  }
+
   void on_received_message(const oscpack::ReceivedMessage& m)
   {
     return OscMode::on_received_message(*this, m);
@@ -4,6 +4,7 @@
 #include <ossia/protocols/oscquery/oscquery_server_asio.hpp>
 #include <ossia/network/context.hpp>
 #include <ossia/network/sockets/udp_socket.hpp>
+#include <ossia/network/sockets/writers.hpp>
 #include <ossia/network/common/network_logger.hpp>
 #include <ossia/network/osc/detail/sender.hpp>
 #include <ossia/network/oscquery/detail/outbound_visitor.hpp>
@@ -14,53 +15,72 @@ namespace ossia::oscquery_asio
 struct oscquery_client
 {
   ossia::net::websocket_server::connection_handler connection;
-  mutex_t listeningMutex;
+  oscquery_server_protocol* server{};
+
+  // Guarded by the clients lock of the server
   string_map<ossia::net::parameter_base*> listening;
 
+  // Set on the first LISTEN: the client then only gets the values of the
+  // parameters it listens to, instead of every pushed value.
+  bool filtered{};
+
   std::string client_ip;
-  std::unique_ptr<ossia::net::udp_send_socket> osc_socket;
+  // Shared with the threads sending packets outside of the clients lock
+  std::shared_ptr<ossia::net::udp_send_socket> osc_socket;
+  std::shared_ptr<ossia::net::outbound_queue> osc_queue;
   int remote_sender_port{};
 
 public:
+  using osc_writer_type = ossia::net::queued_socket_writer<ossia::net::udp_send_socket>;
+
   oscquery_client() = default;
   oscquery_client(oscquery_client&& other)
       : connection{std::move(other.connection)}
+      , server{other.server}
       , listening{std::move(other.listening)}
+      , filtered{other.filtered}
       , client_ip{std::move(other.client_ip)}
       , osc_socket{std::move(other.osc_socket)}
+      , osc_queue{std::move(other.osc_queue)}
   {
     // FIXME http://stackoverflow.com/a/29988626/1495627
   }
 
   oscquery_client& operator=(oscquery_client&& other)
   {
+    stop_osc_queue();
     connection = std::move(other.connection);
+    server = other.server;
     listening = std::move(other.listening);
+    filtered = other.filtered;
     client_ip = std::move(other.client_ip);
     osc_socket = std::move(other.osc_socket);
+    osc_queue = std::move(other.osc_queue);
     return *this;
   }
 
-  oscquery_client(ossia::net::websocket_server::connection_handler h)
+  ~oscquery_client()
+  {
+    stop_osc_queue();
+  }
+
+  oscquery_client(
+      ossia::net::websocket_server::connection_handler h,
+      oscquery_server_protocol& proto)
       : connection{std::move(h)}
+      , server{&proto}
   {
   }
 
   void start_listen(std::string path, ossia::net::parameter_base* addr)
   {
     if (addr)
-    {
-      listeningMutex.lock();
-      listening.insert(std::make_pair(std::move(path), addr));
-      listeningMutex.unlock();
-    }
+      server->subscribe(*this, std::move(path), *addr);
   }
 
   void stop_listen(const std::string& path)
   {
-    listeningMutex.lock();
-    listening.erase(path);
-    listeningMutex.unlock();
+    server->unsubscribe(*this, path);
   }
 
   bool operator==(const ossia::net::websocket_server::connection_handler& h) const
@@ -70,8 +90,36 @@ public:
 
   void open_osc_sender(ossia::oscquery_asio::oscquery_server_protocol& proto, uint16_t port)
   {
-    osc_socket = std::make_unique<ossia::net::udp_send_socket>(ossia::net::socket_configuration{client_ip, port}, proto.m_context->context);
+    lock_t lock(proto.m_clientsMutex);
+    stop_osc_queue();
+    osc_socket = std::make_shared<ossia::net::udp_send_socket>(ossia::net::socket_configuration{client_ip, port}, proto.m_context->context);
     osc_socket->connect();
+    if(proto.m_outboundQueue)
+      start_osc_queue(proto, *proto.m_outboundQueue);
+  }
+
+  // The sockets of the clients each have their queue
+  void start_osc_queue(ossia::oscquery_asio::oscquery_server_protocol& proto, const ossia::net::outbound_queue_configuration& conf)
+  {
+    stop_osc_queue();
+    osc_queue = std::make_shared<ossia::net::outbound_queue>(conf);
+    osc_queue->start(proto.m_context->context, [sock = osc_socket] (const boost::asio::const_buffer* bufs, std::size_t n) {
+      return sock->write_many(bufs, n);
+    });
+  }
+
+  void stop_osc_queue()
+  {
+    if(osc_queue)
+    {
+      osc_queue->stop();
+      osc_queue.reset();
+    }
+  }
+
+  osc_writer_type osc_writer() noexcept
+  {
+    return {*osc_socket, osc_queue.get()};
   }
 
 };
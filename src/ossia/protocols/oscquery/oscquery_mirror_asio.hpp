@@ -60,6 +60,7 @@ public:
   bool push_raw(const ossia::net::full_parameter_data& parameter_base) override;
   bool push_bundle(const std::vector<const ossia::net::parameter_base*>&) override;
   bool push_raw_bundle(const std::vector<ossia::net::full_parameter_data>&) override;
+  bool push_bundle_values(const std::vector<ossia::net::bundle_element>&) override;
   bool observe(net::parameter_base&, bool) override;
   bool observe_quietly(net::parameter_base&, bool) override;
   bool update(net::node_base& b) override;
@@ -2,6 +2,7 @@
 // it. PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "oscquery_server_asio.hpp"
 
+#include <ossia/detail/buffer_pool.hpp>
 #include <ossia/detail/mutex.hpp>
 #include <ossia/detail/string_map.hpp>
 #include <ossia/network/context.hpp>
@@ -28,6 +29,7 @@
 #include <ossia/network/oscquery/detail/query_parser.hpp>
 #include <ossia/protocols/oscquery/oscquery_client_asio.hpp>
 #include <ossia/network/sockets/websocket_server.hpp>
+#include <ossia/network/sockets/writers.hpp>
 #include <ossia/detail/algorithms.hpp>
 namespace ossia
 {
@@ -39,10 +41,10 @@ struct oscquery_server_protocol::osc_receiver_impl : ossia::net::udp_receive_soc
   using udp_receive_socket::udp_receive_socket;
 };
 
-static uintptr_t client_identifier(const std::vector<oscquery_client>& clts, const oscpack::IpEndpointName& ip)
+static uintptr_t client_identifier(const std::list<oscquery_client>& clts, const oscpack::IpEndpointName& ip)
 {
   if(clts.size() == 1)
-    return (uintptr_t) clts[0].connection.lock().get();
+    return (uintptr_t) clts.front().connection.lock().get();
 
   for (const oscquery_client& c : clts)
   {
@@ -59,17 +61,147 @@ static bool is_same(const oscquery_client& clt, const ossia::net::message_origin
   return (uintptr_t)clt.connection.lock().get() == id.identifier;
 }
 
+// A client a packet is sent to, copied so that the packet is written without
+// the clients lock
+struct oscquery_server_protocol::push_target
+{
+  std::shared_ptr<ossia::net::udp_send_socket> osc_socket;
+  std::shared_ptr<ossia::net::outbound_queue> osc_queue;
+  connection_handler connection;
+};
+
+template <typename F>
+void oscquery_server_protocol::for_each_listener(
+    const net::parameter_base& p, F&& f)
+{
+  for (auto client : m_unfilteredClients)
+    f(*client);
+
+  if (auto it = m_subscribers.find(&p); it != m_subscribers.end())
+  {
+    for (auto client : it->second)
+      f(*client);
+  }
+}
+
+template <typename F>
+void oscquery_server_protocol::for_each_listener(
+    const net::full_parameter_data& p, F&& f)
+{
+  // Raw values have no parameter: the subscriptions are looked up by address
+  for (auto& client : m_clients)
+  {
+    if (!client.filtered || client.listening.find(p.address) != client.listening.end())
+      f(client);
+  }
+}
+
+template <typename Parameters, typename F>
+void oscquery_server_protocol::for_each_bundle_listener(
+    const Parameters& params, F&& f)
+{
+  // A bundle is sent once to each client listening to any of its values
+  thread_local std::vector<const oscquery_client*> seen;
+  seen.clear();
+  auto once = [&](oscquery_client& client) {
+    if (!ossia::contains(seen, &client))
+    {
+      seen.push_back(&client);
+      f(client);
+    }
+  };
+
+  for (auto& p : params)
+    for_each_listener(ossia::net::access_parameter(p), once);
+}
+
+template <typename Clients>
+void oscquery_server_protocol::send_to_clients(
+    std::string_view packet, bool critical, Clients&& clients)
+{
+  // Reused by each pushing thread
+  thread_local std::vector<push_target> targets;
+  targets.clear();
+  {
+    lock_t lock(m_clientsMutex);
+    clients([&](const oscquery_client& client) {
+      if (client.osc_socket && !critical)
+        targets.push_back({client.osc_socket, client.osc_queue, {}});
+      else
+        targets.push_back({{}, {}, client.connection});
+    });
+  }
+
+  // The WebSocket message is built once for all the clients
+  ossia::net::websocket_server::message_ptr ws_message;
+  for (auto& target : targets)
+  {
+    try
+    {
+      if (target.osc_socket)
+      {
+        ossia::net::queued_socket_writer<ossia::net::udp_send_socket>{
+            *target.osc_socket, target.osc_queue.get()}(packet.data(), packet.size());
+      }
+      else
+      {
+        if (!ws_message)
+          ws_message = ossia::net::websocket_server::make_binary_message(packet);
+        m_websocketServer->send_message(target.connection, ws_message);
+      }
+    }
+    catch (const std::exception& e)
+    {
+      // e.g. the client disconnected since the copy
+      logger().error("oscquery_server_protocol::send_to_clients: {}", e.what());
+    }
+    catch (...)
+    {
+      logger().error("oscquery_server_protocol::send_to_clients: error.");
+    }
+  }
+  targets.clear();
+}
+
+template <typename Addr, typename Filter>
+void oscquery_server_protocol::push_to_clients(
+    const Addr& addr, const ossia::value& val, Filter&& filter)
+{
+  using namespace ossia::net;
+  using write_visitor = osc_value_write_visitor<Addr, osc_extended_policy>;
+
+  if (m_logger.outbound_logger)
+  {
+    m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
+  }
+
+  // Encoded once: OSC and WebSocket clients get the same packet
+  auto& pool = buffer_pool::instance();
+  auto buf = pool.acquire();
+  val.apply(write_visitor{addr, ossia::net::osc_address(addr), buf});
+
+  send_to_clients(
+      std::string_view{buf.data(), buf.size()}, addr.get_critical(),
+      [&](auto&& add) {
+        for_each_listener(addr, [&](oscquery_client& client) {
+          if (filter(client))
+            add(client);
+        });
+      });
+
+  pool.release(std::move(buf));
+}
+
 oscquery_server_protocol::oscquery_server_protocol(
     ossia::net::network_context_ptr ctx,
     uint16_t osc_port, uint16_t ws_port)
   : protocol_base{flags{SupportsMultiplex}}
   , m_context{std::move(ctx)}
-  , m_oscServer{std::make_unique<osc_receiver_impl>(ossia::net::socket_configuration{"0.0.0.0", osc_port}, m_context->context)}
+  , m_oscServer{std::make_unique<osc_receiver_impl>(ossia::net::receive_socket_configuration{{"0.0.0.0", osc_port}}, m_context->context)}
   , m_websocketServer{std::make_unique<ossia::net::websocket_server>(m_context->context)}
   , m_oscPort{osc_port}
   , m_wsPort{ws_port}
 {
-  m_clients.reserve(2);
   m_websocketServer->set_open_handler(
       [&](connection_handler hdl) { on_connectionOpen(hdl); });
   m_websocketServer->set_close_handler(
@@ -112,7 +244,7 @@ oscquery_server_protocol::~oscquery_server_protocol()
     dev.on_parameter_created
         .disconnect<&oscquery_server_protocol::on_parameterChanged>(this);
     dev.on_parameter_removing
-        .disconnect<&oscquery_server_protocol::on_parameterChanged>(this);
+        .disconnect<&oscquery_server_protocol::on_parameterRemoving>(this);
     dev.on_attribute_modified
         .disconnect<&oscquery_server_protocol::on_attributeChanged>(this);
     dev.on_node_renamed.disconnect<&oscquery_server_protocol::on_nodeRenamed>(
@@ -138,98 +270,15 @@ void oscquery_server_protocol::request(net::parameter_base&)
   // Do nothing
 }
 
-struct ws_client_socket
-{
-  ossia::net::websocket_server& server;
-  ossia::net::websocket_server::connection_handler& connection;
-
-  void send_binary_message(std::string_view s)
-  {
-    server.send_binary_message(connection, s);
-  }
-};
-
-bool oscquery_server_protocol::write_impl(std::string_view data, bool critical)
-{
-  // Push to all clients
-  if (!critical)
-  {
-    lock_t lock(m_clientsMutex);
-    for (auto& client : m_clients)
-    {
-      if (client.osc_socket)
-      {
-        client.osc_socket->write(data.data(), data.size());
-      }
-      else
-      {
-        m_websocketServer->send_binary_message(client.connection, data);
-      }
-    }
-  }
-  else
-  {
-    lock_t lock(m_clientsMutex);
-    for (auto& client : m_clients)
-    {
-      m_websocketServer->send_binary_message(client.connection, data);
-    }
-  }
-
-  return true;
-}
-
 template <typename T>
 bool oscquery_server_protocol::push_impl(const T& addr, const ossia::value& v)
 {
-  using namespace ossia::net;
-  using namespace ossia::oscquery;
-  using proto = oscquery_protocol_common<osc_extended_policy>;
-
-  // TODO if we have multiple clients, likely better to generate the message once....
   auto val = net::filter_value(addr, v);
   if (val.valid())
   {
-    // Push to all clients
-    auto critical = addr.get_critical();
-    if (!critical)
-    {
-      lock_t lock(m_clientsMutex);
-      for (auto& client : m_clients)
-      {
-        if (client.osc_socket)
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-          }
-
-          proto::osc_send_message(*this, *client.osc_socket, addr, val);
-        }
-        else
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-          }
-
-          proto::ws_send_binary_message(*this, ws_client_socket{*m_websocketServer, client.connection}, addr, val);
-        }
-      }
-    }
-    else
-    {
-      lock_t lock(m_clientsMutex);
-      for (auto& client : m_clients)
-      {
-        if (m_logger.outbound_logger)
-        {
-          m_logger.outbound_logger->info("Out: {} {}", ossia::net::osc_address(addr), val);
-        }
-        proto::ws_send_binary_message(*this, ws_client_socket{*m_websocketServer, client.connection}, addr, val);
-      }
-    }
-
+    // Push to the clients listening to the parameter
+    if (m_clientCount > 0)
+      push_to_clients(addr, val, [](const oscquery_client&) { return true; });
     return true;
   }
   return false;
@@ -253,7 +302,10 @@ bool oscquery_server_protocol::push_bundle(
 
   if(auto bundle = ossia::net::make_bundle(ossia::net::bundle_client_policy<OscVersion>{}, addresses))
   {
-    return write_impl(std::string_view{bundle->data.data(), bundle->data.size()}, bundle->critical);
+    send_to_clients(
+        std::string_view{bundle->data.data(), bundle->data.size()}, bundle->critical,
+        [&](auto&& add) { for_each_bundle_listener(addresses, add); });
+    return true;
   }
   return false;
 }
@@ -266,7 +318,26 @@ bool oscquery_server_protocol::push_raw_bundle(
 
   if(auto bundle = ossia::net::make_bundle(ossia::net::bundle_client_policy<OscVersion>{}, addresses))
   {
-    return write_impl(std::string_view{bundle->data.data(), bundle->data.size()}, bundle->critical);
+    send_to_clients(
+        std::string_view{bundle->data.data(), bundle->data.size()}, bundle->critical,
+        [&](auto&& add) { for_each_bundle_listener(addresses, add); });
+    return true;
+  }
+  return false;
+}
+
+bool oscquery_server_protocol::push_bundle_values(
+    const std::vector<ossia::net::bundle_element>& values)
+{
+  using namespace ossia::net;
+  using OscVersion = osc_extended_policy;
+
+  if(auto bundle = ossia::net::make_bundle(ossia::net::bundle_client_policy<OscVersion>{}, values))
+  {
+    send_to_clients(
+        std::string_view{bundle->data.data(), bundle->data.size()}, bundle->critical,
+        [&](auto&& add) { for_each_bundle_listener(values, add); });
+    return true;
   }
   return false;
 }
@@ -276,61 +347,12 @@ bool oscquery_server_protocol::echo_incoming_message(
     const net::parameter_base& addr,
     const ossia::value& val)
 {
-  using namespace ossia::net;
-
-  using send_visitor = osc_value_send_visitor<net::parameter_base, osc_extended_policy, socket_writer<udp_send_socket>>;
-
   bool not_this_protocol = &id.protocol != this;
   // we know that the value is valid
   // Push to all clients except ours
-  auto critical = addr.get_critical();
-  if (!critical)
-  {
-    lock_t lock(m_clientsMutex);
-    // No need to echo if we just have one client, the most common case
-    for (auto& client : m_clients)
-    {
-      if (not_this_protocol || !is_same(client, id)) {
-        if (client.osc_socket)
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-          }
-          send_visitor vis{addr, ossia::net::osc_address(addr), {*client.osc_socket}};
-          val.apply(vis);
-        }
-        else
-        {
-          if (m_logger.outbound_logger)
-          {
-            m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-          }
-          m_websocketServer->send_binary_message(
-                client.connection,
-                ossia::oscquery::osc_writer::to_message(addr, val));
-        }
-      }
-    }
-  }
-  else
-  {
-    lock_t lock(m_clientsMutex);
-
-    for (auto& client : m_clients)
-    {
-      if (not_this_protocol || !is_same(client, id)) {
-
-        if (m_logger.outbound_logger)
-        {
-          m_logger.outbound_logger->info("Out: {} {}", addr.get_node().osc_address(), val);
-        }
-
-        m_websocketServer->send_binary_message(
-              client.connection, ossia::oscquery::osc_writer::to_message(addr, val));
-      }
-    }
-  }
+  push_to_clients(addr, val, [&](const oscquery_client& client) {
+    return not_this_protocol || !is_same(client, id);
+  });
 
   return true;
 }
@@ -374,7 +396,7 @@ void oscquery_server_protocol::set_device(net::device_base& dev)
     dev.on_parameter_created
         .disconnect<&oscquery_server_protocol::on_parameterChanged>(this);
     dev.on_parameter_removing
-        .disconnect<&oscquery_server_protocol::on_parameterChanged>(this);
+        .disconnect<&oscquery_server_protocol::on_parameterRemoving>(this);
     old.on_attribute_modified
         .disconnect<&oscquery_server_protocol::on_attributeChanged>(this);
     old.on_node_renamed
@@ -396,7 +418,7 @@ void oscquery_server_protocol::set_device(net::device_base& dev)
   dev.on_parameter_created
       .connect<&oscquery_server_protocol::on_parameterChanged>(this);
   dev.on_parameter_removing
-      .connect<&oscquery_server_protocol::on_parameterChanged>(this);
+      .connect<&oscquery_server_protocol::on_parameterRemoving>(this);
   dev.on_attribute_modified
       .connect<&oscquery_server_protocol::on_attributeChanged>(this);
   dev.on_node_renamed
@@ -440,8 +462,10 @@ void oscquery_server_protocol::stop()
     {
       auto con = m_websocketServer->impl().get_con_from_hdl(it->connection);
       con->close(websocketpp::close::status::going_away, "Server shutdown");
+      remove_subscriptions(*it);
       it = m_clients.erase(it);
     }
+    m_unfilteredClients.clear();
     m_clientCount = 0;
   }
   catch (...)
@@ -460,6 +484,104 @@ void oscquery_server_protocol::stop()
   }
 }
 
+void oscquery_server_protocol::set_outbound_queue(
+    std::optional<ossia::net::outbound_queue_configuration> conf)
+{
+  lock_t lock(m_clientsMutex);
+  m_outboundQueue = std::move(conf);
+  for (auto& client : m_clients)
+  {
+    if (!client.osc_socket)
+      continue;
+
+    if (m_outboundQueue)
+      client.start_osc_queue(*this, *m_outboundQueue);
+    else
+      client.stop_osc_queue();
+  }
+}
+
+ossia::net::outbound_queue::counters
+oscquery_server_protocol::get_outbound_counters()
+{
+  ossia::net::outbound_queue::counters res;
+
+  lock_t lock(m_clientsMutex);
+  for (auto& client : m_clients)
+  {
+    if (!client.osc_queue)
+      continue;
+
+    const auto c = client.osc_queue->read();
+    res.sent += c.sent;
+    res.dropped += c.dropped;
+    res.failed += c.failed;
+    res.coalesced += c.coalesced;
+    res.oversized += c.oversized;
+    res.depth += c.depth;
+    res.max_depth = std::max(res.max_depth, c.max_depth);
+  }
+  return res;
+}
+
+void oscquery_server_protocol::subscribe(
+    oscquery_client& client, std::string path, net::parameter_base& p)
+{
+  lock_t lock(m_clientsMutex);
+  if (!client.filtered)
+  {
+    // From now on, the client only gets the values it listens to
+    client.filtered = true;
+    ossia::remove_erase(m_unfilteredClients, &client);
+  }
+
+  auto it = client.listening.find(path);
+  if (it != client.listening.end())
+  {
+    if (it->second == &p)
+      return;
+    client.listening.erase(it);
+  }
+  client.listening.insert(std::make_pair(std::move(path), &p));
+
+  auto& subscribers = m_subscribers[&p];
+  if (!ossia::contains(subscribers, &client))
+    subscribers.push_back(&client);
+}
+
+void oscquery_server_protocol::unsubscribe(
+    oscquery_client& client, const std::string& path)
+{
+  lock_t lock(m_clientsMutex);
+  auto it = client.listening.find(path);
+  if (it == client.listening.end())
+    return;
+
+  auto sub = m_subscribers.find(it->second);
+  client.listening.erase(it);
+  if (sub != m_subscribers.end())
+  {
+    ossia::remove_erase(sub->second, &client);
+    if (sub->second.empty())
+      m_subscribers.erase(sub);
+  }
+}
+
+void oscquery_server_protocol::remove_subscriptions(oscquery_client& client)
+{
+  for (auto& [path, p] : client.listening)
+  {
+    auto sub = m_subscribers.find(p);
+    if (sub != m_subscribers.end())
+    {
+      ossia::remove_erase(sub->second, &client);
+      if (sub->second.empty())
+        m_subscribers.erase(sub);
+    }
+  }
+  client.listening.clear();
+}
+
 oscquery_client*
 oscquery_server_protocol::find_client(const connection_handler& hdl)
 {
@@ -583,8 +705,9 @@ void oscquery_server_protocol::on_connectionOpen(
 
   {
     lock_t lock(m_clientsMutex);
-    m_clients.emplace_back(hdl);
+    m_clients.emplace_back(hdl, *this);
     m_clients.back().client_ip = std::move(ip);
+    m_unfilteredClients.push_back(&m_clients.back());
     m_clientCount++;
   }
 
@@ -607,6 +730,8 @@ void oscquery_server_protocol::on_connectionClosed(
   if (it != m_clients.end())
   {
     --m_clientCount;
+    remove_subscriptions(*it);
+    ossia::remove_erase(m_unfilteredClients, &*it);
     m_clients.erase(it);
   }
 
@@ -657,6 +782,25 @@ void oscquery_server_protocol::on_parameterChanged(const ossia::net::parameter_b
   on_attributeChanged(p.get_node(), ossia::net::text_value_type());
 }
 
+void oscquery_server_protocol::on_parameterRemoving(const ossia::net::parameter_base& p)
+{
+  {
+    lock_t lock(m_clientsMutex);
+    if (auto sub = m_subscribers.find(&p); sub != m_subscribers.end())
+    {
+      for (auto client : sub->second)
+      {
+        ossia::erase_if(client->listening, [&](const auto& l) {
+          return l.second == &p;
+        });
+      }
+      m_subscribers.erase(sub);
+    }
+  }
+
+  on_parameterChanged(p);
+}
+
 void oscquery_server_protocol::on_attributeChanged(
     const net::node_base& n, ossia::string_view attr) try
 {
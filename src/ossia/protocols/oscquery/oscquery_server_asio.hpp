@@ -1,8 +1,10 @@
 #pragma once
+#include <ossia/detail/hash_map.hpp>
 #include <ossia/detail/mutex.hpp>
 #include <ossia/network/context_functions.hpp>
 #include <ossia/network/base/listening.hpp>
 #include <ossia/network/base/protocol.hpp>
+#include <ossia/network/sockets/outbound_queue.hpp>
 #include <ossia/network/generic/generic_device.hpp>
 #include <ossia/network/sockets/websocket_reply.hpp>
 #include <ossia/network/zeroconf/zeroconf.hpp>
@@ -12,6 +14,8 @@
 #include <nano_signal_slot.hpp>
 
 #include <atomic>
+#include <list>
+#include <optional>
 namespace osc
 {
 template <typename T>
@@ -61,6 +65,8 @@ public:
   push_bundle(const std::vector<const ossia::net::parameter_base*>&) override;
   bool push_raw_bundle(
       const std::vector<ossia::net::full_parameter_data>&) override;
+  bool push_bundle_values(
+      const std::vector<ossia::net::bundle_element>&) override;
   bool echo_incoming_message(const ossia::net::message_origin_identifier&, const ossia::net::parameter_base&, const ossia::value& v) override;
   bool observe(net::parameter_base&, bool) override;
   bool observe_quietly(net::parameter_base&, bool) override;
@@ -83,6 +89,13 @@ public:
     return m_wsPort;
   }
 
+  //! Sends the OSC packets to each client from the io_context thread, through a queue per client.
+  //! Without a configuration, they are sent from the thread pushing the values.
+  void set_outbound_queue(std::optional<ossia::net::outbound_queue_configuration> conf);
+
+  //! Sum of the counters of the queues of the connected clients
+  ossia::net::outbound_queue::counters get_outbound_counters();
+
   Nano::Signal<void(const std::string&)> onClientConnected;
   Nano::Signal<void(const std::string&)> onClientDisconnected;
 
@@ -107,13 +120,34 @@ private:
   void on_nodeCreated(const ossia::net::node_base&);
   void on_nodeRemoved(const ossia::net::node_base&);
   void on_parameterChanged(const ossia::net::parameter_base&);
+  void on_parameterRemoving(const ossia::net::parameter_base&);
   void on_attributeChanged(const ossia::net::node_base&, ossia::string_view attr);
   void on_nodeRenamed(const ossia::net::node_base& n, std::string oldname);
 
   template <typename T>
   bool push_impl(const T& addr, const ossia::value& v);
 
-  bool write_impl(std::string_view data, bool critical);
+  // LISTEN / IGNORE of a client
+  void subscribe(oscquery_client& client, std::string path, ossia::net::parameter_base& p);
+  void unsubscribe(oscquery_client& client, const std::string& path);
+  void remove_subscriptions(oscquery_client& client);
+
+  // Calls f on the clients which get the values of a parameter
+  template <typename F>
+  void for_each_listener(const ossia::net::parameter_base& p, F&& f);
+  template <typename F>
+  void for_each_listener(const ossia::net::full_parameter_data& p, F&& f);
+  template <typename Parameters, typename F>
+  void for_each_bundle_listener(const Parameters& params, F&& f);
+
+  // The packets are encoded once for all the clients, and written after
+  // m_clientsMutex is released. Clients selects the recipients, with
+  // m_clientsMutex taken.
+  struct push_target;
+  template <typename Clients>
+  void send_to_clients(std::string_view packet, bool critical, Clients&& clients);
+  template <typename Addr, typename Filter>
+  void push_to_clients(const Addr& addr, const ossia::value& val, Filter&& filter);
 
   void update_zeroconf();
   // Exceptions here will be catched by the server
@@ -135,8 +169,16 @@ private:
   // Listening status of the local software
   net::listened_parameters m_listening;
 
-  // The clients connected to this server
-  std::vector<oscquery_client> m_clients;
+  // The clients connected to this server. A list, as the subscriptions
+  // refer to the clients.
+  std::list<oscquery_client> m_clients;
+
+  // The clients which sent a LISTEN for each parameter
+  ossia::fast_hash_map<const ossia::net::parameter_base*, std::vector<oscquery_client*>>
+      m_subscribers;
+  // The clients which never sent a LISTEN, and get the values of all the
+  // parameters
+  std::vector<oscquery_client*> m_unfilteredClients;
   std::atomic_int m_clientCount{};
 
   ossia::net::device_base* m_device{};
@@ -144,6 +186,8 @@ private:
   // To lock m_clients
   mutex_t m_clientsMutex;
 
+  std::optional<ossia::net::outbound_queue_configuration> m_outboundQueue;
+
   // The local ports
   uint16_t m_oscPort{};
   uint16_t m_wsPort{};
@@ -39,6 +39,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/pod_vector.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/ptr_container.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/regex_fwd.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/rt_audit.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/std_fwd.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/safe_vec.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/size.hpp"
@@ -67,6 +68,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/unix_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/serial_socket.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/null_socket.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/outbound_queue.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/framing.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/size_prefix_framing.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/slip_framing.hpp"
@@ -106,6 +108,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/node.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/message_origin_identifier.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/node_functions.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/address_index.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/listening.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/node_attributes.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/osc_address.hpp"
@@ -116,6 +119,7 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/debug.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/extended_types.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/path.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/pattern_matcher.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/complex_type.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/device_parameter.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/generic/generic_parameter.hpp"
@@ -175,16 +179,20 @@ set(API_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/dataspace/time.hpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/rate_limiting_protocol.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/timer_wheel.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/coalescing_protocol.hpp"
     )
 
 set(SRCS
     ${API_HEADERS}
 #    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/ossia.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/context.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/rt_audit.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/thread.cpp"
 #    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/detail/instantiations.cpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/context.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/sockets/outbound_queue.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/domain/domain_base.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/domain/detail/domain_impl.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/domain/clamp.cpp"
@@ -193,6 +201,7 @@ set(SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/domain/wrap.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/domain/fold.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/parameter.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/address_index.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/device.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/name_validation.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/node.cpp"
@@ -202,6 +211,7 @@ set(SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/base/protocol.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/extended_types.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/path.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/pattern_matcher.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/complex_type.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/debug.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/common/device_parameter.cpp"
@@ -213,6 +223,8 @@ set(SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/zeroconf/zeroconf.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/exceptions.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/rate_limiting_protocol.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/timer_wheel.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/network/coalescing_protocol.cpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/preset/preset.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/preset/exception.cpp"
@@ -629,6 +641,8 @@ set(OSSIA_DATAFLOW_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/jack_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/sdl_protocol.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/dummy_protocol.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/offline_engine.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/tick_statistics.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/bench_map.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/dataflow.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/connection.hpp"
@@ -638,7 +652,10 @@ set(OSSIA_DATAFLOW_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_port.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_stretch_mode.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/midi_port.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_cache.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_kernels.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/data_copy.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/delay_ring.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/dataflow_fwd.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/execution_state.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/exec_state_facade.hpp"
@@ -648,6 +665,7 @@ set(OSSIA_DATAFLOW_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph_node.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/node_process.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/port.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/slot_state.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/control_inlets.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/timed_value.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/transport.hpp"
@@ -689,6 +707,7 @@ set(OSSIA_DATAFLOW_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/step.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/sound_mmap.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/sound_ref.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/sound_stream.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/sound_impl.hpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/safe_nodes/node.hpp"
@@ -702,6 +721,7 @@ set(OSSIA_DATAFLOW_HEADERS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/graph_parallel.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/graph_parallel_impl.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/graph_utils.hpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/incremental_ordering.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/graph_interface.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/tick_methods.hpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/tick_setup.hpp"
@@ -715,11 +735,16 @@ set(OSSIA_DATAFLOW_SRCS
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_protocol.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_device.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/audio_engine.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/offline_engine.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/audio/tick_statistics.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_cache.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/audio_kernels.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/data.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/port.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph_node.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/execution_state.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/state.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/nodes/sound_stream.cpp"
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/control_inlets.cpp"
 
     "${CMAKE_CURRENT_SOURCE_DIR}/ossia/dataflow/graph/graph.cpp"
@@ -0,0 +1,93 @@
+#include <ossia/dataflow/audio_kernels.hpp>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace ossia::kernels;
+
+// The instruction sets to compare, in the order of the benchmark argument
+static const char* const instruction_sets[]{"scalar", "simd", "sse2", "avx2", "avx512"};
+static constexpr std::size_t frames = 512;
+
+static bool use_instruction_set(benchmark::State& st)
+{
+  const char* isa = instruction_sets[st.range(0)];
+  if (!set_instruction_set(isa))
+  {
+    st.SkipWithError("not available on this CPU");
+    return false;
+  }
+  st.SetLabel(isa);
+  return true;
+}
+
+static void BM_mix(benchmark::State& st)
+{
+  if (!use_instruction_set(st))
+    return;
+  std::vector<sample> src(frames, sample(0.5)), dst(frames);
+  for (auto _ : st)
+  {
+    mix(src.data(), dst.data(), frames);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  st.SetItemsProcessed(st.iterations() * frames);
+}
+
+static void BM_gain(benchmark::State& st)
+{
+  if (!use_instruction_set(st))
+    return;
+  std::vector<sample> src(frames, sample(0.5)), dst(frames);
+  for (auto _ : st)
+  {
+    gain(src.data(), dst.data(), sample(0.7), frames);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  st.SetItemsProcessed(st.iterations() * frames);
+}
+
+static void BM_gain_pan(benchmark::State& st)
+{
+  if (!use_instruction_set(st))
+    return;
+  std::vector<sample> src(frames, sample(0.5)), left(frames), right(frames);
+  sample* dst[2]{left.data(), right.data()};
+  const sample pan[2]{sample(0.3), sample(0.7)};
+  for (auto _ : st)
+  {
+    gain_pan(src.data(), dst, sample(0.7), pan, 2, frames);
+    benchmark::DoNotOptimize(left.data());
+    benchmark::DoNotOptimize(right.data());
+  }
+  st.SetItemsProcessed(st.iterations() * frames);
+}
+
+static void BM_sum_gain(benchmark::State& st)
+{
+  if (!use_instruction_set(st))
+    return;
+  constexpr std::size_t inputs = 8;
+  std::vector<std::vector<sample>> buffers(inputs, std::vector<sample>(frames, sample(0.5)));
+  const sample* src[inputs];
+  sample gains[inputs];
+  for (std::size_t k = 0; k < inputs; k++)
+  {
+    src[k] = buffers[k].data();
+    gains[k] = sample(1. / (k + 1));
+  }
+  std::vector<sample> dst(frames);
+  for (auto _ : st)
+  {
+    sum_gain(src, gains, inputs, dst.data(), frames);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  st.SetItemsProcessed(st.iterations() * frames * inputs);
+}
+
+BENCHMARK(BM_mix)->DenseRange(0, 4);
+BENCHMARK(BM_gain)->DenseRange(0, 4);
+BENCHMARK(BM_gain_pan)->DenseRange(0, 4);
+BENCHMARK(BM_sum_gain)->DenseRange(0, 4);
+
+BENCHMARK_MAIN();
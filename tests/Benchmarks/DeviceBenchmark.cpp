@@ -30,5 +30,27 @@ static void BM_SomeFunction(benchmark::State& state) {
 }
 // Register the function as a benchmark
 BENCHMARK(BM_SomeFunction)->DenseRange(0, 500, 50);
+
+// Lookup of the children of a wide node, e.g. a bank of pixels.
+static void BM_FindNodeWide(benchmark::State& state)
+{
+  const int k = state.range(0);
+  ossia::net::generic_device dev{"dev"};
+  auto& bank = ossia::net::create_node(dev, "/bank");
+  for(int i = 0; i < k; i++)
+    bank.create_child("pixel." + std::to_string(i));
+
+  std::vector<std::string> addresses;
+  for(int i = 0; i < k; i += std::max(1, k / 64))
+    addresses.push_back("/bank/pixel." + std::to_string(i));
+  addresses.push_back("/bank/missing");
+
+  for (auto _ : state) {
+    for(const auto& addr : addresses)
+      benchmark::DoNotOptimize(ossia::net::find_node(dev, addr));
+  }
+  state.SetItemsProcessed(state.iterations() * addresses.size());
+}
+BENCHMARK(BM_FindNodeWide)->RangeMultiplier(4)->Range(8, 1 << 14);
 // Run the benchmark
 BENCHMARK_MAIN();
@@ -34,6 +34,10 @@ void benchmark_main()
   // We need a graph
 
 
+  // Build with OSSIA_AUDIO_FLOAT to compare with single-precision processing
+  std::cout << "samples: "
+            << (std::is_same_v<audio_processing_sample, float> ? "float" : "double")
+            << "\n";
   std::cout << "count\tnormal\tordered\tmerged\n";
   ossia::audio_device device;
   int64_t count = 0;
@@ -0,0 +1,78 @@
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/context.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/protocols/oscquery/oscquery_mirror_asio.hpp>
+#include <ossia/protocols/oscquery/oscquery_server_asio.hpp>
+#include <benchmark/benchmark.h>
+
+#include <ctime>
+#include <thread>
+
+// Cost, for the thread pushing the values, of an OSCQuery server with N
+// mirrors connected on the loopback.
+// Arguments: number of clients, 0 for values sent over OSC / UDP,
+// 1 for critical values sent over WebSocket.
+
+using namespace std::literals;
+
+static int64_t thread_cpu_ns()
+{
+  timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec * 1'000'000'000 + t.tv_nsec;
+}
+
+static void BM_oscquery_push(benchmark::State& st)
+{
+  const int clients = st.range(0);
+  const bool critical = st.range(1);
+
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::generic_device server{
+      std::make_unique<ossia::oscquery_asio::oscquery_server_protocol>(ctx, 1234, 5678),
+      "server"};
+  auto& param = *ossia::net::create_node(server, "/foo")
+                     .create_parameter(ossia::val_type::FLOAT);
+  param.set_critical(critical);
+
+  std::vector<std::unique_ptr<ossia::net::generic_device>> mirrors;
+  for (int i = 0; i < clients; i++)
+  {
+    mirrors.push_back(std::make_unique<ossia::net::generic_device>(
+        std::make_unique<ossia::oscquery_asio::oscquery_mirror_asio_protocol>(
+            ctx, "ws://127.0.0.1:5678"),
+        "client" + std::to_string(i)));
+  }
+
+  // The clients connect and start OSC streaming from the io_context thread
+  std::thread io{[&] { ctx->run(); }};
+  std::this_thread::sleep_for(1s);
+
+  float v = 0.f;
+  int64_t cpu = 0;
+  for (auto _ : st)
+  {
+    const int64_t t0 = thread_cpu_ns();
+    for (int i = 0; i < 100; i++)
+      param.push_value(v += 1.f);
+    cpu += thread_cpu_ns() - t0;
+
+    // Lets the clients receive so that the socket buffers do not fill up
+    std::this_thread::sleep_for(1ms);
+  }
+
+  ctx->context.stop();
+  io.join();
+  mirrors.clear();
+
+  const int64_t n = st.iterations() * 100;
+  st.SetItemsProcessed(n);
+  st.counters["cpu_ns/push"] = n > 0 ? double(cpu) / n : 0.;
+}
+
+BENCHMARK(BM_oscquery_push)
+    ->Args({1, 0})->Args({8, 0})->Args({32, 0})
+    ->Args({1, 1})->Args({8, 1})->Args({32, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
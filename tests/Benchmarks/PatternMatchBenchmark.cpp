@@ -0,0 +1,103 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/common/path.hpp>
+#include <ossia/network/common/pattern_matcher.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <regex>
+
+// Compares the compiled pattern matcher with the std::regex translation
+// that was used before, on the node names of the address corpus.
+
+static const std::vector<std::string> patterns{
+    "*", "Dsb", "rO72t*", "*X*", "[A-Z]*", "[!0-9]*", "{Dsb,22J,3V7Z}",
+    "*{1..9}", "?b", "hMai*v", "{a,b,c}*{x,y,z}", "Sv8kP0!"};
+
+static const std::vector<std::string>& corpus()
+{
+  static const std::vector<std::string> addresses = [] {
+    std::vector<std::string> res;
+    std::ifstream f{OSSIA_ADDRESS_CORPUS};
+    for (std::string line; std::getline(f, line);)
+      if (!line.empty())
+        res.push_back(std::move(line));
+    return res;
+  }();
+  return addresses;
+}
+
+static const std::vector<std::string>& names()
+{
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> res;
+    for (const auto& address : corpus())
+      res.push_back(address.substr(address.find_last_of('/') + 1));
+    return res;
+  }();
+  return names;
+}
+
+static void BM_match_regex(benchmark::State& state)
+{
+  std::vector<std::regex> rx;
+  for (auto p : patterns)
+  {
+    ossia::net::expand_ranges(p);
+    rx.emplace_back("^" + ossia::traversal::substitute_characters(p) + "$");
+  }
+
+  for (auto _ : state)
+  {
+    std::size_t n = 0;
+    for (const auto& r : rx)
+      for (const auto& name : names())
+        n += std::regex_match(name, r);
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * rx.size() * names().size());
+}
+BENCHMARK(BM_match_regex);
+
+static void BM_match_compiled(benchmark::State& state)
+{
+  std::vector<ossia::traversal::pattern_matcher> matchers;
+  for (auto p : patterns)
+  {
+    ossia::net::expand_ranges(p);
+    matchers.emplace_back(p);
+  }
+
+  for (auto _ : state)
+  {
+    std::size_t n = 0;
+    for (const auto& m : matchers)
+      for (const auto& name : names())
+        n += m(name);
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(
+      state.iterations() * matchers.size() * names().size());
+}
+BENCHMARK(BM_match_compiled);
+
+static void BM_find_nodes(benchmark::State& state)
+{
+  ossia::net::generic_device dev{"bench"};
+  for (const auto& address : corpus())
+    ossia::net::find_or_create_node(dev, address);
+
+  for (auto _ : state)
+  {
+    std::size_t n = 0;
+    for (const auto& p : patterns)
+      n += ossia::net::find_nodes(dev.get_root_node(), "//" + p).size();
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK(BM_find_nodes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+#include <ossia/dataflow/audio_kernels.hpp>
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace ossia::kernels;
+
+// Frames read from a sound file at once, as by sound_mmap
+static constexpr std::size_t frames = 4096;
+
+static const char* const instruction_sets[]{"scalar", "simd", "sse2", "avx2", "avx512"};
+static const char* const formats[]{"u8", "s16", "s24", "s32", "f32", "f64"};
+static constexpr std::size_t sample_sizes[]{1, 2, 3, 4, 4, 8};
+
+// The sample-major loops of the sound readers before the kernels:
+// the writes jump from channel to channel.
+static void previous_loop(
+    pcm_format format, const uint8_t* data, float* const* dst, std::size_t channels,
+    std::size_t n)
+{
+  for (std::size_t j = 0; j < n; j++)
+  {
+    for (std::size_t i = 0; i < channels; i++)
+    {
+      const std::size_t k = j * channels + i;
+      switch (format)
+      {
+        case pcm_format::u8:
+          dst[i][j] = data[k] / 127.f - 1.f;
+          break;
+        case pcm_format::s16:
+        {
+          int16_t x;
+          std::memcpy(&x, data + 2 * k, 2);
+          dst[i][j] = (x + .5f) / (0x7FFF + .5f);
+          break;
+        }
+        case pcm_format::s24:
+        {
+          const uint8_t* b = data + 3 * k;
+          const int32_t x = int32_t(
+              (uint32_t(b[0]) << 8) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 24));
+          dst[i][j] = (x >> 8) / (float(std::numeric_limits<int32_t>::max()) / 256.f);
+          break;
+        }
+        case pcm_format::s32:
+        {
+          int32_t x;
+          std::memcpy(&x, data + 4 * k, 4);
+          dst[i][j] = x / float(std::numeric_limits<int32_t>::max());
+          break;
+        }
+        case pcm_format::f32:
+        {
+          float x;
+          std::memcpy(&x, data + 4 * k, 4);
+          dst[i][j] = x;
+          break;
+        }
+        case pcm_format::f64:
+        {
+          double x;
+          std::memcpy(&x, data + 8 * k, 8);
+          dst[i][j] = x;
+          break;
+        }
+      }
+    }
+  }
+}
+
+// Arguments: instruction set (or 5 for the previous loops), format, channels
+static void BM_decode_pcm(benchmark::State& st)
+{
+  const auto implementation = std::size_t(st.range(0));
+  const auto format = pcm_format(st.range(1));
+  const auto channels = std::size_t(st.range(2));
+
+  if (implementation < std::size(instruction_sets))
+  {
+    if (!set_instruction_set(instruction_sets[implementation]))
+    {
+      st.SkipWithError("not available on this CPU");
+      return;
+    }
+    st.SetLabel(std::string(instruction_sets[implementation]) + " " + formats[st.range(1)]);
+  }
+  else
+  {
+    st.SetLabel(std::string("previous loop ") + formats[st.range(1)]);
+  }
+
+  // Zeroes would make the float conversions unusually fast
+  std::vector<uint8_t> data(frames * channels * sample_sizes[st.range(1)]);
+  for (std::size_t i = 0; i < data.size(); i++)
+    data[i] = uint8_t(i * 37 + 11);
+  if (format == pcm_format::f32 || format == pcm_format::f64)
+  {
+    for (std::size_t k = 0; k < frames * channels; k++)
+    {
+      const float f = float(k % 200) / 100.f - 1.f;
+      const double d = f;
+      if (format == pcm_format::f32)
+        std::memcpy(data.data() + 4 * k, &f, 4);
+      else
+        std::memcpy(data.data() + 8 * k, &d, 8);
+    }
+  }
+
+  std::vector<std::vector<float>> out(channels, std::vector<float>(frames));
+  std::vector<float*> dst;
+  for (auto& chan : out)
+    dst.push_back(chan.data());
+
+  for (auto _ : st)
+  {
+    if (implementation < std::size(instruction_sets))
+      decode_pcm(format, data.data(), dst.data(), channels, frames);
+    else
+      previous_loop(format, data.data(), dst.data(), channels, frames);
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(st.iterations() * frames * channels);
+}
+
+BENCHMARK(BM_decode_pcm)->ArgsProduct({benchmark::CreateDenseRange(0, 5, 1),
+                                       benchmark::CreateDenseRange(0, 5, 1),
+                                       {1, 2, 8}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#include <ossia/network/sockets/udp_socket.hpp>
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+// Loopback throughput of the UDP sockets: one datagram per system call and
+// completion handler, against the batched recvmmsg / sendmmsg paths.
+// cpu_ns/packet is the CPU time of the thread receiving, resp. sending.
+
+using namespace std::literals;
+using ossia::net::udp_receive_socket;
+using ossia::net::udp_send_socket;
+
+static constexpr uint16_t port = 9987;
+static constexpr int64_t packets_per_iteration = 20000;
+
+// An OSC message with a float: /foo ,f 1.0
+static const char message[]
+    = {'/', 'f', 'o', 'o', 0, 0, 0, 0, ',', 'f', 0, 0, 0x3f, -128, 0, 0};
+
+static int64_t thread_cpu_ns()
+{
+  timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec * 1'000'000'000 + t.tv_nsec;
+}
+
+// Arguments: 0 for one datagram per receive, 1 for batches
+static void BM_udp_receive(benchmark::State& st)
+{
+  const bool batched = st.range(0);
+
+  boost::asio::io_context ctx;
+  udp_receive_socket recv{{"127.0.0.1", port}, ctx};
+  recv.open();
+  recv.m_socket.set_option(boost::asio::socket_base::receive_buffer_size(8 << 20));
+
+  std::atomic<int64_t> received{};
+  auto on_packet = [&](const char*, std::size_t) {
+    received.store(received.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  };
+#if defined(__linux__)
+  if (batched)
+    recv.receive_batch(on_packet);
+  else
+#endif
+    recv.receive_one(on_packet);
+
+  // The sender keeps a bounded number of datagrams in flight so that none
+  // is lost in the socket buffer.
+  std::atomic<int64_t> target{};
+  std::atomic_bool stop{};
+  std::thread sender{[&] {
+    boost::asio::io_context sctx;
+    udp_send_socket send{{"127.0.0.1", port}, sctx};
+    send.connect();
+
+    std::vector<boost::asio::const_buffer> bufs(32, boost::asio::buffer(message));
+    int64_t sent = 0;
+    while (!stop.load(std::memory_order_relaxed))
+    {
+      if (sent < target.load(std::memory_order_acquire)
+          && sent - received.load(std::memory_order_acquire) < 512)
+      {
+        send.write_many(bufs.data(), bufs.size());
+        sent += bufs.size();
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  int64_t cpu = 0;
+  for (auto _ : st)
+  {
+    target += packets_per_iteration;
+    const int64_t t0 = thread_cpu_ns();
+    while (received.load(std::memory_order_acquire) < target && ctx.run_one_for(100ms))
+      ;
+    cpu += thread_cpu_ns() - t0;
+  }
+
+  stop = true;
+  sender.join();
+
+  const int64_t n = received.load();
+  st.SetItemsProcessed(n);
+  st.counters["cpu_ns/packet"] = n > 0 ? double(cpu) / n : 0.;
+  st.counters["lost"] = double(target.load() - std::min(n, target.load()));
+}
+
+// Arguments: 0 for one datagram per send, 1 for sendmmsg batches of 32
+static void BM_udp_send(benchmark::State& st)
+{
+  const bool batched = st.range(0);
+
+  // Bound but never read: the kernel drops what does not fit
+  boost::asio::io_context ctx;
+  udp_receive_socket recv{{"127.0.0.1", port}, ctx};
+  recv.open();
+
+  udp_send_socket send{{"127.0.0.1", port}, ctx};
+  send.connect();
+  std::vector<boost::asio::const_buffer> bufs(32, boost::asio::buffer(message));
+
+  int64_t cpu = 0;
+  int64_t sent = 0;
+  for (auto _ : st)
+  {
+    const int64_t t0 = thread_cpu_ns();
+    for (int64_t i = 0; i < packets_per_iteration; i += bufs.size())
+    {
+      if (batched)
+        send.write_many(bufs.data(), bufs.size());
+      else
+        for (std::size_t k = 0; k < bufs.size(); k++)
+          send.write(message, sizeof(message));
+      sent += bufs.size();
+    }
+    cpu += thread_cpu_ns() - t0;
+  }
+
+  st.SetItemsProcessed(sent);
+  st.counters["cpu_ns/packet"] = sent > 0 ? double(cpu) / sent : 0.;
+}
+
+BENCHMARK(BM_udp_receive)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_udp_send)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,117 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/dataflow/audio_cache.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace ossia;
+
+// Two channels of 1000 samples: 8000 bytes
+static constexpr std::size_t sound_bytes = 2 * 1000 * sizeof(audio_sample);
+
+static audio_cache::decoder make_decoder(std::atomic_int& decodes)
+{
+  return [&decodes] {
+    decodes++;
+    auto h = std::make_shared<audio_data>();
+    h->data.resize(2);
+    for (auto& chan : h->data)
+      chan.resize(1000);
+    return h;
+  };
+}
+
+TEST_CASE ("test_audio_cache_share", "test_audio_cache_share")
+{
+  audio_cache cache{1024 * 1024};
+  std::atomic_int decodes{};
+
+  const audio_cache_key a{"a.wav", 0, 48000, 0};
+  auto first = cache.load(a, make_decoder(decodes));
+  auto second = cache.load(a, make_decoder(decodes));
+  REQUIRE(first.get());
+  REQUIRE(first.get() == second.get());
+  REQUIRE(cache.find(a) == first.get());
+  REQUIRE(decodes == 1);
+
+  // Another sample rate is another sound
+  const audio_cache_key resampled{"a.wav", 0, 44100, 0};
+  REQUIRE(cache.load(resampled, make_decoder(decodes)).get() != first.get());
+  REQUIRE(decodes == 2);
+
+  const auto s = cache.stats();
+  REQUIRE(s.hits == 2);
+  REQUIRE(s.misses == 2);
+  REQUIRE(s.entries == 2);
+  REQUIRE(s.resident_bytes == 2 * sound_bytes);
+}
+
+TEST_CASE ("test_audio_cache_eviction", "test_audio_cache_eviction")
+{
+  audio_cache cache{2 * sound_bytes};
+  std::atomic_int decodes{};
+
+  const audio_cache_key a{"a.wav", 0, 48000, 0};
+  const audio_cache_key b{"b.wav", 0, 48000, 0};
+  const audio_cache_key c{"c.wav", 0, 48000, 0};
+
+  // Still used: never evicted
+  const audio_handle used = cache.load(a, make_decoder(decodes)).get();
+  cache.load(b, make_decoder(decodes)).get();
+  cache.load(c, make_decoder(decodes)).get();
+
+  // b is the least recently used of the unreferenced sounds
+  REQUIRE(cache.stats().evictions == 1);
+  REQUIRE(cache.find(a) == used);
+  REQUIRE(!cache.find(b));
+  REQUIRE(cache.find(c));
+  REQUIRE(cache.stats().resident_bytes == 2 * sound_bytes);
+
+  cache.set_budget(sound_bytes);
+  REQUIRE(cache.stats().evictions == 2);
+  REQUIRE(cache.find(a) == used);
+  REQUIRE(!cache.find(c));
+
+  // Decoded again
+  cache.load(b, make_decoder(decodes)).get();
+  REQUIRE(decodes == 4);
+}
+
+TEST_CASE ("test_audio_cache_over_budget", "test_audio_cache_over_budget")
+{
+  audio_cache cache{sound_bytes / 2};
+  std::atomic_int decodes{};
+
+  const audio_cache_key a{"a.wav", 0, 48000, 0};
+  const audio_cache_key b{"b.wav", 0, 48000, 0};
+
+  // The sound just decoded is kept even if it does not fit
+  REQUIRE(cache.load(a, make_decoder(decodes)).get());
+  REQUIRE(cache.load(a, make_decoder(decodes)).get());
+  REQUIRE(decodes == 1);
+  REQUIRE(cache.stats().evictions == 0);
+  REQUIRE(cache.stats().resident_bytes == sound_bytes);
+
+  // Until another one replaces it
+  REQUIRE(cache.load(b, make_decoder(decodes)).get());
+  REQUIRE(decodes == 2);
+  REQUIRE(cache.stats().evictions == 1);
+  REQUIRE(!cache.find(a));
+  REQUIRE(cache.find(b));
+}
+
+TEST_CASE ("test_audio_cache_failure", "test_audio_cache_failure")
+{
+  audio_cache cache{1024 * 1024};
+  const audio_cache_key a{"a.wav", 0, 48000, 0};
+
+  REQUIRE(!cache.load(a, [] () -> audio_handle { throw std::runtime_error("corrupt"); }).get());
+  REQUIRE(!cache.load(a, [] { return audio_handle{}; }).get());
+  REQUIRE(cache.stats().entries == 0);
+
+  std::atomic_int decodes{};
+  REQUIRE(cache.load(a, make_decoder(decodes)).get());
+}
@@ -0,0 +1,192 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/dataflow/audio_kernels.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace ossia::kernels;
+
+// Sizes around the vector widths, to check the remainders
+static const std::size_t sizes[]{0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 64, 100, 513};
+
+static std::vector<sample> ramp(std::size_t n, double start, double step)
+{
+  std::vector<sample> v(n);
+  for (std::size_t i = 0; i < n; i++)
+    v[i] = sample(start + i * step);
+  return v;
+}
+
+TEST_CASE ("test_audio_kernels", "test_audio_kernels")
+{
+  const std::string initial = instruction_set();
+  for (auto isa : {"scalar", "simd", "sse2", "avx2", "avx512"})
+  {
+    if (!set_instruction_set(isa))
+      continue;
+    INFO(isa);
+    REQUIRE(instruction_set() == std::string(isa));
+
+    for (std::size_t n : sizes)
+    {
+      INFO(n);
+      const auto a = ramp(n, 0., 0.5);
+      const auto b = ramp(n, 1., -0.25);
+
+      auto res = b;
+      mix(a.data(), res.data(), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == b[i] + a[i]);
+
+      // In place
+      res = a;
+      gain(res.data(), res.data(), sample(0.5), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == a[i] * sample(0.5));
+
+      std::vector<sample> left(n), right(n);
+      sample* out[2]{left.data(), right.data()};
+      const sample pan[2]{sample(0.25), sample(2.)};
+      gain_pan(a.data(), out, sample(0.5), pan, 2, n);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        REQUIRE(left[i] == a[i] * sample(0.5) * pan[0]);
+        REQUIRE(right[i] == a[i] * sample(0.5) * pan[1]);
+      }
+
+      const sample* in[2]{a.data(), b.data()};
+      const sample gains[2]{sample(2.), sample(3.)};
+      sum_gain(in, gains, 2, res.data(), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == a[i] * gains[0] + b[i] * gains[1]);
+
+      sum_gain(in, gains, 0, res.data(), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == 0);
+
+      gain_ramp(a.data(), res.data(), sample(0.2), sample(0.01), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == Approx(a[i] * (0.2 + i * 0.01)).epsilon(1e-5));
+
+      gain_curve(a.data(), res.data(), sample(1.), sample(-0.8), sample(0.99), n);
+      for (std::size_t i = 0; i < n; i++)
+        REQUIRE(res[i] == Approx(a[i] * (1. - 0.8 * std::pow(0.99, i))).epsilon(1e-5));
+    }
+  }
+
+  REQUIRE(!set_instruction_set("unknown"));
+  REQUIRE(set_instruction_set(initial));
+}
+
+// Interleaved samples, and the values they encode
+struct pcm_data
+{
+  pcm_format format;
+  std::vector<uint8_t> bytes;
+  std::vector<double> values;
+};
+
+template <typename T>
+static void append(pcm_data& d, T x, double value)
+{
+  const auto p = reinterpret_cast<const uint8_t*>(&x);
+  d.bytes.insert(d.bytes.end(), p, p + sizeof(T));
+  d.values.push_back(value);
+}
+
+static pcm_data make_pcm(pcm_format format, std::size_t count)
+{
+  const double int32_max = std::numeric_limits<int32_t>::max();
+  pcm_data d{format, {}, {}};
+  for (std::size_t k = 0; k < count; k++)
+  {
+    switch (format)
+    {
+      case pcm_format::u8:
+      {
+        const uint8_t x = k * 37;
+        append(d, x, x / 127. - 1.);
+        break;
+      }
+      case pcm_format::s16:
+      {
+        const int16_t x = int(k * 2741 % 65536) - 32768;
+        append(d, x, (x + .5) / (0x7FFF + .5));
+        break;
+      }
+      case pcm_format::s24:
+      {
+        const int32_t x = int32_t(k * 104729 % (1 << 24)) - (1 << 23);
+        const uint8_t bytes[3]{uint8_t(x), uint8_t(x >> 8), uint8_t(x >> 16)};
+        d.bytes.insert(d.bytes.end(), bytes, bytes + 3);
+        d.values.push_back(x * 256. / int32_max);
+        break;
+      }
+      case pcm_format::s32:
+      {
+        const int32_t x = int32_t(uint32_t(k * 2654435761u));
+        append(d, x, x / int32_max);
+        break;
+      }
+      case pcm_format::f32:
+      {
+        const float x = std::sin(k);
+        append(d, x, x);
+        break;
+      }
+      case pcm_format::f64:
+      {
+        const double x = std::sin(k);
+        append(d, x, float(x));
+        break;
+      }
+    }
+  }
+  return d;
+}
+
+TEST_CASE ("test_decode_pcm", "test_decode_pcm")
+{
+  const std::string initial = instruction_set();
+  for (auto isa : {"scalar", "simd", "sse2", "avx2", "avx512"})
+  {
+    if (!set_instruction_set(isa))
+      continue;
+    INFO(isa);
+
+    for (auto format :
+         {pcm_format::u8, pcm_format::s16, pcm_format::s24, pcm_format::s32,
+          pcm_format::f32, pcm_format::f64})
+    {
+      INFO(int(format));
+      for (std::size_t channels : {1, 2, 3, 6})
+      {
+        INFO(channels);
+        for (std::size_t n : sizes)
+        {
+          INFO(n);
+          const auto data = make_pcm(format, n * channels);
+
+          std::vector<std::vector<float>> res(channels, std::vector<float>(n));
+          std::vector<float*> dst;
+          for (auto& chan : res)
+            dst.push_back(chan.data());
+          decode_pcm(format, data.bytes.data(), dst.data(), channels, n);
+
+          for (std::size_t c = 0; c < channels; c++)
+            for (std::size_t i = 0; i < n; i++)
+              REQUIRE(
+                  res[c][i]
+                  == Approx(data.values[i * channels + c]).epsilon(1e-6).margin(1e-7));
+        }
+      }
+    }
+  }
+  REQUIRE(set_instruction_set(initial));
+}
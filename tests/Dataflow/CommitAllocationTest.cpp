@@ -0,0 +1,116 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+#include <ossia/dataflow/typed_value.hpp>
+#include <ossia/network/base/node_attributes.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts the allocations made while g_count_allocations is set
+static std::atomic_bool g_count_allocations{};
+static std::atomic_int g_allocations{};
+
+void* operator new(std::size_t sz)
+{
+  if (g_count_allocations)
+    g_allocations++;
+  if (auto p = std::malloc(sz ? sz : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+struct priorized_setup
+{
+  ossia::net::generic_device device{"test"};
+  std::vector<ossia::net::parameter_base*> parameters;
+  ossia::execution_state state;
+
+  priorized_setup(int count)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      auto& node = ossia::net::create_node(device, "/p." + std::to_string(i));
+      parameters.push_back(node.create_parameter(ossia::val_type::FLOAT));
+      ossia::net::set_priority(node, float(i % 7));
+    }
+    state.register_device(&device);
+  }
+
+  void tick(float v)
+  {
+    state.begin_tick();
+    for (auto p : parameters)
+      state.insert(*p, ossia::typed_value{ossia::value{v}});
+    state.insert(*parameters[0], ossia::typed_value{ossia::value{v + 1.f}});
+    state.commit_priorized();
+  }
+};
+
+TEST_CASE ("test_commit_priorized_allocations", "test_commit_priorized_allocations")
+{
+  priorized_setup setup{64};
+
+  // The slots, the priorities and the sorting structures reach their size
+  setup.tick(0.f);
+  setup.tick(1.f);
+
+  g_allocations = 0;
+  g_count_allocations = true;
+  for (int i = 0; i < 100; i++)
+    setup.tick(float(i));
+  g_count_allocations = false;
+
+  REQUIRE(g_allocations == 0);
+  REQUIRE(setup.parameters[0]->value() == ossia::value{100.f});
+  REQUIRE(setup.parameters[1]->value() == ossia::value{99.f});
+}
+
+TEST_CASE ("test_commit_priorized_order", "test_commit_priorized_order")
+{
+  ossia::net::generic_device device{"test"};
+  auto& a = ossia::net::create_node(device, "/a");
+  auto& b = ossia::net::create_node(device, "/b");
+  auto pa = a.create_parameter(ossia::val_type::INT);
+  auto pb = b.create_parameter(ossia::val_type::INT);
+  ossia::net::set_priority(a, 2.f);
+  ossia::net::set_priority(b, 1.f);
+
+  std::vector<std::string> order;
+  pa->add_callback([&](const ossia::value&) { order.push_back("a"); });
+  pb->add_callback([&](const ossia::value&) { order.push_back("b"); });
+
+  ossia::execution_state state;
+  state.register_device(&device);
+
+  auto tick = [&] {
+    order.clear();
+    state.begin_tick();
+    state.insert(*pa, ossia::typed_value{ossia::value{1}});
+    state.insert(*pb, ossia::typed_value{ossia::value{1}});
+    state.commit_priorized();
+  };
+
+  tick();
+  REQUIRE(order == std::vector<std::string>{"b", "a"});
+
+  // The cached priorities follow the changes of the attribute
+  ossia::net::set_priority(a, 0.f);
+  tick();
+  REQUIRE(order == std::vector<std::string>{"a", "b"});
+}
@@ -5,7 +5,9 @@
 #include <ossia/detail/config.hpp>
 #include <ossia/dataflow/graph/graph.hpp>
 #include <ossia/dataflow/graph/graph_static.hpp>
+#include <ossia/network/base/node_functions.hpp>
 #include <ossia/network/base/parameter.hpp>
+#include <ossia/network/base/protocol.hpp>
 #include "../Editor/TestUtils.hpp"
 #include "../Network/TestUtils.hpp"
 
@@ -475,6 +477,108 @@ TEST_CASE ("test_tcl_addr", "test_tcl_addr")
   g.update_fun(g, std::vector<ossia::net::device_base*>{&test.device});
 }
 
+TEST_CASE ("pattern_destination_cache", "pattern_destination_cache")
+{
+  using namespace ossia;
+
+  TestDevice test;
+  ossia::execution_state e;
+  e.register_device(&test.device);
+  e.begin_tick();
+
+  auto root = test.device.create_child("lights");
+  root->create_child("1")->create_child("intensity")->create_parameter(val_type::FLOAT);
+  root->create_child("2")->create_child("intensity")->create_parameter(val_type::FLOAT);
+
+  destination_t dest = *traversal::make_path("test:/lights/*/intensity");
+  destination_cache cache;
+
+  auto resolve = [&] {
+    int count = 0;
+    apply_to_destination(dest, e.exec_devices(), cache, e.tree_version(),
+                         [&] (ossia::net::parameter_base*, bool) { count++; },
+                         do_nothing_for_nodes{});
+    return count;
+  };
+
+  REQUIRE(resolve() == 2);
+  const auto version = cache.version;
+
+  // Nothing changed: the cached resolution is used
+  REQUIRE(resolve() == 2);
+  REQUIRE(cache.version == version);
+
+  // Creating a node invalidates the cache
+  root->create_child("3")->create_child("intensity")->create_parameter(val_type::FLOAT);
+  REQUIRE(resolve() == 3);
+  REQUIRE(cache.version != version);
+
+  // So do renames and removals
+  root->find_child("3")->set_name("foo");
+  REQUIRE(resolve() == 3);
+  root->remove_child("1");
+  REQUIRE(resolve() == 2);
+
+  // And changing the pattern
+  dest = *traversal::make_path("test:/lights/2/intensity");
+  REQUIRE(resolve() == 1);
+}
+
+struct removal_observer
+{
+  std::function<void()> removing;
+  void on_removing(ossia::net::node_base&) { removing(); }
+};
+
+TEST_CASE ("pattern_destination_cache_removal", "pattern_destination_cache_removal")
+{
+  using namespace ossia;
+
+  TestDevice test;
+  ossia::execution_state e;
+  e.register_device(&test.device);
+  e.begin_tick();
+
+  auto root = test.device.create_child("lights");
+  root->create_child("1")->create_child("intensity")->create_parameter(val_type::FLOAT);
+  root->create_child("2")->create_child("intensity")->create_parameter(val_type::FLOAT);
+
+  destination_t dest = *traversal::make_path("test:/lights/*/intensity");
+  destination_cache cache;
+
+  auto tick = [&] {
+    e.begin_tick();
+    int count = 0;
+    apply_to_destination(dest, e.exec_devices(), cache, e.tree_version(),
+                         [&] (ossia::net::parameter_base* p, bool) {
+                           p->push_value(1.f);
+                           count++;
+                         },
+                         do_nothing_for_nodes{});
+    return count;
+  };
+
+  REQUIRE(tick() == 2);
+
+  // A tick runs while the node is being removed
+  uint64_t resolved_during_removal{};
+  removal_observer obs;
+  obs.removing = [&] {
+    tick();
+    resolved_during_removal = cache.version;
+  };
+  test.device.on_node_removing.connect<&removal_observer::on_removing>(obs);
+  root->remove_child("1");
+  test.device.on_node_removing.disconnect<&removal_observer::on_removing>(obs);
+
+  // What it resolved is not used by the next tick
+  REQUIRE(cache.version == resolved_during_removal);
+  REQUIRE(tick() == 1);
+  REQUIRE(cache.version != resolved_during_removal);
+  REQUIRE(cache.nodes.size() == 1);
+  REQUIRE(cache.nodes[0] == root->find_child("2")->find_child("intensity"));
+}
+
 TEST_CASE ("test_mock", "test_mock")
 {
   using namespace ossia;
@@ -814,6 +918,177 @@ TEST_CASE ("delayed_relationship", "delayed_relationship")
 
 }
 
+TEST_CASE ("delay_line_ring", "delay_line_ring")
+{
+  using namespace ossia;
+  const std::size_t cap = 16;
+  audio_delay_line line{delay_ring<audio_vector>{cap}};
+  audio_port out;
+  out.samples.resize(2);
+
+  const audio_processing_sample* first_lap[2]{};
+  for (std::size_t tick = 0; tick < 10 * cap; tick++)
+  {
+    for (auto& chan : out.samples)
+      chan.assign(512, audio_processing_sample(tick));
+    copy_data{}(out, line);
+
+    // The channels written on the first lap are reused afterwards
+    const auto& slot = line.samples[tick];
+    if (tick == 0)
+    {
+      first_lap[0] = slot[0].data();
+      first_lap[1] = slot[1].data();
+    }
+    else if (tick == cap)
+    {
+      REQUIRE(slot[0].data() == first_lap[0]);
+      REQUIRE(slot[1].data() == first_lap[1]);
+    }
+  }
+
+  // Only the last entries are kept
+  REQUIRE(line.samples.size() == 10 * cap);
+  REQUIRE(line.samples.first() == 9 * cap);
+  REQUIRE(!line.samples.contains(9 * cap - 1));
+  REQUIRE(line.samples.contains(10 * cap - 1));
+  REQUIRE(!line.samples.contains(10 * cap));
+
+  audio_port in;
+  copy_data_pos{0}(line, in);
+  REQUIRE(in.samples.empty());
+
+  copy_data_pos{9 * cap}(line, in);
+  REQUIRE(in.samples.size() == 2);
+  REQUIRE(in.samples[0].size() == 512);
+  REQUIRE(in.samples[1][511] == audio_processing_sample(9 * cap));
+}
+
+TEST_CASE ("delayed_strict_replay", "delayed_strict_replay")
+{
+  // The target starts long after the source: it still gets every tick
+  using namespace ossia;
+  TestDevice test;
+  base_graph g{test};
+
+  auto n1_out = new value_outlet;
+  auto n1 = std::make_shared<node_mock>(inlets{}, outlets{n1_out});
+  int written = 0;
+  n1->fun = [&] (token_request, exec_state_facade) {
+    n1_out->target<value_port>()->write_value(written++, 0);
+  };
+
+  auto n2_in = new value_inlet;
+  auto n2 = std::make_shared<node_mock>(inlets{n2_in}, outlets{});
+  std::vector<int> read;
+  n2->fun = [&] (token_request, exec_state_facade) {
+    for (auto& v : n2_in->target<value_port>()->get_data())
+      read.push_back(v.value.get<int>());
+  };
+
+  g.g.add_node(n1);
+  g.g.add_node(n2);
+  g.g.connect(make_edge(delayed_strict_connection{}, n1_out, n2_in, n1, n2));
+
+  // The source runs alone
+  for (int i = 0; i < 40; i++)
+  {
+    n1->request(simple_token_request{0_tv, 1_tv});
+    g.state();
+  }
+  REQUIRE(read.empty());
+
+  // Both run
+  for (int i = 0; i < 40; i++)
+  {
+    n1->request(simple_token_request{0_tv, 1_tv});
+    n2->request(simple_token_request{0_tv, 1_tv});
+    g.state();
+  }
+
+  // The target catches up
+  for (int i = 0; i < 40; i++)
+  {
+    n2->request(simple_token_request{0_tv, 1_tv});
+    g.state();
+  }
+
+  REQUIRE(written == 80);
+  REQUIRE(read.size() == 80);
+  for (int i = 0; i < 80; i++)
+    REQUIRE(read[i] == i);
+}
+
+TEST_CASE ("audio_outlet_gain_changes", "audio_outlet_gain_changes")
+{
+  using namespace ossia;
+  using chan = std::vector<audio_processing_sample>;
+  auto run = [] (audio_outlet& out, std::size_t channels) {
+    out.data.samples.clear();
+    out.data.samples.resize(channels);
+    for (auto& c : out.data.samples)
+      c.assign(8, 1.);
+    out.post_process();
+    out.gain_inlet.data.clear();
+    out.pan_inlet.data.clear();
+
+    std::vector<chan> res;
+    for (auto& c : out.data.samples)
+      res.emplace_back(c.begin(), c.end());
+    return res;
+  };
+
+  SECTION("Steps at the timestamps")
+  {
+    audio_outlet out;
+    out.gain_inlet.data.write_value(ossia::value{0.5f}, 4);
+    REQUIRE(run(out, 1)[0] == chan{1, 1, 1, 1, 0.5, 0.5, 0.5, 0.5});
+    REQUIRE(run(out, 1)[0] == chan(8, 0.5));
+  }
+
+  SECTION("Linear ramps")
+  {
+    audio_outlet out;
+    out.smoothing = audio_outlet::linear_smoothing;
+    out.smoothing_samples = 4;
+    out.gain_inlet.data.write_value(ossia::value{0.5f}, 2);
+    REQUIRE(run(out, 1)[0] == chan{1, 1, 0.875, 0.75, 0.625, 0.5, 0.5, 0.5});
+
+    // Across buffers
+    out.smoothing_samples = 16;
+    out.gain_inlet.data.write_value(ossia::value{0.f}, 0);
+    REQUIRE(run(out, 1)[0].back() == Approx(0.25));
+    REQUIRE(run(out, 1)[0].back() == 0.);
+  }
+
+  SECTION("Exponential ramps")
+  {
+    audio_outlet out;
+    out.smoothing = audio_outlet::exponential_smoothing;
+    out.smoothing_samples = 2;
+    out.gain_inlet.data.write_value(ossia::value{0.f}, 0);
+    auto res = run(out, 1)[0];
+    for (std::size_t i = 0; i < res.size(); i++)
+      REQUIRE(res[i] == Approx(std::exp(-(i + 1.) / 2.)));
+  }
+
+  SECTION("Pan")
+  {
+    audio_outlet out;
+    out.gain_inlet.data.write_value(ossia::value{0.5f}, 1);
+    out.pan_inlet.data.write_value(ossia::value{std::vector<ossia::value>{1.f, 0.f}}, 2);
+    auto res = run(out, 2);
+    REQUIRE(res[0] == chan{1, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5});
+    REQUIRE(res[1] == chan{1, 0.5, 0, 0, 0, 0, 0, 0});
+
+    // Stereo balance
+    out.pan_inlet.data.write_value(ossia::value{0.5f}, 0);
+    res = run(out, 2);
+    REQUIRE(res[0] == chan(8, 0.25));
+    REQUIRE(res[1] == chan(8, 0.5));
+  }
+}
+
 TEST_CASE ("reduced_implicit_relationship", "reduced_implicit_relationship")
 {
 
@@ -954,3 +1229,113 @@ TEST_CASE ("hierarchical_ordering", "hierarchical_ordering")
 {
 
 }
+
+namespace
+{
+struct bundle_counting_protocol final : ossia::net::protocol_base
+{
+  using sent_value = std::pair<std::string, ossia::value>;
+  int pushed{};
+  std::vector<std::vector<sent_value>> bundles;
+
+  bool pull(ossia::net::parameter_base&) override { return false; }
+  bool push(const ossia::net::parameter_base&, const ossia::value&) override
+  {
+    pushed++;
+    return true;
+  }
+  bool push_raw(const ossia::net::full_parameter_data&) override { return false; }
+  bool push_bundle_values(const std::vector<ossia::net::bundle_element>& values) override
+  {
+    auto& b = bundles.emplace_back();
+    for(auto& v : values)
+      b.emplace_back(v.parameter->get_node().osc_address(), v.value);
+    return true;
+  }
+  bool observe(ossia::net::parameter_base&, bool) override { return false; }
+  bool update(ossia::net::node_base&) override { return false; }
+};
+}
+
+TEST_CASE ("bundled_commit", "bundled_commit")
+{
+  using namespace ossia;
+  auto proto = new bundle_counting_protocol;
+  net::generic_device dev{std::unique_ptr<net::protocol_base>(proto), "dev"};
+  auto& a = *net::create_node(dev, "/a").create_parameter(val_type::INT);
+  auto& b = *net::create_node(dev, "/b").create_parameter(val_type::INT);
+  auto& c = *net::create_node(dev, "/c").create_parameter(val_type::INT);
+
+  for(auto commit : {&execution_state::commit, &execution_state::commit_merged,
+                     &execution_state::commit_ordered, &execution_state::commit_priorized})
+  {
+    proto->pushed = 0;
+    proto->bundles.clear();
+
+    execution_state e;
+    e.bundle_messages = true;
+    e.register_device(&dev);
+    e.apply_device_changes();
+
+    e.begin_tick();
+    e.insert(c, typed_value{ossia::value{3}});
+    e.insert(a, typed_value{ossia::value{1}});
+    e.insert(b, typed_value{ossia::value{2}});
+    e.insert(a, typed_value{ossia::value{4}});
+    (e.*commit)();
+
+    // One bundle for the whole tick, nothing pushed separately
+    REQUIRE(proto->pushed == 0);
+    REQUIRE(proto->bundles.size() == 1);
+    REQUIRE(a.value() == ossia::value{4});
+    REQUIRE(b.value() == ossia::value{2});
+    REQUIRE(c.value() == ossia::value{3});
+
+    using sent = std::vector<bundle_counting_protocol::sent_value>;
+    if(commit == &execution_state::commit_merged)
+    {
+      // Only the merged value of each parameter is sent
+      REQUIRE(proto->bundles[0].size() == 3);
+      const auto& bundle = proto->bundles[0];
+      const bundle_counting_protocol::sent_value last_a{"/a", ossia::value{4}};
+      REQUIRE(std::find(bundle.begin(), bundle.end(), last_a) != bundle.end());
+    }
+    else if(commit == &execution_state::commit_ordered)
+    {
+      // Ordered by the last message sent to each parameter,
+      // with each value of /a sent as it was set
+      REQUIRE(proto->bundles[0] == sent{{"/c", ossia::value{3}}, {"/b", ossia::value{2}}, {"/a", ossia::value{1}}, {"/a", ossia::value{4}}});
+    }
+    else
+    {
+      REQUIRE(proto->bundles[0].size() == 4);
+    }
+  }
+}
+
+TEST_CASE ("bundled_commit_same_parameter", "bundled_commit_same_parameter")
+{
+  using namespace ossia;
+  auto proto = new bundle_counting_protocol;
+  net::generic_device dev{std::unique_ptr<net::protocol_base>(proto), "dev"};
+  auto& a = *net::create_node(dev, "/a").create_parameter(val_type::INT);
+  auto& b = *net::create_node(dev, "/b").create_parameter(val_type::INT);
+
+  execution_state e;
+  e.bundle_messages = true;
+  e.register_device(&dev);
+  e.apply_device_changes();
+
+  e.begin_tick();
+  e.insert(a, typed_value{ossia::value{1}});
+  e.insert(b, typed_value{ossia::value{2}});
+  e.insert(a, typed_value{ossia::value{3}});
+  e.commit_ordered();
+
+  // Each value of /a is sent, not twice its last one
+  using sent = std::vector<bundle_counting_protocol::sent_value>;
+  REQUIRE(proto->pushed == 0);
+  REQUIRE(proto->bundles.size() == 1);
+  REQUIRE(proto->bundles[0] == sent{{"/b", ossia::value{2}}, {"/a", ossia::value{1}}, {"/a", ossia::value{3}}});
+  REQUIRE(a.value() == ossia::value{3});
+}
@@ -0,0 +1,65 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/dataflow/execution_state.hpp>
+#include <ossia/dataflow/port.hpp>
+#include <ossia/dataflow/typed_value.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+// A large device of which only a few parameters are written at each tick,
+// e.g. a lighting rig where a handful of automations are running.
+struct sparse_setup
+{
+  ossia::net::generic_device device{"bench"};
+  std::vector<ossia::net::parameter_base*> parameters;
+  std::vector<std::unique_ptr<ossia::value_outlet>> outlets;
+  ossia::execution_state state;
+
+  sparse_setup(int count)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      auto& node = ossia::net::create_node(device, "/p." + std::to_string(i));
+      auto param = node.create_parameter(ossia::val_type::FLOAT);
+      parameters.push_back(param);
+
+      outlets.push_back(std::make_unique<ossia::value_outlet>(*param));
+      state.register_port(*outlets.back());
+    }
+    state.register_device(&device);
+    state.apply_device_changes();
+  }
+};
+
+static void BM_sparse_commit(benchmark::State& st)
+{
+  const int count = st.range(0);
+  const int active = std::max(1, int(count * st.range(1) / 100));
+  sparse_setup setup{count};
+
+  std::mt19937 rng{0};
+  std::uniform_int_distribution<int> dist{0, count - 1};
+
+  float v = 0.f;
+  for (auto _ : st)
+  {
+    setup.state.begin_tick();
+    for (int i = 0; i < active; i++)
+    {
+      auto param = setup.parameters[dist(rng)];
+      setup.state.insert(*param, ossia::typed_value{ossia::value{v}});
+      benchmark::DoNotOptimize(setup.state.in_local_scope(*param));
+    }
+    setup.state.commit();
+    v += 1.f;
+  }
+  st.SetItemsProcessed(st.iterations() * active);
+}
+BENCHMARK(BM_sparse_commit)
+    ->ArgsProduct({{1024, 4096, 16384}, {1, 10}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,132 @@
+#include <ossia/dataflow/graph/graph_parallel.hpp>
+#include <ossia/dataflow/graph_node.hpp>
+#include <ossia/dataflow/graph_edge_helpers.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#define NUM_TAKES 1000
+#define NUM_NODES 2000
+#define NODE_WORK 200
+using namespace ossia;
+
+class node_work_mock final : public graph_node {
+public:
+  node_work_mock()
+  {
+    m_inlets.push_back(new ossia::value_inlet);
+    m_outlets.push_back(new ossia::value_outlet);
+  }
+
+  void run(const token_request& t, exec_state_facade e) noexcept override
+  {
+    double acc = m_acc;
+    for(int i = 0; i < NODE_WORK; i++)
+      acc += std::sin(acc + i);
+    m_acc = acc;
+  }
+
+  double m_acc{};
+};
+
+using node_vec = std::vector<std::shared_ptr<node_work_mock>>;
+
+template<typename T>
+void connect(T& g, const std::shared_ptr<node_work_mock>& a, const std::shared_ptr<node_work_mock>& b)
+{
+  auto edge = ossia::make_edge(ossia::immediate_strict_connection{},
+                               a->root_outputs()[0], b->root_inputs()[0],
+                               a, b);
+  g.connect(edge);
+}
+
+template<typename T>
+auto make_node(T& g, node_vec& nodes)
+{
+  auto n = std::make_shared<node_work_mock>();
+  nodes.push_back(n);
+  g.add_node(n);
+  return n;
+}
+
+// One source fanning out to many independent nodes, merged into a sink
+struct setup_wide
+{
+  template<typename T>
+  auto operator()(int num_nodes, T& g) const
+  {
+    node_vec nodes;
+    auto source = make_node(g, nodes);
+    auto sink = make_node(g, nodes);
+    for(int i = 0; i < num_nodes - 2; i++)
+    {
+      auto n = make_node(g, nodes);
+      connect(g, source, n);
+      connect(g, n, sink);
+    }
+    return nodes;
+  }
+};
+
+// A few long chains, e.g. effect chains of a DAW
+struct setup_deep
+{
+  int chain_count = 8;
+  template<typename T>
+  auto operator()(int num_nodes, T& g) const
+  {
+    node_vec nodes;
+    for(int c = 0; c < chain_count; c++)
+    {
+      std::shared_ptr<node_work_mock> prev;
+      for(int i = 0; i < num_nodes / chain_count; i++)
+      {
+        auto n = make_node(g, nodes);
+        if(prev)
+          connect(g, prev, n);
+        prev = n;
+      }
+    }
+    return nodes;
+  }
+};
+
+template<typename Graph, typename Setup>
+void measure(const char* name, Setup setup)
+{
+  auto graph = std::make_unique<Graph>();
+  auto nodes = setup(NUM_NODES, *graph);
+
+  ossia::execution_state e;
+
+  // ensure that a tick happens to make it clean
+  graph->state(e);
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for(int i = 0; i < NUM_TAKES; i++)
+  {
+    for(auto& node : nodes)
+      node->request({});
+    graph->state(e);
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / NUM_TAKES;
+  std::cerr << name << ": " << us << " us / tick" << std::endl;
+}
+
+using serial_graph = graph_static<simple_update, static_exec>;
+using central_queue_graph = graph_static<custom_parallel_update<simple_update, ossia::executor>, custom_parallel_exec>;
+using work_stealing_graph = graph_static<custom_parallel_update<simple_update, ossia::work_stealing_executor>, custom_parallel_exec>;
+
+int main()
+{
+  measure<serial_graph>("wide / serial", setup_wide{});
+  measure<central_queue_graph>("wide / central queue", setup_wide{});
+  measure<work_stealing_graph>("wide / work stealing", setup_wide{});
+
+  measure<serial_graph>("deep / serial", setup_deep{});
+  measure<central_queue_graph>("deep / central queue", setup_deep{});
+  measure<work_stealing_graph>("deep / work stealing", setup_deep{});
+}
@@ -0,0 +1,122 @@
+#include <ossia/dataflow/graph/graph_parallel.hpp>
+#include <ossia/dataflow/graph_node.hpp>
+#include <ossia/dataflow/graph_edge_helpers.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#define NUM_EDITS 100
+#define NUM_NODES 3000
+#define CHAIN_COUNT 100
+using namespace ossia;
+
+static std::mt19937 mt;
+
+class node_empty_mock final : public graph_node {
+public:
+  node_empty_mock()
+  {
+    m_inlets.push_back(new ossia::value_inlet);
+    m_outlets.push_back(new ossia::value_outlet);
+  }
+
+  void run(const token_request& t, exec_state_facade e) noexcept override
+  {
+  }
+};
+
+using node_vec = std::vector<std::shared_ptr<node_empty_mock>>;
+
+template<typename T>
+auto connect(T& g, const std::shared_ptr<node_empty_mock>& a, const std::shared_ptr<node_empty_mock>& b)
+{
+  auto edge = ossia::make_edge(ossia::immediate_glutton_connection{},
+                               a->root_outputs()[0], b->root_inputs()[0],
+                               a, b);
+  g.connect(edge);
+  return edge;
+}
+
+// Parallel chains: nodes are created in an order compatible with the edges,
+// so any edge from a node to a later one keeps the graph acyclic.
+template<typename T>
+node_vec setup_chains(T& g)
+{
+  node_vec nodes;
+  for(int c = 0; c < CHAIN_COUNT; c++)
+  {
+    std::shared_ptr<node_empty_mock> prev;
+    for(int i = 0; i < NUM_NODES / CHAIN_COUNT; i++)
+    {
+      auto n = std::make_shared<node_empty_mock>();
+      nodes.push_back(n);
+      g.add_node(n);
+      if(prev)
+        connect(g, prev, n);
+      prev = n;
+    }
+  }
+  return nodes;
+}
+
+template<typename T>
+double tick(T& g, const node_vec& nodes, ossia::execution_state& e)
+{
+  for(auto& node : nodes)
+    node->request({});
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  g.state(e);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+}
+
+template<typename Graph>
+void measure(const char* name)
+{
+  mt.seed(1234);
+  auto graph = std::make_unique<Graph>();
+  auto nodes = setup_chains(*graph);
+  ossia::execution_state e;
+
+  // ensure that a tick happens to make it clean
+  tick(*graph, nodes, e);
+
+  double clean = 0.;
+  for(int i = 0; i < NUM_EDITS; i++)
+    clean += tick(*graph, nodes, e);
+
+  // Simulate live-patching: add a cable, tick, remove it, tick
+  double connect_spike = 0.;
+  double disconnect_spike = 0.;
+  for(int i = 0; i < NUM_EDITS; i++)
+  {
+    std::uniform_int_distribution<std::size_t> dist{0, nodes.size() - 1};
+    auto a = dist(mt);
+    auto b = dist(mt);
+    if(a == b)
+      continue;
+    if(a > b)
+      std::swap(a, b);
+
+    auto edge = connect(*graph, nodes[a], nodes[b]);
+    connect_spike += tick(*graph, nodes, e);
+
+    graph->disconnect(edge);
+    disconnect_spike += tick(*graph, nodes, e);
+  }
+
+  std::cerr << name
+            << ": clean " << clean / NUM_EDITS << " us"
+            << ", connect " << connect_spike / NUM_EDITS << " us"
+            << ", disconnect " << disconnect_spike / NUM_EDITS << " us" << std::endl;
+}
+
+int main()
+{
+  measure<graph_static<simple_update, static_exec>>("serial / full sort");
+  measure<graph_static<incremental_update, static_exec>>("serial / incremental");
+  measure<graph_static<custom_parallel_update<simple_update>, custom_parallel_exec>>("parallel / full sort");
+  measure<graph_static<custom_parallel_update<incremental_update>, custom_parallel_exec>>("parallel / incremental");
+}
@@ -0,0 +1,124 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/audio/drwav_handle.hpp>
+#include <ossia/audio/offline_engine.hpp>
+#include <ossia/dataflow/execution_state.hpp>
+#include <ossia/dataflow/typed_value.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::string read_file(const std::filesystem::path& p)
+{
+  std::ifstream f{p, std::ios::binary};
+  return {std::istreambuf_iterator<char>{f}, std::istreambuf_iterator<char>{}};
+}
+
+TEST_CASE ("test_offline_render", "test_offline_render")
+{
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto wav_file = dir / "ossia_offline_render.wav";
+  const auto log_file = dir / "ossia_offline_render.log";
+
+  ossia::net::generic_device device{"test"};
+  auto param = ossia::net::create_node(device, "/level")
+                   .create_parameter(ossia::val_type::INT);
+
+  ossia::execution_state state;
+  state.register_device(&device);
+
+  // Each output frame is its position, and the position of the tick is
+  // committed to the parameter.
+  ossia::offline_engine engine{48000, 64, 0, 2};
+  engine.set_tick([&](const ossia::audio_tick_state& t) {
+    const auto pos = *t.position_in_frames;
+    for (uint64_t i = 0; i < t.frames; i++)
+    {
+      t.outputs[0][i] = float(pos + i);
+      t.outputs[1][i] = -float(pos + i);
+    }
+
+    state.begin_tick();
+    state.insert(*param, ossia::typed_value{ossia::value{int(pos)}});
+    state.commit();
+  });
+
+  ossia::offline_render_settings settings;
+  settings.frames = 1000;
+  settings.output_file = wav_file.string();
+  settings.state = &state;
+  settings.commit_log_file = log_file.string();
+
+  auto report = engine.render(settings);
+  REQUIRE(report.frames == 1000);
+  REQUIRE(report.ticks == 16);
+  REQUIRE(report.rendered_seconds == Approx(1000. / 48000.));
+  REQUIRE(report.realtime_factor > 0.);
+  REQUIRE(!engine.running());
+  REQUIRE(!state.commit_observer);
+
+  // The last tick is shorter than the buffer size
+  REQUIRE(param->value() == ossia::value{960});
+
+  {
+    const auto data = read_file(wav_file);
+    ossia::drwav_handle wav{data.data(), data.size()};
+    REQUIRE(wav);
+    REQUIRE(wav.channels() == 2);
+    REQUIRE(wav.sampleRate() == 48000);
+    REQUIRE(wav.totalPCMFrameCount() == 1000);
+
+    std::vector<float> frames(2000);
+    REQUIRE(wav.read_pcm_frames_f32(1000, frames.data()) == 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+      REQUIRE(frames[2 * i] == float(i));
+      REQUIRE(frames[2 * i + 1] == -float(i));
+    }
+  }
+
+  {
+    std::ifstream log{log_file};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(log, line);)
+      lines.push_back(line);
+
+    REQUIRE(lines.size() == 16);
+    REQUIRE(lines[0].rfind("0.000000\t", 0) == 0);
+    REQUIRE(lines[1].rfind("0.001333\t", 0) == 0);
+    REQUIRE(lines[1].find("/level") != std::string::npos);
+  }
+
+  std::filesystem::remove(wav_file);
+  std::filesystem::remove(log_file);
+}
+
+TEST_CASE ("test_offline_render_stop", "test_offline_render_stop")
+{
+  ossia::offline_engine engine{44100, 128, 2, 2};
+
+  int ticks = 0;
+  engine.set_tick([&](const ossia::audio_tick_state& t) {
+    REQUIRE(t.n_in == 2);
+    REQUIRE(t.inputs[1][0] == 0.f);
+    if (++ticks == 10)
+      engine.stop_processing = true;
+  });
+
+  ossia::offline_render_settings settings;
+  settings.frames = 44100;
+  auto report = engine.render(settings);
+  REQUIRE(ticks == 10);
+  REQUIRE(report.frames == 1280);
+
+  engine.start();
+  report = engine.render(settings);
+  REQUIRE(report.frames == 44100);
+}
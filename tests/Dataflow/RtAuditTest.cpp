@@ -0,0 +1,74 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/detail/mutex.hpp>
+#include <ossia/detail/rt_audit.hpp>
+
+#include <memory>
+
+using namespace ossia::rt_audit;
+
+// Keeps the allocations from being optimized out
+static char* volatile g_sink{};
+
+static void allocate()
+{
+  auto str = std::make_unique<char[]>(256);
+  g_sink = str.get();
+}
+
+TEST_CASE ("test_rt_audit_region", "test_rt_audit_region")
+{
+  reset();
+
+  allocate();
+  REQUIRE(count(violation::allocation) == 0);
+
+  // Catch may allocate: the checks are made out of the regions
+  bool in_outer = false;
+  bool after_nested = false;
+  {
+    region r;
+    in_outer = in_region();
+    {
+      region nested;
+    }
+    after_nested = in_region();
+    allocate();
+  }
+  REQUIRE(in_outer);
+  REQUIRE(after_nested);
+  REQUIRE(!in_region());
+
+  REQUIRE(count(violation::allocation) == 1);
+  REQUIRE(count(violation::deallocation) == 1);
+  REQUIRE(count(violation::lock) == 0);
+
+  // Do not fail the process at exit
+  reset();
+}
+
+TEST_CASE ("test_rt_audit_locks", "test_rt_audit_locks")
+{
+  reset();
+
+  ossia::mutex_t mutex;
+  {
+    ossia::lock_t lock{mutex};
+  }
+  REQUIRE(count(violation::lock) == 0);
+
+  {
+    region r;
+    {
+      ossia::lock_t lock{mutex};
+    }
+    // Not blocking, so not reported
+    if (mutex.try_lock())
+      mutex.unlock();
+  }
+  REQUIRE(count(violation::lock) == 1);
+
+  reset();
+}
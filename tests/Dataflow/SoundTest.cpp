@@ -4,6 +4,9 @@
 #include <ossia/dataflow/execution_state.hpp>
 #include <ossia/dataflow/nodes/sound_ref.hpp>
 #include <ossia/dataflow/nodes/sound_mmap.hpp>
+#include <ossia/dataflow/nodes/sound_stream.hpp>
+
+#include <thread>
 
 TEST_CASE ("test_sound_ref", "test_sound_ref")
 {
@@ -112,4 +115,80 @@ TEST_CASE ("test_sound_mmap", "test_sound_mmap")
   }
   REQUIRE(op == expected);
 }
+
+TEST_CASE ("test_sound_stream", "test_sound_stream")
+{
+  using namespace ossia;
+  nodes::sound_stream snd{std::make_shared<sound_stream_pool>(1)};
+
+  test_wave w;
+  snd.set_sound(drwav_handle{&w, sizeof(test_wave)});
+
+  execution_state e;
+  e.bufferSize = 9;
+
+  // The audio thread does not wait for the workers
+  const auto prefetch = [&] {
+    while(snd.buffered() < 4)
+      std::this_thread::yield();
+  };
+
+  prefetch();
+  snd.run(simple_token_request{.prev_date = 0_tv, .date = 4_tv, .offset = 0_tv}, {&e});
+  snd.transport(0_tv);
+  prefetch();
+  snd.run(simple_token_request{.prev_date = 0_tv, .date = 4_tv, .offset = 4_tv}, {&e});
+  snd.transport(0_tv);
+  prefetch();
+  snd.run(simple_token_request{.prev_date = 0_tv, .date = 1_tv, .offset = 8_tv}, {&e});
+
+  auto op = snd.root_outputs()[0]->target<audio_port>()->samples;
+  audio_vector expected{audio_channel{0.1f, 0.2f, 0.3f, 0.4f, 0.1f, 0.2f, 0.3f, 0.4f, 0.1f}};
+  REQUIRE(op == expected);
+  REQUIRE(snd.underruns() == 0);
+}
+
+TEST_CASE ("test_sound_stream_underrun", "test_sound_stream_underrun")
+{
+  using namespace ossia;
+  // No worker: nothing is ever decoded
+  nodes::sound_stream snd{std::make_shared<sound_stream_pool>(0)};
+
+  test_wave w;
+  snd.set_sound(drwav_handle{&w, sizeof(test_wave)});
+
+  execution_state e;
+  e.bufferSize = 4;
+  snd.run(simple_token_request{.prev_date = 0_tv, .date = 4_tv, .offset = 0_tv}, {&e});
+
+  auto op = snd.root_outputs()[0]->target<audio_port>()->samples;
+  REQUIRE(op == audio_vector{audio_channel{0.f, 0.f, 0.f, 0.f}});
+  REQUIRE(snd.underruns() == 1);
+  REQUIRE(snd.missing_frames() == 4);
+}
+
+TEST_CASE ("test_sound_stream_loop", "test_sound_stream_loop")
+{
+  using namespace ossia;
+  test_wave w;
+  drwav_handle h{&w, sizeof(test_wave)};
+  sound_stream_voice v{h, snd::drwav_converter(h), 16};
+
+  const sound_stream_loop loop{1, 2, true};
+  float data[6]{};
+  float* out[1]{data};
+
+  // Refilled by hand here instead of by a pool
+  while(v.refill())
+    ;
+  // The loop does not match the prefetched frames: they are decoded again
+  REQUIRE(!v.read(0, 6, loop, out));
+  REQUIRE(v.underruns() == 1);
+
+  while(v.refill())
+    ;
+  REQUIRE(v.read(6, 6, loop, out));
+  for(int i = 0; i < 6; i++)
+    REQUIRE(data[i] == (i % 2 == 0 ? 0.2f : 0.3f));
+}
 #endif
@@ -0,0 +1,148 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <ossia/dataflow/graph/graph.hpp>
+#include <ossia/dataflow/graph/tick_methods.hpp>
+#include <ossia/dataflow/nodes/automation.hpp>
+#include <ossia/editor/scenario/scenario.hpp>
+#include <ossia/editor/scenario/time_event.hpp>
+#include <ossia/editor/scenario/time_interval.hpp>
+#include <ossia/editor/scenario/time_sync.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <benchmark/benchmark.h>
+
+static constexpr int sample_rate = 48000;
+static constexpr int buffer_size = 512;
+static constexpr int buffer_count = 16;
+
+static std::shared_ptr<ossia::time_event> add_event(ossia::time_sync& sync)
+{
+  auto ev = std::make_shared<ossia::time_event>(
+      ossia::time_event::exec_callback{}, sync,
+      ossia::expressions::make_expression_true());
+  sync.insert(sync.get_time_events().end(), ev);
+  return ev;
+}
+
+static ossia::time_sync& add_sync(ossia::scenario& s)
+{
+  auto sync = std::make_shared<ossia::time_sync>();
+  sync->set_expression(ossia::expressions::make_expression_true());
+  s.add_time_sync(sync);
+  return *sync;
+}
+
+// A score where a lot happens in each buffer:
+// a sequence of short intervals, each with an automation.
+struct dense_score
+{
+  ossia::net::generic_device device{"bench"};
+  ossia::graph g;
+  ossia::execution_state state;
+
+  ossia::scenario root;
+  std::shared_ptr<ossia::time_interval> main;
+  std::shared_ptr<ossia::scenario> inner = std::make_shared<ossia::scenario>();
+
+  explicit dense_score(int spacing)
+  {
+    state.sampleRate = sample_rate;
+    state.bufferSize = buffer_size;
+    state.modelToSamplesRatio = sample_rate / ossia::flicks_per_second<double>;
+    state.samplesToModelRatio = ossia::flicks_per_second<double> / sample_rate;
+    state.register_device(&device);
+
+    const auto samples = [&](int64_t n) {
+      return ossia::time_value{int64_t(n * state.samplesToModelRatio)};
+    };
+
+    const auto length = samples(buffer_size * buffer_count);
+    auto root_start = add_event(*root.get_start_time_sync());
+    auto root_end = add_event(add_sync(root));
+    main = ossia::time_interval::create(
+        {}, *root_start, *root_end, length, length, length);
+    root.add_time_interval(main);
+    main->add_time_process(inner);
+    g.add_node(main->node);
+    g.add_node(inner->node);
+
+    const auto duration = samples(spacing);
+    auto prev = add_event(*inner->get_start_time_sync());
+    for (int i = 0; i < buffer_size * buffer_count / spacing; i++)
+    {
+      auto next = add_event(add_sync(*inner));
+      auto itv = ossia::time_interval::create(
+          {}, *prev, *next, duration, duration, duration);
+      inner->add_time_interval(itv);
+      g.add_node(itv->node);
+
+      auto& node = ossia::net::create_node(device, "/p." + std::to_string(i));
+      auto autom = std::make_shared<ossia::nodes::automation>();
+      autom->root_outputs()[0]->address
+          = node.create_parameter(ossia::val_type::FLOAT);
+
+      auto curve = std::make_shared<ossia::curve<double, float>>();
+      curve->set_x0(0.);
+      curve->set_y0(0.);
+      curve->add_point(ossia::easing::ease{}, 1., 1.);
+      autom->set_behavior(curve);
+
+      itv->add_time_process(
+          std::make_shared<ossia::nodes::automation_process>(autom));
+      g.add_node(autom);
+
+      prev = next;
+    }
+  }
+};
+
+static constexpr auto commit_policy = &ossia::execution_state::commit;
+
+template <typename MakeTick>
+static void run_dense_score(benchmark::State& st, MakeTick make_tick)
+{
+  std::unique_ptr<dense_score> score;
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    score = std::make_unique<dense_score>(int(st.range(0)));
+    auto tick = make_tick(*score);
+    st.ResumeTiming();
+
+    for (int i = 0; i < buffer_count; i++)
+      tick(buffer_size, i * buffer_size / double(sample_rate));
+  }
+  st.SetItemsProcessed(st.iterations() * buffer_count * buffer_size);
+}
+
+static void BM_buffer_tick(benchmark::State& st)
+{
+  run_dense_score(st, [](dense_score& s) {
+    s.root.start();
+    return ossia::buffer_tick<commit_policy>{s.state, s.g, s.root, {}};
+  });
+}
+
+static void BM_split_score_tick(benchmark::State& st)
+{
+  run_dense_score(st, [](dense_score& s) {
+    s.root.start();
+    return ossia::split_score_tick<commit_policy>{s.state, s.g, s.root, {}};
+  });
+}
+
+static void BM_precise_score_tick(benchmark::State& st)
+{
+  run_dense_score(st, [](dense_score& s) {
+    s.main->start();
+    return ossia::precise_score_tick<commit_policy>{s.state, s.g, *s.main, {}};
+  });
+}
+
+// Samples between two events
+BENCHMARK(BM_buffer_tick)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_split_score_tick)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_precise_score_tick)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -24,3 +24,62 @@ TEST_CASE ("test_cuts", "test_cuts")
 
 
 }
+
+TEST_CASE ("test_split_token", "test_split_token")
+{
+  using namespace ossia;
+  using tick = split_score_tick<&ossia::execution_state::commit>;
+
+  // 48 kHz : 14700 flicks per sample
+  const double ratio = 48000. / ossia::flicks_per_second<double>;
+  const int64_t sample = 14700;
+
+  token_request tk{};
+  tk.prev_date = time_value{1000 * sample};
+  tk.date = time_value{1512 * sample};
+  tk.speed = 1.;
+  tk.musical_start_position = 0.;
+  tk.musical_end_position = 1.;
+  tk.start_discontinuous = true;
+  tk.end_discontinuous = true;
+
+  // The parts cover the whole token without gaps, each at the start of its sub-block
+  const int64_t cuts[] = {0, 100, 101, 384, 512};
+  time_value prev = tk.prev_date;
+  for (int i = 0; i < 4; i++)
+  {
+    auto part = tick::split_token(tk, cuts[i], cuts[i + 1], cuts[i], ratio);
+    REQUIRE(part.physical_start(ratio) == 0);
+    REQUIRE(part.physical_write_duration(ratio) == cuts[i + 1] - cuts[i]);
+    REQUIRE(part.prev_date == prev);
+    REQUIRE(part.start_discontinuous == (i == 0));
+    REQUIRE(part.end_discontinuous == (i == 3));
+    prev = part.date;
+  }
+  REQUIRE(prev == tk.date);
+
+  auto half = tick::split_token(tk, 0, 256, 0, ratio);
+  REQUIRE(half.musical_end_position == Approx(0.5));
+
+  // A token which starts in the middle of the buffer
+  tk.offset = time_value{200 * sample};
+  tk.date = tk.prev_date + time_value{100 * sample};
+  auto part = tick::split_token(tk, 200, 250, 100, ratio);
+  REQUIRE(part.physical_start(ratio) == 100);
+  REQUIRE(part.physical_write_duration(ratio) == 50);
+
+  // At another speed, the parts and the instantaneous tokens
+  // are at the same sample
+  tk.speed = 2.;
+  tk.offset = time_value{400 * sample};
+  tk.date = tk.prev_date + time_value{200 * sample};
+  part = tick::split_token(tk, 200, 250, 100, ratio);
+  REQUIRE(part.physical_start(ratio) == 100);
+  REQUIRE(part.physical_write_duration(ratio) == 50);
+
+  token_request instant = tk;
+  instant.date = instant.prev_date;
+  REQUIRE(instant.physical_start(ratio) == 200);
+  instant.offset = tick::block_offset(tk, 200, 100, ratio);
+  REQUIRE(instant.physical_start(ratio) == 100);
+}
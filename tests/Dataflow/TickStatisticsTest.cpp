@@ -0,0 +1,97 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <catch.hpp>
+#include <ossia/audio/offline_engine.hpp>
+#include <ossia/audio/tick_statistics.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+
+#include <numeric>
+#include <thread>
+
+// 48 frames at 48 kHz: each callback has one millisecond
+static constexpr int rate = 48000;
+static constexpr int buffer_size = 48;
+
+TEST_CASE ("test_tick_statistics", "test_tick_statistics")
+{
+  ossia::offline_engine engine{rate, buffer_size, 0, 2};
+  engine.statistics.set_window(std::chrono::milliseconds(10));
+
+  // One callback in ten misses its deadline
+  int ticks = 0;
+  engine.set_tick([&](const ossia::audio_tick_state&) {
+    {
+      ossia::tick_phase_scope phase{ossia::tick_phase::dataflow};
+      if (ticks % 10 == 9)
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    {
+      ossia::tick_phase_scope phase{ossia::tick_phase::commit};
+    }
+    ticks++;
+  });
+
+  ossia::offline_render_settings settings;
+  settings.frames = 100 * buffer_size;
+  engine.render(settings);
+
+  const auto s = engine.statistics.read();
+  REQUIRE(s.callbacks == 100);
+  REQUIRE(s.deadline_misses >= 10);
+  REQUIRE(s.deadline_misses < 100);
+  REQUIRE(std::accumulate(s.histogram.begin(), s.histogram.end(), uint64_t(0)) == 100);
+  REQUIRE(s.histogram.back() >= 10);
+
+  // The last window ends with a long callback
+  REQUIRE(s.window_max_ns >= 3'000'000);
+  REQUIRE(s.window_max_load >= 3.);
+
+  REQUIRE(s.phase_ns[int(ossia::tick_phase::temporal)] == 0);
+  REQUIRE(s.phase_ns[int(ossia::tick_phase::dataflow)] >= 30'000'000);
+  REQUIRE(s.phase_ns[int(ossia::tick_phase::dataflow)] <= s.busy_ns);
+
+  // Out of a callback, nothing is measured
+  REQUIRE(!ossia::tick_statistics::current());
+  {
+    ossia::tick_phase_scope phase{ossia::tick_phase::temporal};
+  }
+  REQUIRE(engine.statistics.read().phase_ns[0] == 0);
+}
+
+TEST_CASE ("test_tick_statistics_parameters", "test_tick_statistics_parameters")
+{
+  ossia::net::generic_device device{"test"};
+  auto& root = ossia::net::create_node(device, "/engine");
+  ossia::tick_statistics_parameters params{root};
+
+  ossia::tick_statistics::snapshot s;
+  s.callbacks = 10;
+  s.deadline_misses = 2;
+  s.histogram[3] = 8;
+  s.histogram.back() = 2;
+  s.busy_ns = 1000;
+  s.phase_ns = {100, 500, 200};
+  s.window_max_ns = 2'500'000;
+  params.update(s);
+
+  auto value = [&](std::string_view path) {
+    return ossia::net::find_node(root, path)->get_parameter()->value();
+  };
+  REQUIRE(value("callbacks") == ossia::value{10});
+  REQUIRE(value("deadline_misses") == ossia::value{2});
+  REQUIRE(value("max_duration") == ossia::value{2.5f});
+  REQUIRE(value("phase/dataflow") == ossia::value{0.5f});
+
+  auto histogram = value("histogram").get<std::vector<ossia::value>>();
+  REQUIRE(histogram.size() == ossia::tick_statistics::histogram_bins);
+  REQUIRE(histogram[3] == ossia::value{8});
+
+  // The shares of the phases are taken since the last update
+  s.busy_ns += 1000;
+  s.phase_ns[0] += 1000;
+  params.update(s);
+  REQUIRE(value("phase/temporal") == ossia::value{1.f});
+  REQUIRE(value("phase/dataflow") == ossia::value{0.f});
+}
@@ -0,0 +1,179 @@
+#include <catch.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/base/osc_address.hpp>
+#include <ossia/network/coalescing_protocol.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/network/generic/generic_parameter.hpp>
+
+#include <atomic>
+#include <mutex>
+
+using namespace std::literals;
+
+// Records what the coalescing protocol sends
+struct recording_protocol final : ossia::net::protocol_base
+{
+  std::mutex mutex;
+  std::vector<std::pair<std::string, ossia::value>> sent;
+  int bundles{};
+
+  bool pull(ossia::net::parameter_base&) override { return false; }
+  bool push(const ossia::net::parameter_base& p, const ossia::value& v) override
+  {
+    std::lock_guard lock{mutex};
+    sent.emplace_back(ossia::net::osc_parameter_string(p.get_node()), v);
+    return true;
+  }
+  bool push_bundle(const std::vector<const ossia::net::parameter_base*>& v) override
+  {
+    {
+      std::lock_guard lock{mutex};
+      bundles++;
+    }
+    for (auto p : v)
+      push(*p, p->value());
+    return true;
+  }
+  bool push_raw(const ossia::net::full_parameter_data&) override { return false; }
+  bool observe(ossia::net::parameter_base&, bool) override { return false; }
+  bool update(ossia::net::node_base&) override { return false; }
+
+  std::vector<std::pair<std::string, ossia::value>> read()
+  {
+    std::lock_guard lock{mutex};
+    return sent;
+  }
+};
+
+struct coalescing_setup
+{
+  ossia::net::network_context_ptr ctx = std::make_shared<ossia::net::network_context>();
+  std::shared_ptr<ossia::net::timer_wheel> wheel = ossia::net::timer_wheel::create(ctx);
+  recording_protocol* recorder = new recording_protocol;
+  ossia::net::coalescing_protocol* proto{};
+  std::unique_ptr<ossia::net::generic_device> device;
+
+  explicit coalescing_setup(ossia::net::coalescing_configuration conf)
+  {
+    auto p = std::make_unique<ossia::net::coalescing_protocol>(
+        wheel, std::move(conf), std::unique_ptr<ossia::net::protocol_base>(recorder));
+    proto = p.get();
+    device = std::make_unique<ossia::net::generic_device>(std::move(p), "test");
+  }
+
+  ossia::net::parameter_base& create(std::string_view addr)
+  {
+    return *ossia::net::create_node(*device, addr).create_parameter(ossia::val_type::INT);
+  }
+};
+
+TEST_CASE ("test_timer_wheel", "test_timer_wheel")
+{
+  struct counter final : ossia::net::timer_wheel::entry
+  {
+    std::atomic_int count{};
+    void on_timer() noexcept override { count++; }
+  };
+
+  // Periods longer than a revolution of the wheel
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  auto wheel = ossia::net::timer_wheel::create(ctx, 1ms, 8);
+
+  counter fast, slow, cancelled;
+  wheel->schedule(fast, 2ms);
+  wheel->schedule(slow, 20ms);
+  wheel->schedule(cancelled, 2ms);
+  wheel->cancel(cancelled);
+
+  ctx->context.run_for(105ms);
+  REQUIRE(fast.count >= 25);
+  REQUIRE(fast.count <= 53);
+  REQUIRE(slow.count >= 3);
+  REQUIRE(slow.count <= 5);
+  REQUIRE(cancelled.count == 0);
+}
+
+TEST_CASE ("test_coalescing_last_value", "test_coalescing_last_value")
+{
+  ossia::net::coalescing_configuration conf;
+  conf.period = 20ms;
+  coalescing_setup s{conf};
+  auto& a = s.create("/a");
+
+  // Nothing is sent by the thread pushing
+  for (int i = 0; i < 100; i++)
+    a.push_value(i);
+  REQUIRE(s.recorder->read().empty());
+
+  s.ctx->context.run_for(50ms);
+  auto sent = s.recorder->read();
+  REQUIRE(sent.size() == 1);
+  REQUIRE(sent[0].first == "/a");
+  REQUIRE(sent[0].second == ossia::value{99});
+
+  // Nothing new, nothing sent
+  s.ctx->context.run_for(50ms);
+  REQUIRE(s.recorder->read().size() == 1);
+}
+
+TEST_CASE ("test_coalescing_overrides", "test_coalescing_overrides")
+{
+  ossia::net::coalescing_configuration conf;
+  conf.period = 5ms;
+  conf.overrides = {{"/slow", 200ms}};
+  coalescing_setup s{conf};
+  auto& fast = s.create("/fast");
+  auto& slow = s.create("/slow");
+  auto& other = s.create("/other");
+  s.proto->set_period(other, 200ms);
+
+  fast.push_value(1);
+  slow.push_value(2);
+  other.push_value(3);
+  s.ctx->context.run_for(50ms);
+  auto sent = s.recorder->read();
+  REQUIRE(sent.size() == 1);
+  REQUIRE(sent[0].first == "/fast");
+
+  s.ctx->context.run_for(250ms);
+  REQUIRE(s.recorder->read().size() == 3);
+}
+
+TEST_CASE ("test_coalescing_bundle", "test_coalescing_bundle")
+{
+  ossia::net::coalescing_configuration conf;
+  conf.period = 10ms;
+  conf.bundle = true;
+  coalescing_setup s{conf};
+  auto& a = s.create("/a");
+  auto& b = s.create("/b");
+
+  a.push_value(1);
+  b.push_value(2);
+  a.push_value(3);
+  s.ctx->context.run_for(30ms);
+
+  REQUIRE(s.recorder->bundles == 1);
+  auto sent = s.recorder->read();
+  REQUIRE(sent.size() == 2);
+  REQUIRE(sent[0].second == ossia::value{3});
+  REQUIRE(sent[1].second == ossia::value{2});
+}
+
+TEST_CASE ("test_coalescing_removed", "test_coalescing_removed")
+{
+  ossia::net::coalescing_configuration conf;
+  conf.period = 10ms;
+  coalescing_setup s{conf};
+  auto& a = s.create("/a");
+  auto& b = s.create("/b");
+
+  a.push_value(1);
+  b.push_value(2);
+  ossia::net::find_node(*s.device, "/a")->remove_parameter();
+  s.ctx->context.run_for(30ms);
+
+  auto sent = s.recorder->read();
+  REQUIRE(sent.size() == 1);
+  REQUIRE(sent[0].first == "/b");
+}
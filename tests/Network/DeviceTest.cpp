@@ -14,6 +14,7 @@
 #if defined(OSSIA_PROTOCOL_MINUIT)
 #include <ossia/network/minuit/minuit.hpp>
 #endif
+#include <ossia/network/base/address_index.hpp>
 #include <ossia/network/common/parameter_properties.hpp>
 #include <ossia/network/base/parameter_data.hpp>
 #include "TestUtils.hpp"
@@ -41,3 +42,30 @@ TEST_CASE ("test_basic", "test_basic")
 #endif
     }
   }
+
+TEST_CASE ("test_address_index", "test_address_index")
+{
+  ossia::net::generic_device dev{"test"};
+  auto& foo = ossia::net::create_node(dev, "/foo/bar");
+  auto p1 = foo.create_parameter(ossia::val_type::FLOAT);
+
+  dev.set_address_index(true);
+  auto index = dev.get_address_index();
+  REQUIRE(index);
+  REQUIRE(index->find("/foo/bar") == p1);
+  REQUIRE(index->find("/foo") == nullptr);
+
+  auto p2 = ossia::net::create_node(dev, "/foo/baz").create_parameter();
+  REQUIRE(index->find("/foo/baz") == p2);
+
+  foo.get_parent()->set_name("blop");
+  REQUIRE(index->find("/foo/bar") == nullptr);
+  REQUIRE(index->find("/blop/bar") == p1);
+  REQUIRE(index->find("/blop/baz") == p2);
+
+  foo.remove_parameter();
+  REQUIRE(index->find("/blop/bar") == nullptr);
+
+  dev.get_root_node().remove_child("blop");
+  REQUIRE(index->find("/blop/baz") == nullptr);
+}
@@ -122,6 +122,40 @@ TEST_CASE ("test_edition", "test_edition")
   }
 }
 
+TEST_CASE ("test_child_index", "test_child_index")
+{
+  ossia::net::generic_device device{"test"};
+  auto& root = device.get_root_node();
+
+  const int N = 4 * node_base::child_index_threshold;
+  for (int i = 0; i < N; i++)
+    root.create_child("child." + std::to_string(i));
+
+  // The first lookup builds the index
+  REQUIRE(root.find_child("child.10") != nullptr);
+  REQUIRE(root.find_child("child.10")->get_name() == "child.10");
+  REQUIRE(root.find_child("nope") == nullptr);
+
+  // Additions and removals keep it up-to-date
+  auto added = root.create_child("added");
+  REQUIRE(root.find_child("added") == added);
+
+  REQUIRE(root.remove_child("child.10"));
+  REQUIRE(root.find_child("child.10") == nullptr);
+
+  // Renaming too
+  auto renamed = root.find_child("child.11");
+  renamed->set_name("renamed");
+  REQUIRE(root.find_child("child.11") == nullptr);
+  REQUIRE(root.find_child("renamed") == renamed);
+
+  REQUIRE(ossia::net::find_node(root, "/renamed") == renamed);
+  REQUIRE(ossia::net::find_node(root, "/child.42") != nullptr);
+
+  root.clear_children();
+  REQUIRE(root.find_child("renamed") == nullptr);
+}
+
 TEST_CASE ("test_path", "test_path")
 {
   using namespace ossia::regex_path;
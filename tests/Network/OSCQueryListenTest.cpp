@@ -0,0 +1,84 @@
+#include <catch.hpp>
+#include <ossia/network/base/node_functions.hpp>
+#include <ossia/network/context.hpp>
+#include <ossia/network/generic/generic_device.hpp>
+#include <ossia/protocols/oscquery/oscquery_mirror_asio.hpp>
+#include <ossia/protocols/oscquery/oscquery_server_asio.hpp>
+
+using namespace std::literals;
+
+static ossia::value mirror_value(ossia::net::generic_device& dev, std::string_view path)
+{
+  return ossia::net::find_node(dev, path)->get_parameter()->value();
+}
+
+TEST_CASE ("test_oscquery_listen_per_client", "test_oscquery_listen_per_client")
+{
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::generic_device server{
+      std::make_unique<ossia::oscquery_asio::oscquery_server_protocol>(ctx, 1241, 5691),
+      "server"};
+  auto& a = *ossia::net::create_node(server, "/a").create_parameter(ossia::val_type::INT);
+  auto& b = *ossia::net::create_node(server, "/b").create_parameter(ossia::val_type::INT);
+
+  // A client which listens to /a, and one which never sends LISTEN
+  auto listening_device = std::make_unique<ossia::net::generic_device>(
+      std::make_unique<ossia::oscquery_asio::oscquery_mirror_asio_protocol>(
+          ctx, "ws://127.0.0.1:5691"),
+      "listening");
+  auto& listening = *listening_device;
+  ossia::net::generic_device all{
+      std::make_unique<ossia::oscquery_asio::oscquery_mirror_asio_protocol>(
+          ctx, "ws://127.0.0.1:5691"),
+      "all"};
+  REQUIRE(listening.get_protocol().update(listening.get_root_node()));
+  REQUIRE(all.get_protocol().update(all.get_root_node()));
+
+  auto& listened = *ossia::net::find_node(listening, "/a")->get_parameter();
+  auto cb = listened.add_callback([](const ossia::value&) {});
+  ctx->context.run_for(200ms);
+
+  a.push_value(1);
+  b.push_value(2);
+  ctx->context.run_for(200ms);
+
+  REQUIRE(mirror_value(listening, "/a") == ossia::value{1});
+  REQUIRE(mirror_value(listening, "/b") == ossia::value{0});
+  REQUIRE(mirror_value(all, "/a") == ossia::value{1});
+  REQUIRE(mirror_value(all, "/b") == ossia::value{2});
+
+  // After IGNORE, the client does not get the values of /a anymore
+  listened.remove_callback(cb);
+  ctx->context.run_for(200ms);
+
+  a.push_value(3);
+  ctx->context.run_for(200ms);
+
+  REQUIRE(mirror_value(listening, "/a") == ossia::value{1});
+  REQUIRE(mirror_value(all, "/a") == ossia::value{3});
+
+  // Removing a listened parameter drops its subscriptions: the values of a
+  // parameter recreated at the same address do not reach the client
+  listened.add_callback([](const ossia::value&) {});
+  ctx->context.run_for(200ms);
+  auto& a_node = *ossia::net::find_node(server, "/a");
+  a_node.remove_parameter();
+  auto& recreated = *a_node.create_parameter(ossia::val_type::INT);
+  ctx->context.run_for(200ms);
+
+  recreated.push_value(5);
+  b.push_value(4);
+  ctx->context.run_for(200ms);
+  REQUIRE(mirror_value(listening, "/a") == ossia::value{1});
+  REQUIRE(mirror_value(listening, "/b") == ossia::value{0});
+  REQUIRE(mirror_value(all, "/a") == ossia::value{5});
+  REQUIRE(mirror_value(all, "/b") == ossia::value{4});
+
+  // The client disconnecting afterwards leaves the other clients served
+  listening_device.reset();
+  ctx->context.run_for(200ms);
+
+  recreated.push_value(6);
+  ctx->context.run_for(200ms);
+  REQUIRE(mirror_value(all, "/a") == ossia::value{6});
+}
@@ -0,0 +1,248 @@
+#include <catch.hpp>
+#include <ossia/network/context.hpp>
+#include <ossia/network/sockets/outbound_queue.hpp>
+#include <ossia/network/sockets/udp_socket.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+using ossia::net::outbound_queue;
+using ossia::net::outbound_queue_configuration;
+using ossia::net::overflow_policy;
+
+// An OSC message whose address is addr, padded, followed by its payload
+static std::string message(std::string addr, std::string payload)
+{
+  addr.resize((addr.size() / 4 + 1) * 4, '\0');
+  return addr + payload;
+}
+
+static std::vector<std::string> drain(const std::shared_ptr<outbound_queue>& q)
+{
+  boost::asio::io_context ctx;
+  std::vector<std::string> sent;
+  q->start(ctx, [&](const char* data, std::size_t sz) { sent.emplace_back(data, sz); });
+  ctx.run_for(20ms);
+  q->stop();
+  return sent;
+}
+
+static std::shared_ptr<outbound_queue> make_queue(overflow_policy p)
+{
+  outbound_queue_configuration conf;
+  conf.depth = 4;
+  conf.max_packet_size = 64;
+  conf.overflow = p;
+  return std::make_shared<outbound_queue>(conf);
+}
+
+TEST_CASE ("test_outbound_queue_drop_newest", "test_outbound_queue_drop_newest")
+{
+  auto q = make_queue(overflow_policy::drop_newest);
+  for (auto p : {"/a", "/b", "/c", "/d", "/e", "/f"})
+    REQUIRE(q->enqueue(p, 2));
+
+  auto c = q->read();
+  REQUIRE(c.dropped == 2);
+  REQUIRE(c.depth == 4);
+  REQUIRE(c.max_depth == 4);
+
+  REQUIRE(drain(q) == std::vector<std::string>{"/a", "/b", "/c", "/d"});
+  c = q->read();
+  REQUIRE(c.sent == 4);
+  REQUIRE(c.depth == 0);
+}
+
+TEST_CASE ("test_outbound_queue_drop_oldest", "test_outbound_queue_drop_oldest")
+{
+  auto q = make_queue(overflow_policy::drop_oldest);
+  for (auto p : {"/a", "/b", "/c", "/d", "/e", "/f"})
+    REQUIRE(q->enqueue(p, 2));
+
+  REQUIRE(q->read().dropped == 2);
+  REQUIRE(drain(q) == std::vector<std::string>{"/c", "/d", "/e", "/f"});
+}
+
+TEST_CASE ("test_outbound_queue_coalesce", "test_outbound_queue_coalesce")
+{
+  auto q = make_queue(overflow_policy::coalesce);
+  std::vector<std::string> packets{
+      message("/a", "1"), message("/b", "1"), message("/c", "1"),
+      message("/d", "1"), message("/b", "2"), message("/e", "1")};
+  // Bundles are never coalesced
+  packets.push_back("#bundle");
+
+  for (auto& p : packets)
+    REQUIRE(q->enqueue(p.data(), p.size()));
+
+  auto c = q->read();
+  REQUIRE(c.coalesced == 1);
+  REQUIRE(c.dropped == 2);
+
+  // The new value of /b keeps its place in the queue
+  REQUIRE(drain(q) == std::vector<std::string>{packets[0], packets[4], packets[2], packets[3]});
+}
+
+TEST_CASE ("test_outbound_queue_oversized", "test_outbound_queue_oversized")
+{
+  auto q = make_queue(overflow_policy::drop_oldest);
+  const std::string big(65, 'x');
+  REQUIRE(!q->enqueue(big.data(), big.size()));
+  REQUIRE(q->read().oversized == 1);
+  REQUIRE(q->depth() == 0);
+}
+
+TEST_CASE ("test_outbound_queue_stop", "test_outbound_queue_stop")
+{
+  auto q = make_queue(overflow_policy::drop_oldest);
+  q->stop();
+  REQUIRE(q->enqueue("/a", 2));
+  REQUIRE(drain(q).empty());
+  REQUIRE(q->depth() == 1);
+}
+
+TEST_CASE ("test_outbound_queue_idle", "test_outbound_queue_idle")
+{
+  auto q = make_queue(overflow_policy::drop_oldest);
+  boost::asio::io_context ctx;
+  std::vector<std::string> sent;
+  q->start(ctx, [&](const char* data, std::size_t sz) { sent.emplace_back(data, sz); });
+
+  // An idle queue does not wake the io_context up every drain_period
+  REQUIRE(ctx.run_for(50ms) <= 2);
+
+  REQUIRE(q->enqueue("/a", 2));
+  REQUIRE(q->enqueue("/b", 2));
+  ctx.restart();
+  REQUIRE(ctx.run_for(50ms) <= 2);
+  REQUIRE(sent == std::vector<std::string>{"/a", "/b"});
+  q->stop();
+}
+
+TEST_CASE ("test_outbound_queue_udp", "test_outbound_queue_udp")
+{
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::udp_receive_socket recv{{"127.0.0.1", 9876}, ctx->context};
+  ossia::net::udp_send_socket send{{"127.0.0.1", 9876}, ctx->context};
+  recv.open();
+  send.connect();
+
+  std::vector<std::string> received;
+  recv.receive([&](const char* data, std::size_t sz) { received.emplace_back(data, sz); });
+
+  auto q = std::make_shared<outbound_queue>(outbound_queue_configuration{});
+  q->start(ctx->context, [&](const char* data, std::size_t sz) { send.write(data, sz); });
+
+  // Nothing is sent by the thread queueing the packets
+  const auto p = message("/foo", "bar");
+  for (int i = 0; i < 10; i++)
+    REQUIRE(q->enqueue(p.data(), p.size()));
+  REQUIRE(q->depth() == 10);
+
+  ctx->context.run_for(50ms);
+  q->stop();
+
+  REQUIRE(received.size() == 10);
+  REQUIRE(received[0] == p);
+  REQUIRE(q->read().sent == 10);
+}
+
+TEST_CASE ("test_outbound_queue_udp_batch", "test_outbound_queue_udp_batch")
+{
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::udp_receive_socket recv{{"127.0.0.1", 9877}, ctx->context};
+  ossia::net::udp_send_socket send{{"127.0.0.1", 9877}, ctx->context};
+  recv.open();
+  send.connect();
+
+  std::vector<std::string> received;
+  recv.receive([&](const char* data, std::size_t sz) { received.emplace_back(data, sz); });
+
+  // More packets than in a batch, sent with sendmmsg on Linux
+  auto q = std::make_shared<outbound_queue>(outbound_queue_configuration{});
+  q->start(ctx->context, [&](const boost::asio::const_buffer* bufs, std::size_t n) {
+    return send.write_many(bufs, n);
+  });
+
+  std::vector<std::string> packets;
+  for (int i = 0; i < 100; i++)
+    packets.push_back(message("/foo", std::to_string(i)));
+  for (auto& p : packets)
+    REQUIRE(q->enqueue(p.data(), p.size()));
+
+  ctx->context.run_for(50ms);
+  q->stop();
+
+  REQUIRE(received == packets);
+  REQUIRE(q->read().sent == 100);
+}
+
+TEST_CASE ("test_outbound_queue_batch_failures", "test_outbound_queue_batch_failures")
+{
+  auto q = std::make_shared<outbound_queue>(outbound_queue_configuration{});
+  boost::asio::io_context ctx;
+  // The socket only manages to send half of each batch
+  q->start(ctx, [&](const boost::asio::const_buffer*, std::size_t n) { return n / 2; });
+
+  const auto p = message("/foo", "bar");
+  for (int i = 0; i < 10; i++)
+    REQUIRE(q->enqueue(p.data(), p.size()));
+
+  ctx.run_for(20ms);
+  q->stop();
+
+  const auto c = q->read();
+  REQUIRE(c.sent == 5);
+  REQUIRE(c.failed == 5);
+  REQUIRE(c.dropped == 0);
+}
+
+TEST_CASE ("test_udp_write_many_failure", "test_udp_write_many_failure")
+{
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::udp_receive_socket recv{{"127.0.0.1", 9878}, ctx->context};
+  ossia::net::udp_send_socket send{{"127.0.0.1", 9878}, ctx->context};
+  recv.open();
+  send.connect();
+
+  std::vector<std::string> received;
+  recv.receive([&](const char* data, std::size_t sz) { received.emplace_back(data, sz); });
+
+  // Too large for UDP: only this one is dropped, not the ones after it
+  const auto a = message("/a", "1");
+  const std::string too_large(70000, 'x');
+  const auto b = message("/b", "2");
+  const boost::asio::const_buffer bufs[]{
+      boost::asio::buffer(a), boost::asio::buffer(too_large), boost::asio::buffer(b)};
+  REQUIRE(send.write_many(bufs, 3) == 2);
+
+  ctx->context.run_for(50ms);
+  REQUIRE(received == std::vector<std::string>{a, b});
+}
+
+#if defined(__linux__)
+TEST_CASE ("test_udp_receive_max_datagram_size", "test_udp_receive_max_datagram_size")
+{
+  auto ctx = std::make_shared<ossia::net::network_context>();
+  ossia::net::receive_socket_configuration conf{{"127.0.0.1", 9879}};
+  conf.max_datagram_size = 64;
+  ossia::net::udp_receive_socket recv{conf, ctx->context};
+  ossia::net::udp_send_socket send{{"127.0.0.1", 9879}, ctx->context};
+  recv.open();
+  send.connect();
+
+  std::vector<std::string> received;
+  recv.receive([&](const char* data, std::size_t sz) { received.emplace_back(data, sz); });
+
+  // The larger datagram is discarded instead of being dispatched truncated
+  const auto small = message("/small", "1");
+  const auto large = message("/large", std::string(100, 'x'));
+  send.write(small.data(), small.size());
+  send.write(large.data(), large.size());
+  send.write(small.data(), small.size());
+
+  ctx->context.run_for(50ms);
+  REQUIRE(received == std::vector<std::string>{small, small});
+}
+#endif
@@ -9,6 +9,7 @@
 #include <set>
 
 #include <ossia/network/common/path.hpp>
+#include <ossia/network/common/pattern_matcher.hpp>
 #include <ossia/detail/algorithms.hpp>
 #include <ossia/network/base/osc_address.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -142,6 +143,37 @@ TEST_CASE ("test_root_only", "test_root_only")
   ossia::traversal::make_path("/"sv);
 }
 
+TEST_CASE ("test_pattern_matcher", "test_pattern_matcher")
+{
+  using ossia::traversal::pattern_matcher;
+
+  REQUIRE(pattern_matcher("bar.1")("bar.1"));
+  REQUIRE(!pattern_matcher("bar.1")("barx1"));
+
+  REQUIRE(pattern_matcher("b??")("bar"));
+  REQUIRE(pattern_matcher("b??")("b"));
+  REQUIRE(!pattern_matcher("b??")("barr"));
+
+  REQUIRE(pattern_matcher("foo*bar")("foo.1.bar"));
+  REQUIRE(!pattern_matcher("foo*bar")("foo/bar"));
+
+  REQUIRE(pattern_matcher("[a-c]*")("bar"));
+  REQUIRE(!pattern_matcher("[!a-c]*")("bar"));
+
+  REQUIRE(pattern_matcher("{foo,bar}.{1,2}")("bar.2"));
+  REQUIRE(!pattern_matcher("{foo,bar}.{1,2}")("bar.3"));
+  REQUIRE(pattern_matcher("a{b*,c?}d")("abxyd"));
+  REQUIRE(!pattern_matcher("a{b*,c?}d")("acxyd"));
+
+  REQUIRE(pattern_matcher("tutu!")("tutu"));
+  REQUIRE(pattern_matcher("tutu!")("tutu.12"));
+  REQUIRE(!pattern_matcher("tutu!")("tutu.1.2"));
+
+  REQUIRE_THROWS(pattern_matcher("[ab"));
+  REQUIRE_THROWS(pattern_matcher("{a,b"));
+  REQUIRE(!traversal::make_path("foo/{a,b"));
+}
+
 TEST_CASE ("test_traversal", "test_traversal")
 {
   // Note : to allow access to character classes, we have to change :